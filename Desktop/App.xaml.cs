@@ -28,6 +28,15 @@ namespace FrequencyGenerator
             containerRegistry.RegisterSingleton<IUSBCommunicationService, USBCommunicationService>();
             containerRegistry.RegisterSingleton<IProgramManagerService, ProgramManagerService>();
             containerRegistry.RegisterSingleton<IMonitoringService, MonitoringService>();
+            containerRegistry.RegisterSingleton<ICalibrationService, CalibrationService>();
+
+            // Calibration power meter on --power-meter=<port>; --simulate-power-meter
+            // runs the calibration against the simulator instead (no instrument)
+            string[] args = Environment.GetCommandLineArgs();
+            if (Array.IndexOf(args, "--simulate-power-meter") >= 0)
+                containerRegistry.RegisterSingleton<IPowerMeter, SimulatedPowerMeter>();
+            else
+                containerRegistry.RegisterInstance<IPowerMeter>(new ScpiPowerMeter(GetOption(args, "--power-meter=")));
 
             // Register ViewModels (Transient for fresh instances)
             containerRegistry.Register<MainViewModel>();
@@ -43,6 +52,19 @@ namespace FrequencyGenerator
             Log.Information("Type registration completed");
         }
 
+        /// <summary>
+        /// Value of a "--name=value" command line option, or null
+        /// </summary>
+        private static string GetOption(string[] args, string prefix)
+        {
+            foreach (string arg in args)
+            {
+                if (arg.StartsWith(prefix, StringComparison.OrdinalIgnoreCase))
+                    return arg.Substring(prefix.Length);
+            }
+            return null;
+        }
+
         protected override void ConfigureModuleCatalog(IModuleCatalog moduleCatalog)
         {
             // Add modules if needed
@@ -12,6 +12,9 @@ namespace FrequencyGenerator.Models
         public string CalibrationNotes { get; set; }
         public ObservableCollection<FrequencyPoint> FrequencyCalibration { get; set; }
         public ObservableCollection<PowerPoint> PowerCalibration { get; set; }
+        public ObservableCollection<PowerCorrectionPoint> PowerCorrection { get; set; }
+        public int PointsMeasured { get; set; }
+        public TimeSpan Duration { get; set; }
 
         public CalibrationData()
         {
@@ -19,13 +22,14 @@ namespace FrequencyGenerator.Models
             CalibrationNotes = string.Empty;
             FrequencyCalibration = new ObservableCollection<FrequencyPoint>();
             PowerCalibration = new ObservableCollection<PowerPoint>();
+            PowerCorrection = new ObservableCollection<PowerCorrectionPoint>();
         }
     }
 
     public class FrequencyPoint
     {
-        public double NominalFrequency { get; set; }
-        public double MeasuredFrequency { get; set; }
+        public Frequency NominalFrequency { get; set; }
+        public Frequency MeasuredFrequency { get; set; }
         public double CorrectionFactor { get; set; }
     }
 
@@ -35,4 +39,14 @@ namespace FrequencyGenerator.Models
         public double MeasuredPower { get; set; }
         public double CorrectionFactor { get; set; }
     }
+
+    /// <summary>
+    /// Output power correction at one frequency (device CAL:POINT)
+    /// </summary>
+    public class PowerCorrectionPoint
+    {
+        public Frequency Frequency { get; set; }
+        public double MeasuredPower { get; set; }
+        public double Correction { get; set; }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+using System;
+using System.ComponentModel;
+using System.Globalization;
+
+namespace FrequencyGenerator.Models
+{
+    /// <summary>
+    /// Frequency in millihertz, the device representation (Firmware/inc/frequency.h)
+    /// </summary>
+    /// <remarks>
+    /// The protocol text form is decimal Hz with up to three places, e.g.
+    /// "5800000000.125"; ToString and Parse use it, invariant culture.
+    /// Keeping the device's fixed point means a value round-trips through
+    /// the protocol, the list upload and back without double rounding.
+    /// </remarks>
+    [TypeConverter(typeof(FrequencyConverter))]
+    public readonly struct Frequency : IEquatable<Frequency>, IComparable<Frequency>
+    {
+        private const int UnitsPerHz = 1000;
+
+        // Device RF range (RF_FREQ_MIN/RF_FREQ_MAX in Firmware/inc/main.h)
+        public static readonly Frequency RangeMin = FromHz(23.4375e6);
+        public static readonly Frequency RangeMax = FromHz(6e9);
+
+        public long MilliHertz { get; }
+
+        public double Hz => MilliHertz / (double)UnitsPerHz;
+
+        private Frequency(long milliHertz)
+        {
+            MilliHertz = milliHertz;
+        }
+
+        public static Frequency FromMilliHertz(long milliHertz) => new Frequency(milliHertz);
+
+        /// <summary>
+        /// Nearest millihertz
+        /// </summary>
+        public static Frequency FromHz(double hz) => new Frequency((long)Math.Round(hz * UnitsPerHz));
+
+        /// <summary>
+        /// Parse decimal Hz; extra decimals are rounded to the nearest millihertz
+        /// </summary>
+        public static bool TryParse(string text, out Frequency frequency)
+        {
+            frequency = default;
+            if (!decimal.TryParse(text, NumberStyles.Float, CultureInfo.InvariantCulture, out decimal hz))
+                return false;
+
+            decimal milliHertz = Math.Round(hz * UnitsPerHz, MidpointRounding.AwayFromZero);
+            if (milliHertz < long.MinValue || milliHertz > long.MaxValue)
+                return false;
+
+            frequency = new Frequency((long)milliHertz);
+            return true;
+        }
+
+        public static Frequency Parse(string text)
+        {
+            if (!TryParse(text, out Frequency frequency))
+                throw new FormatException($"Invalid frequency: {text}");
+            return frequency;
+        }
+
+        /// <summary>
+        /// Protocol text form, only the decimals needed
+        /// </summary>
+        public override string ToString()
+        {
+            decimal hz = MilliHertz / (decimal)UnitsPerHz;
+            return hz.ToString("0.###", CultureInfo.InvariantCulture);
+        }
+
+        public bool Equals(Frequency other) => MilliHertz == other.MilliHertz;
+        public override bool Equals(object obj) => obj is Frequency other && Equals(other);
+        public override int GetHashCode() => MilliHertz.GetHashCode();
+        public int CompareTo(Frequency other) => MilliHertz.CompareTo(other.MilliHertz);
+
+        public static bool operator ==(Frequency a, Frequency b) => a.MilliHertz == b.MilliHertz;
+        public static bool operator !=(Frequency a, Frequency b) => a.MilliHertz != b.MilliHertz;
+        public static bool operator <(Frequency a, Frequency b) => a.MilliHertz < b.MilliHertz;
+        public static bool operator >(Frequency a, Frequency b) => a.MilliHertz > b.MilliHertz;
+        public static bool operator <=(Frequency a, Frequency b) => a.MilliHertz <= b.MilliHertz;
+        public static bool operator >=(Frequency a, Frequency b) => a.MilliHertz >= b.MilliHertz;
+        public static Frequency operator +(Frequency a, Frequency b) => new Frequency(a.MilliHertz + b.MilliHertz);
+        public static Frequency operator -(Frequency a, Frequency b) => new Frequency(a.MilliHertz - b.MilliHertz);
+    }
+
+    /// <summary>
+    /// Lets WPF bindings edit a Frequency as its text form
+    /// </summary>
+    public class FrequencyConverter : TypeConverter
+    {
+        public override bool CanConvertFrom(ITypeDescriptorContext context, Type sourceType)
+        {
+            return sourceType == typeof(string) || base.CanConvertFrom(context, sourceType);
+        }
+
+        public override object ConvertFrom(ITypeDescriptorContext context, CultureInfo culture, object value)
+        {
+            if (value is string text)
+                return Frequency.Parse(text.Trim());
+            return base.ConvertFrom(context, culture, value);
+        }
+    }
+}
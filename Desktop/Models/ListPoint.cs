@@ -0,0 +1,28 @@
+using System;
+
+namespace FrequencyGenerator.Models
+{
+    /// <summary>
+    /// One point of a device list (LIST:DATA)
+    /// </summary>
+    public class ListPoint
+    {
+        public Frequency Frequency { get; set; }
+        public int Power { get; set; }
+        public double DwellTime { get; set; }
+
+        public ListPoint()
+        {
+            Frequency = Frequency.FromHz(2400e6);
+            Power = 0;
+            DwellTime = 0.001;
+        }
+
+        public ListPoint(Frequency frequency, int power, double dwellTime)
+        {
+            Frequency = frequency;
+            Power = power;
+            DwellTime = dwellTime;
+        }
+    }
+}
@@ -0,0 +1,216 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+using FrequencyGenerator.Models;
+
+namespace FrequencyGenerator.Services
+{
+    /// <summary>
+    /// Output power calibration against an external power meter
+    /// </summary>
+    /// <remarks>
+    /// A coarse sweep on a logarithmic grid is refined in rounds. An
+    /// interval gets its midpoint measured only while the reading at either
+    /// end is off the line through its neighbours by more than the
+    /// tolerance, i.e. where the correction curve bends. Straight stretches
+    /// keep the coarse spacing, so the device's linear interpolation stays
+    /// within tolerance with far fewer points than a uniform grid. Within a
+    /// round the retune to the next point overlaps the meter transfer of
+    /// the current one.
+    /// </remarks>
+    public class CalibrationService : ICalibrationService
+    {
+        private readonly IUSBCommunicationService _usbService;
+        private readonly IPowerMeter _powerMeter;
+
+        // Device limits (Firmware/inc/calibration.h, MAX2871 lower limit)
+        private static readonly Frequency StartFrequency = Frequency.FromHz(23.5e6);
+        private static readonly Frequency StopFrequency = Frequency.FromHz(6e9);
+        private const int MaxPoints = 256;
+        private const double CorrectionUnitDb = 0.1;
+
+        private const int CoarsePoints = 24;
+        private const int MaxRounds = 8;
+        private const double ToleranceDb = 0.15;
+        private const double MinSpacingHz = 1e6;
+        private const int ReferencePowerDbm = 0;
+
+        public CalibrationService(IUSBCommunicationService usbService, IPowerMeter powerMeter)
+        {
+            _usbService = usbService ?? throw new ArgumentNullException(nameof(usbService));
+            _powerMeter = powerMeter ?? throw new ArgumentNullException(nameof(powerMeter));
+        }
+
+        /// <summary>
+        /// Sweep, refine and load the correction table into the device (not saved)
+        /// </summary>
+        /// <remarks>
+        /// The output runs at the reference power during the sweep; frequency,
+        /// power and output state are restored afterwards, also on failure.
+        /// CAL:START clears the device table, so unless the new table is
+        /// loaded completely the stored one is reloaded (CAL:LOAD).
+        /// </remarks>
+        public async Task<CalibrationData> RunAsync(IProgress<string> progress, CancellationToken cancellationToken)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            var readings = new SortedList<Frequency, double>();
+            int measured = 0;
+
+            string frequency = await _usbService.SendCommandAsync("RF:FREQ?");
+            string power = await _usbService.SendCommandAsync("RF:POWER?");
+            string output = await _usbService.SendCommandAsync("RF:OUTPUT?");
+
+            var data = new CalibrationData();
+            bool loaded = false;
+
+            // Clearing the table also measures the output uncorrected
+            await ExpectOkAsync("CAL:START");
+            try
+            {
+                try
+                {
+                    await ExpectOkAsync($"RF:POWER {ReferencePowerDbm}");
+                    await ExpectOkAsync("RF:OUTPUT ON");
+
+                    List<Frequency> round = CoarseGrid();
+                    for (int pass = 0; round.Count > 0 && pass <= MaxRounds; pass++)
+                    {
+                        await MeasureAsync(round, readings, cancellationToken);
+                        measured += round.Count;
+                        progress?.Report($"Calibrating... {measured} points measured");
+
+                        round = Refine(readings);
+                    }
+                }
+                finally
+                {
+                    await _usbService.SendCommandAsync($"RF:OUTPUT {output}");
+                    await _usbService.SendCommandAsync($"RF:POWER {power}");
+                    await _usbService.SendCommandAsync($"RF:FREQ {frequency}");
+                }
+
+                foreach (var reading in readings)
+                {
+                    int correction = (int)Math.Round((ReferencePowerDbm - reading.Value) / CorrectionUnitDb);
+                    correction = Math.Clamp(correction, sbyte.MinValue, sbyte.MaxValue);
+
+                    await ExpectOkAsync($"CAL:POINT {reading.Key},{correction}");
+                    data.PowerCorrection.Add(new PowerCorrectionPoint
+                    {
+                        Frequency = reading.Key,
+                        MeasuredPower = reading.Value,
+                        Correction = correction * CorrectionUnitDb
+                    });
+                }
+                loaded = true;
+            }
+            finally
+            {
+                // Cancelled or failed: back to the stored table
+                if (!loaded)
+                    await _usbService.SendCommandAsync("CAL:LOAD");
+            }
+
+            data.PointsMeasured = measured;
+            data.Duration = stopwatch.Elapsed;
+            return data;
+        }
+
+        /// <summary>
+        /// Store the device table in FRAM
+        /// </summary>
+        public async Task SaveAsync()
+        {
+            await ExpectOkAsync("CAL:SAVE");
+        }
+
+        /// <summary>
+        /// Reload the stored device table
+        /// </summary>
+        public async Task LoadAsync()
+        {
+            await ExpectOkAsync("CAL:LOAD");
+        }
+
+        /// <summary>
+        /// Logarithmic grid across the band, in whole Hz
+        /// </summary>
+        private static List<Frequency> CoarseGrid()
+        {
+            var grid = new List<Frequency>(CoarsePoints);
+            double ratio = Math.Pow(StopFrequency.Hz / StartFrequency.Hz, 1.0 / (CoarsePoints - 1));
+
+            for (int i = 0; i < CoarsePoints; i++)
+                grid.Add(Frequency.FromHz(Math.Round(StartFrequency.Hz * Math.Pow(ratio, i))));
+            return grid;
+        }
+
+        /// <summary>
+        /// Midpoints of the intervals where the curve bends, lowest first
+        /// </summary>
+        private static List<Frequency> Refine(SortedList<Frequency, double> readings)
+        {
+            IList<Frequency> f = readings.Keys;
+            IList<double> p = readings.Values;
+            int count = readings.Count;
+            var bend = new double[count];
+            var next = new List<Frequency>();
+
+            // Departure of each point from the line through its neighbours
+            for (int k = 1; k < count - 1; k++)
+            {
+                double chord = p[k - 1] + (p[k + 1] - p[k - 1]) * (f[k] - f[k - 1]).Hz / (f[k + 1] - f[k - 1]).Hz;
+                bend[k] = Math.Abs(p[k] - chord);
+            }
+
+            for (int k = 0; k < count - 1 && count + next.Count < MaxPoints; k++)
+            {
+                if (Math.Max(bend[k], bend[k + 1]) > ToleranceDb && (f[k + 1] - f[k]).Hz >= 2 * MinSpacingHz)
+                    next.Add(Frequency.FromHz(Math.Round((f[k].Hz + f[k + 1].Hz) / 2)));
+            }
+            return next;
+        }
+
+        /// <summary>
+        /// Read the meter at each frequency, retuning for the next point while
+        /// the current reading is fetched
+        /// </summary>
+        private async Task MeasureAsync(IReadOnlyList<Frequency> frequencies, SortedList<Frequency, double> readings,
+                                        CancellationToken cancellationToken)
+        {
+            await TuneAsync(frequencies[0]);
+
+            for (int i = 0; i < frequencies.Count; i++)
+            {
+                await _powerMeter.AcquireAsync(frequencies[i], cancellationToken);
+
+                // The sensor has sampled - the output is free to move on
+                Task retune = (i + 1 < frequencies.Count) ? TuneAsync(frequencies[i + 1]) : Task.CompletedTask;
+                readings[frequencies[i]] = await _powerMeter.FetchAsync(cancellationToken);
+                await retune;
+            }
+        }
+
+        /// <summary>
+        /// Retune and wait until the device reports it applied (locked)
+        /// </summary>
+        private async Task TuneAsync(Frequency frequency)
+        {
+            await ExpectOkAsync($"RF:FREQ {frequency}");
+
+            string response = await _usbService.SendCommandAsync("*OPC?");
+            if (response != "1")
+                throw new InvalidOperationException($"Retune to {frequency} Hz not applied: {response}");
+        }
+
+        private async Task ExpectOkAsync(string command)
+        {
+            string response = await _usbService.SendCommandAsync(command);
+
+            if (response != "OK")
+                throw new InvalidOperationException($"{command} failed: {response}");
+        }
+    }
+}
@@ -0,0 +1,25 @@
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using FrequencyGenerator.Models;
+
+namespace FrequencyGenerator.Services
+{
+    public interface ICalibrationService
+    {
+        /// <summary>
+        /// Measure the output power correction across the band and load it into the device
+        /// </summary>
+        Task<CalibrationData> RunAsync(IProgress<string> progress, CancellationToken cancellationToken);
+
+        /// <summary>
+        /// Store the device table in FRAM
+        /// </summary>
+        Task SaveAsync();
+
+        /// <summary>
+        /// Reload the stored device table
+        /// </summary>
+        Task LoadAsync();
+    }
+}
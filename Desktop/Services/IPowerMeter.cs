@@ -0,0 +1,28 @@
+using System.Threading;
+using System.Threading.Tasks;
+using FrequencyGenerator.Models;
+
+namespace FrequencyGenerator.Services
+{
+    /// <summary>
+    /// Power meter used by the calibration sweep
+    /// </summary>
+    /// <remarks>
+    /// A reading is split in two so the next retune can overlap the
+    /// transfer: AcquireAsync completes once the sensor has finished
+    /// sampling (the output may change from then on), FetchAsync returns
+    /// that reading.
+    /// </remarks>
+    public interface IPowerMeter
+    {
+        /// <summary>
+        /// Take a reading at the given frequency (sets the sensor cal factor)
+        /// </summary>
+        Task AcquireAsync(Frequency frequency, CancellationToken cancellationToken);
+
+        /// <summary>
+        /// Get the last acquired reading in dBm
+        /// </summary>
+        Task<double> FetchAsync(CancellationToken cancellationToken);
+    }
+}
@@ -1,4 +1,6 @@
+using System.Collections.Generic;
 using System.Threading.Tasks;
+using FrequencyGenerator.Models;
 
 namespace FrequencyGenerator.Services
 {
@@ -12,8 +14,12 @@ namespace FrequencyGenerator.Services
         Task PauseProgramAsync();
         Task StopProgramAsync();
         Task<string> GetProgramStatusAsync();
-        Task AddStepAsync(string programName, double startFreq, double stopFreq, double rampTime, double dwellTime, int power);
+        Task AddStepAsync(string programName, Frequency startFreq, Frequency stopFreq, double rampTime, double dwellTime, int power);
         Task ClearStepsAsync(string programName);
         Task<string> ListProgramsAsync();
+        Task UploadListAsync(IReadOnlyList<ListPoint> points);
+        Task RunListAsync(int loops = 1);
+        Task StopListAsync();
+        Task<string> GetListStatusAsync();
     }
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 using System;
+using System.Collections.Generic;
 using System.Threading.Tasks;
+using FrequencyGenerator.Models;
 
 namespace FrequencyGenerator.Services
 {
@@ -10,6 +12,10 @@ namespace FrequencyGenerator.Services
     {
         private readonly IUSBCommunicationService _usbService;
 
+        // Device list limits (Firmware/inc/list_mode.h)
+        private const int ListMaxPoints = 10000;
+        private const int ListPointBytes = 16;
+
         public ProgramManagerService(IUSBCommunicationService usbService)
         {
             _usbService = usbService ?? throw new ArgumentNullException(nameof(usbService));
@@ -119,9 +125,9 @@ namespace FrequencyGenerator.Services
         /// <summary>
         /// Add step to current program
         /// </summary>
-        public async Task AddStepAsync(string programName, double startFreq, double stopFreq, double rampTime, double dwellTime, int power)
+        public async Task AddStepAsync(string programName, Frequency startFreq, Frequency stopFreq, double rampTime, double dwellTime, int power)
         {
-            string command = $"PROG:STEP {programName} {(long)startFreq} {(long)stopFreq} {rampTime} {dwellTime} {power}";
+            string command = $"PROG:STEP {programName} {startFreq} {stopFreq} {rampTime} {dwellTime} {power}";
             string response = await _usbService.SendCommandAsync(command);
             
             if (response != "OK")
@@ -147,5 +153,80 @@ namespace FrequencyGenerator.Services
         {
             return await _usbService.SendCommandAsync("PROG:LIST?");
         }
+
+        /// <summary>
+        /// Upload a point list in one binary transfer (replaces the device list)
+        /// </summary>
+        /// <remarks>
+        /// Each point is 16 bytes little endian: frequency (mHz, uint64),
+        /// dwell (us, uint32), power (dBm, int8), 3 reserved bytes. The
+        /// device checks the CRC, then range checks and solves every point
+        /// before it answers.
+        /// </remarks>
+        public async Task UploadListAsync(IReadOnlyList<ListPoint> points)
+        {
+            if (points == null || points.Count == 0 || points.Count > ListMaxPoints)
+                throw new ArgumentException($"List must have 1 to {ListMaxPoints} points", nameof(points));
+
+            byte[] block = new byte[points.Count * ListPointBytes];
+            for (int i = 0; i < points.Count; i++)
+            {
+                int offset = i * ListPointBytes;
+                BitConverter.TryWriteBytes(new Span<byte>(block, offset, 8), (ulong)points[i].Frequency.MilliHertz);
+                BitConverter.TryWriteBytes(new Span<byte>(block, offset + 8, 4), (uint)Math.Round(points[i].DwellTime * 1e6));
+                block[offset + 12] = (byte)(sbyte)points[i].Power;
+            }
+
+            string command = $"LIST:DATA {points.Count},{Crc16(block)}";
+            string response = await _usbService.SendBlockAsync(command, block);
+
+            if (response != "OK")
+                throw new InvalidOperationException($"Failed to upload list: {response}");
+        }
+
+        /// <summary>
+        /// Run the uploaded list (0 loops = until stopped)
+        /// </summary>
+        public async Task RunListAsync(int loops = 1)
+        {
+            string response = await _usbService.SendCommandAsync($"LIST:RUN {loops}");
+
+            if (response != "OK")
+                throw new InvalidOperationException($"Failed to run list: {response}");
+        }
+
+        /// <summary>
+        /// Stop a running list
+        /// </summary>
+        public async Task StopListAsync()
+        {
+            string response = await _usbService.SendCommandAsync("LIST:STOP");
+
+            if (response != "OK")
+                throw new InvalidOperationException($"Failed to stop list: {response}");
+        }
+
+        /// <summary>
+        /// Get list state and position
+        /// </summary>
+        public async Task<string> GetListStatusAsync()
+        {
+            return await _usbService.SendCommandAsync("LIST:STAT?");
+        }
+
+        /// <summary>
+        /// CRC-16/CCITT (poly 0x1021, init 0xFFFF), as computed by the firmware
+        /// </summary>
+        private static ushort Crc16(byte[] data)
+        {
+            ushort crc = 0xFFFF;
+            foreach (byte b in data)
+            {
+                crc ^= (ushort)(b << 8);
+                for (int bit = 0; bit < 8; bit++)
+                    crc = (crc & 0x8000) != 0 ? (ushort)((crc << 1) ^ 0x1021) : (ushort)(crc << 1);
+            }
+            return crc;
+        }
     }
 }
\ No newline at end of file
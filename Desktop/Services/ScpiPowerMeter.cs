@@ -0,0 +1,104 @@
+using System;
+using System.Globalization;
+using System.IO.Ports;
+using System.Threading;
+using System.Threading.Tasks;
+using FrequencyGenerator.Models;
+
+namespace FrequencyGenerator.Services
+{
+    /// <summary>
+    /// Bench power meter or USB power sensor speaking SCPI on a serial port
+    /// </summary>
+    /// <remarks>
+    /// Uses the common power meter command set: SENS:FREQ sets the sensor
+    /// cal factor, INIT with *OPC? takes one reading and answers once the
+    /// sensor has sampled, FETC? returns that reading. The port is opened
+    /// and the meter set to single triggered dBm readings on first use.
+    /// </remarks>
+    public class ScpiPowerMeter : IPowerMeter, IDisposable
+    {
+        private const int BaudRate = 115200;
+        private const int Timeout = 5000;
+
+        private readonly string _portName;
+        private SerialPort _serialPort;
+
+        /// <param name="portName">Serial port of the meter, e.g. COM5</param>
+        public ScpiPowerMeter(string portName)
+        {
+            _portName = portName;
+        }
+
+        public async Task AcquireAsync(Frequency frequency, CancellationToken cancellationToken)
+        {
+            await OpenAsync(cancellationToken);
+            await WriteAsync($"SENS:FREQ {frequency}", cancellationToken);
+
+            string response = await QueryAsync("INIT;*OPC?", cancellationToken);
+            if (response != "1")
+                throw new InvalidOperationException($"Power meter reading at {frequency} Hz failed: {response}");
+        }
+
+        public async Task<double> FetchAsync(CancellationToken cancellationToken)
+        {
+            string response = await QueryAsync("FETC?", cancellationToken);
+
+            if (!double.TryParse(response, NumberStyles.Float, CultureInfo.InvariantCulture, out double dbm))
+                throw new InvalidOperationException($"Power meter returned an invalid reading: {response}");
+            return dbm;
+        }
+
+        public void Dispose()
+        {
+            _serialPort?.Dispose();
+            _serialPort = null;
+        }
+
+        private async Task OpenAsync(CancellationToken cancellationToken)
+        {
+            if (_serialPort != null && _serialPort.IsOpen)
+                return;
+
+            if (string.IsNullOrWhiteSpace(_portName))
+                throw new InvalidOperationException("No power meter port set (start with --power-meter=<port>)");
+
+            _serialPort = new SerialPort(_portName, BaudRate)
+            {
+                Parity = Parity.None,
+                DataBits = 8,
+                StopBits = StopBits.One,
+                ReadTimeout = Timeout,
+                WriteTimeout = Timeout,
+                Handshake = Handshake.None,
+                NewLine = "\n"
+            };
+            _serialPort.Open();
+
+            await WriteAsync("*CLS", cancellationToken);
+            await WriteAsync("UNIT:POW DBM", cancellationToken);
+            await WriteAsync("INIT:CONT OFF", cancellationToken);
+            await WriteAsync("TRIG:SOUR IMM", cancellationToken);
+        }
+
+        private Task WriteAsync(string command, CancellationToken cancellationToken)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+            return Task.Run(() => _serialPort.WriteLine(command));
+        }
+
+        private async Task<string> QueryAsync(string command, CancellationToken cancellationToken)
+        {
+            await WriteAsync(command, cancellationToken);
+
+            try
+            {
+                return await Task.Run(() => _serialPort.ReadLine().Trim());
+            }
+            catch (TimeoutException)
+            {
+                throw new InvalidOperationException($"Power meter did not answer {command}");
+            }
+        }
+    }
+}
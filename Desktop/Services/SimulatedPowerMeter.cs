@@ -0,0 +1,56 @@
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using FrequencyGenerator.Models;
+
+namespace FrequencyGenerator.Services
+{
+    /// <summary>
+    /// Power meter stand-in for testing the calibration sweep without a bench meter
+    /// </summary>
+    /// <remarks>
+    /// Models the generator output seen through a cable: loss rising with
+    /// frequency, a step where the output divider changes range, a notch
+    /// and a little reading noise. Timing matches a typical USB power
+    /// sensor at its fast averaging setting.
+    /// </remarks>
+    public class SimulatedPowerMeter : IPowerMeter
+    {
+        private const int AcquireTimeMs = 20;
+        private const int FetchTimeMs = 5;
+        private const double NoiseDb = 0.02;
+
+        private readonly Random _random = new Random(1);
+        private double _reading;
+
+        /// <summary>
+        /// Level the generator is set to, in dBm
+        /// </summary>
+        public double SourcePowerDbm { get; set; }
+
+        public async Task AcquireAsync(Frequency frequency, CancellationToken cancellationToken)
+        {
+            await Task.Delay(AcquireTimeMs, cancellationToken);
+            _reading = SourcePowerDbm + Response(frequency.Hz) + (_random.NextDouble() * 2 - 1) * NoiseDb;
+        }
+
+        public async Task<double> FetchAsync(CancellationToken cancellationToken)
+        {
+            await Task.Delay(FetchTimeMs, cancellationToken);
+            return _reading;
+        }
+
+        /// <summary>
+        /// Gain from the nominal level in dB
+        /// </summary>
+        private static double Response(double frequencyHz)
+        {
+            double ghz = frequencyHz / 1e9;
+            double cableLoss = -0.6 * Math.Sqrt(ghz);
+            double dividerStep = ghz < 3.0 ? 0.8 : 0.0;
+            double notch = -1.5 / (1 + Math.Pow((ghz - 4.2) / 0.08, 2));
+
+            return cableLoss + dividerStep + notch;
+        }
+    }
+}
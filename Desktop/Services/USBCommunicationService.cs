@@ -1,5 +1,7 @@
 using System;
 using System.IO.Ports;
+using System.Linq;
+using System.Threading;
 using System.Threading.Tasks;
 
 namespace FrequencyGenerator.Services
@@ -7,9 +9,12 @@ namespace FrequencyGenerator.Services
     public interface IUSBCommunicationService
     {
         bool IsConnected { get; }
+        int BaudRate { get; }
         Task<bool> ConnectAsync(string portName);
+        Task<bool> NegotiateBaudRateAsync(int baudRate);
         void Disconnect();
         Task<string> SendCommandAsync(string command);
+        Task<string> SendBlockAsync(string command, byte[] block);
         Task<byte[]> SendRawAsync(byte[] data);
         string[] GetAvailablePorts();
     }
@@ -17,11 +22,20 @@ namespace FrequencyGenerator.Services
     public class USBCommunicationService : IUSBCommunicationService
     {
         private SerialPort _serialPort;
-        private const int BaudRate = 115200;
+        private const int DefaultBaudRate = 115200;
+        private const int MaxBaudRate = 2000000;
         private const int Timeout = 5000;
+        private const int BaudSwitchDelayMs = 20;     // Device switches after its "OK" has drained
+        private const int BaudProbeTimeoutMs = 500;   // Must be below the device's 1000 ms verify window
+        private const int DeviceVerifyTimeoutMs = 1000;
+
+        // One command/response transaction on the wire at a time
+        private readonly SemaphoreSlim _lock = new SemaphoreSlim(1, 1);
 
         public bool IsConnected => _serialPort?.IsOpen ?? false;
 
+        public int BaudRate => _serialPort?.BaudRate ?? DefaultBaudRate;
+
         /// <summary>
         /// Connect to device via USB/COM port
         /// </summary>
@@ -34,7 +48,7 @@ namespace FrequencyGenerator.Services
                     _serialPort.Close();
                 }
 
-                _serialPort = new SerialPort(portName, BaudRate)
+                _serialPort = new SerialPort(portName, DefaultBaudRate)
                 {
                     Parity = Parity.None,
                     DataBits = 8,
@@ -47,7 +61,9 @@ namespace FrequencyGenerator.Services
                 _serialPort.Open();
                 await Task.Delay(500); // Wait for device initialization
                 
-                System.Diagnostics.Debug.WriteLine($"Connected to {portName}");
+                await NegotiateFastestAsync();
+                
+                System.Diagnostics.Debug.WriteLine($"Connected to {portName} at {BaudRate} baud");
                 return true;
             }
             catch (Exception ex)
@@ -86,35 +102,185 @@ namespace FrequencyGenerator.Services
             if (!IsConnected)
                 throw new InvalidOperationException("Device not connected");
 
+            await _lock.WaitAsync();
             try
             {
-                // Send command
-                await Task.Run(() =>
-                {
-                    _serialPort.WriteLine(command);
-                    System.Threading.Thread.Sleep(100);
-                });
+                string response = await TransactAsync(command, Timeout);
+
+                System.Diagnostics.Debug.WriteLine($"TX: {command} | RX: {response}");
+                return response;
+            }
+            catch (Exception ex)
+            {
+                System.Diagnostics.Debug.WriteLine($"Command error: {ex.Message}");
+                throw;
+            }
+            finally
+            {
+                _lock.Release();
+            }
+        }
+
+        /// <summary>
+        /// Send a command that takes a binary block (LIST:DATA handshake)
+        /// </summary>
+        /// <remarks>
+        /// The device answers READY, then reads the block framed as an IEEE
+        /// 488.2 definite-length block (#&lt;digits&gt;&lt;length&gt;&lt;data&gt;) and replies
+        /// once it has processed it. The reply timeout allows for the time
+        /// the block takes on the wire.
+        /// </remarks>
+        public async Task<string> SendBlockAsync(string command, byte[] block)
+        {
+            if (!IsConnected)
+                throw new InvalidOperationException("Device not connected");
+
+            await _lock.WaitAsync();
+            try
+            {
+                string ready = await TransactAsync(command, Timeout);
+                if (ready != "READY")
+                    return ready;
+
+                string length = block.Length.ToString();
+                byte[] header = System.Text.Encoding.ASCII.GetBytes($"#{length.Length}{length}");
+                int wireMs = (int)((header.Length + block.Length) * 10L * 1000 / _serialPort.BaudRate);
 
-                // Receive response
                 string response = await Task.Run(() =>
                 {
+                    _serialPort.ReadTimeout = Timeout + wireMs;
+                    _serialPort.WriteTimeout = Timeout + wireMs;
                     try
                     {
-                        return _serialPort.ReadLine();
+                        _serialPort.Write(header, 0, header.Length);
+                        _serialPort.Write(block, 0, block.Length);
+                        return _serialPort.ReadLine().TrimEnd('\r');
                     }
                     catch (TimeoutException)
                     {
                         return "TIMEOUT";
                     }
+                    finally
+                    {
+                        _serialPort.ReadTimeout = Timeout;
+                        _serialPort.WriteTimeout = Timeout;
+                    }
                 });
 
-                System.Diagnostics.Debug.WriteLine($"TX: {command} | RX: {response}");
+                System.Diagnostics.Debug.WriteLine($"TX: {command} + {block.Length} bytes | RX: {response}");
                 return response;
             }
+            finally
+            {
+                _lock.Release();
+            }
+        }
+
+        /// <summary>
+        /// Write one command line and read one response line (caller holds the lock)
+        /// </summary>
+        private Task<string> TransactAsync(string command, int timeoutMs)
+        {
+            return Task.Run(() =>
+            {
+                _serialPort.ReadTimeout = timeoutMs;
+                _serialPort.WriteLine(command);
+
+                try
+                {
+                    return _serialPort.ReadLine().TrimEnd('\r');
+                }
+                catch (TimeoutException)
+                {
+                    return "TIMEOUT";
+                }
+                finally
+                {
+                    _serialPort.ReadTimeout = Timeout;
+                }
+            });
+        }
+
+        /// <summary>
+        /// Switch the link to a higher baud rate (SYS:BAUD handshake)
+        /// </summary>
+        /// <remarks>
+        /// Propose the rate and wait for the device's acknowledgement at the
+        /// current rate. Then switch locally and probe with SYS:BAUD:PING.
+        /// If the probe fails, go back to the old rate; the device does the
+        /// same once its verify window expires.
+        /// </remarks>
+        public async Task<bool> NegotiateBaudRateAsync(int baudRate)
+        {
+            if (!IsConnected)
+                throw new InvalidOperationException("Device not connected");
+
+            await _lock.WaitAsync();
+            try
+            {
+                int oldRate = _serialPort.BaudRate;
+
+                string ack = await TransactAsync($"SYS:BAUD {baudRate}", Timeout);
+                if (ack != "OK")
+                    return false;
+
+                await Task.Delay(BaudSwitchDelayMs);
+                _serialPort.BaudRate = baudRate;
+                _serialPort.DiscardInBuffer();
+
+                // Leading newline terminates any noise the device saw during the switch
+                _serialPort.Write("\n");
+                string expected = $"BAUD:{baudRate}";
+                string probe = await TransactAsync("SYS:BAUD:PING", BaudProbeTimeoutMs);
+                if (probe != expected && probe != "TIMEOUT")
+                    probe = await TransactAsync("SYS:BAUD:PING", BaudProbeTimeoutMs);
+
+                if (probe == expected)
+                {
+                    System.Diagnostics.Debug.WriteLine($"Link at {baudRate} baud");
+                    return true;
+                }
+
+                _serialPort.BaudRate = oldRate;
+                await Task.Delay(DeviceVerifyTimeoutMs);
+                _serialPort.DiscardInBuffer();
+                System.Diagnostics.Debug.WriteLine($"Baud {baudRate} failed, staying at {oldRate}");
+                return false;
+            }
+            finally
+            {
+                _lock.Release();
+            }
+        }
+
+        /// <summary>
+        /// Try the device's supported rates from fastest down
+        /// </summary>
+        private async Task NegotiateFastestAsync()
+        {
+            try
+            {
+                // "BAUD:115200,SUPPORTED:115200,230400,..."
+                string response = await SendCommandAsync("SYS:BAUD?");
+                int index = response.IndexOf("SUPPORTED:", StringComparison.Ordinal);
+                if (index < 0)
+                    return;
+
+                var rates = response.Substring(index + "SUPPORTED:".Length)
+                    .Split(',')
+                    .Select(r => int.TryParse(r, out int rate) ? rate : 0)
+                    .Where(r => r > DefaultBaudRate && r <= MaxBaudRate)
+                    .OrderByDescending(r => r);
+
+                foreach (int rate in rates)
+                {
+                    if (await NegotiateBaudRateAsync(rate))
+                        return;
+                }
+            }
             catch (Exception ex)
             {
-                System.Diagnostics.Debug.WriteLine($"Command error: {ex.Message}");
-                throw;
+                System.Diagnostics.Debug.WriteLine($"Baud negotiation error: {ex.Message}");
             }
         }
 
@@ -1,9 +1,11 @@
 using System;
 using System.Collections.ObjectModel;  // ✅ FIXED from ObjectCollection
+using System.Threading;
 using System.Windows.Input;
 using Prism.Mvvm;
 using Prism.Commands;
 using FrequencyGenerator.Models;
+using FrequencyGenerator.Services;
 
 namespace FrequencyGenerator.ViewModels
 {
@@ -12,6 +14,8 @@ namespace FrequencyGenerator.ViewModels
     /// </summary>
     public class CalibrationViewModel : BindableBase
     {
+        private readonly ICalibrationService _calibrationService;
+        private CancellationTokenSource _cancellation;
         private CalibrationData _calibrationData;
         private string _statusMessage;
         private bool _isCalibrating;
@@ -38,8 +42,9 @@ namespace FrequencyGenerator.ViewModels
         public ICommand SaveCalibrationCommand { get; }
         public ICommand LoadCalibrationCommand { get; }
 
-        public CalibrationViewModel()
+        public CalibrationViewModel(ICalibrationService calibrationService)
         {
+            _calibrationService = calibrationService ?? throw new ArgumentNullException(nameof(calibrationService));
             _calibrationData = new CalibrationData();
             _statusMessage = "Ready for calibration";
             _isCalibrating = false;
@@ -49,22 +54,70 @@ namespace FrequencyGenerator.ViewModels
             LoadCalibrationCommand = new DelegateCommand(() => LoadCalibration());
         }
 
-        private void StartCalibration()
+        /// <summary>
+        /// Run the calibration sweep; a second press cancels it
+        /// </summary>
+        private async void StartCalibration()
         {
+            if (IsCalibrating)
+            {
+                _cancellation?.Cancel();
+                return;
+            }
+
             IsCalibrating = true;
             StatusMessage = "Calibration in progress...";
-            
-            // TODO: Implement actual calibration logic
+            _cancellation = new CancellationTokenSource();
+
+            try
+            {
+                var progress = new Progress<string>(message => StatusMessage = message);
+                var data = await _calibrationService.RunAsync(progress, _cancellation.Token);
+
+                data.CalibrationNotes = CalibrationData.CalibrationNotes;
+                CalibrationData = data;
+                StatusMessage = $"Calibration complete: {data.PowerCorrection.Count} points in {data.Duration.TotalSeconds:F1} s (not saved)";
+            }
+            catch (OperationCanceledException)
+            {
+                StatusMessage = "Calibration cancelled";
+            }
+            catch (Exception ex)
+            {
+                StatusMessage = $"Calibration failed: {ex.Message}";
+            }
+            finally
+            {
+                _cancellation.Dispose();
+                _cancellation = null;
+                IsCalibrating = false;
+            }
         }
 
-        private void SaveCalibration()
+        private async void SaveCalibration()
         {
-            StatusMessage = "Calibration saved";
+            try
+            {
+                await _calibrationService.SaveAsync();
+                StatusMessage = "Calibration saved";
+            }
+            catch (Exception ex)
+            {
+                StatusMessage = $"Save failed: {ex.Message}";
+            }
         }
 
-        private void LoadCalibration()
+        private async void LoadCalibration()
         {
-            StatusMessage = "Calibration loaded";
+            try
+            {
+                await _calibrationService.LoadAsync();
+                StatusMessage = "Calibration loaded";
+            }
+            catch (Exception ex)
+            {
+                StatusMessage = $"Load failed: {ex.Message}";
+            }
         }
     }
 }
\ No newline at end of file
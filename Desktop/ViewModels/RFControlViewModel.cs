@@ -12,13 +12,13 @@ namespace FrequencyGenerator.ViewModels
     /// </summary>
     public class RFControlViewModel : BindableBase
     {
-        private double _currentFrequency;
+        private Frequency _currentFrequency;
         private int _currentPower;
         private bool _rfOutputEnabled;
         private string _frequencyInput;
         private string _statusMessage;
 
-        public double CurrentFrequency
+        public Frequency CurrentFrequency
         {
             get => _currentFrequency;
             set => SetProperty(ref _currentFrequency, value);
@@ -54,7 +54,7 @@ namespace FrequencyGenerator.ViewModels
 
         public RFControlViewModel()
         {
-            _currentFrequency = 2400e6; // 2400 MHz
+            _currentFrequency = Frequency.FromHz(2400e6); // 2400 MHz
             _currentPower = 0; // 0 dBm
             _rfOutputEnabled = false;
             _frequencyInput = "2400000000";
@@ -68,16 +68,16 @@ namespace FrequencyGenerator.ViewModels
         private void SetFrequency()
         {
             // Parse frequency input
-            if (double.TryParse(FrequencyInput, out var freq))
+            if (Frequency.TryParse(FrequencyInput, out var freq))
             {
-                if (freq >= 10e6 && freq <= 6e9)
+                if (freq >= Frequency.RangeMin && freq <= Frequency.RangeMax)
                 {
                     CurrentFrequency = freq;
                     StatusMessage = $"Frequency set to {FormatFrequency(freq)}";
                 }
                 else
                 {
-                    StatusMessage = "Frequency out of range (10 MHz - 6 GHz)";
+                    StatusMessage = "Frequency out of range (23.4375 MHz - 6 GHz)";
                 }
             }
             else
@@ -97,8 +97,10 @@ namespace FrequencyGenerator.ViewModels
             StatusMessage = RfOutputEnabled ? "RF Output: ON" : "RF Output: OFF";
         }
 
-        private string FormatFrequency(double frequency)
+        private string FormatFrequency(Frequency value)
         {
+            double frequency = value.Hz;
+
             if (frequency >= 1e9)
                 return $"{frequency / 1e9:F3} GHz";
             else if (frequency >= 1e6)
@@ -0,0 +1,84 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/**
+ * FreeRTOS Configuration - STM32H743 (Cortex-M7, ARM_CM7 port)
+ * Static allocation only; object sizes live in rtos_config.h
+ */
+
+#include "rtos_config.h"
+
+#if defined(__GNUC__) || defined(__ICCARM__)
+#include <stdint.h>
+extern uint32_t SystemCoreClock;
+#endif
+
+/* Scheduler */
+#define configUSE_PREEMPTION                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#define configCPU_CLOCK_HZ                      (SystemCoreClock)
+#define configTICK_RATE_HZ                      ((TickType_t)1000)
+#define configMAX_PRIORITIES                    RTOS_MAX_PRIORITIES
+#define configMINIMAL_STACK_SIZE                ((uint16_t)TASK_IDLE_STACK_WORDS)
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+
+/* Tickless idle - vPortSuppressTicksAndSleep() in power.c (LPTIM1 wake) */
+#define configUSE_TICKLESS_IDLE                 2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   5
+
+/* Memory: every object is allocated statically, no heap_x.c is linked */
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        0
+#define configTOTAL_HEAP_SIZE                   0
+
+/* Hooks */
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     0
+#define configCHECK_FOR_STACK_OVERFLOW          2
+#define configUSE_MALLOC_FAILED_HOOK            0
+
+/* Features */
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             0
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2       /* [1] UART TX room (hal_uart.c) */
+#define configUSE_TRACE_FACILITY                0
+#define configQUEUE_REGISTRY_SIZE               0
+#define configUSE_CO_ROUTINES                   0
+
+/* Software timers */
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               TASK_TIMER_PRIORITY
+#define configTIMER_QUEUE_LENGTH                TIMER_QUEUE_LENGTH
+#define configTIMER_TASK_STACK_DEPTH            TASK_TIMER_STACK_WORDS
+
+/* Optional API */
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+
+/**
+ * Interrupt priorities (4 priority bits on STM32H7)
+ * ISRs at numerically lower priority than 5 (ADC watchdog, TIM2) must
+ * not call the RTOS API; EXTI3, I2C and DMA sit at or below it.
+ */
+#define configPRIO_BITS                         4
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY 15
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 5
+#define configKERNEL_INTERRUPT_PRIORITY         (configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY    (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
+#define configASSERT(x) do { if ((x) == 0) { __asm volatile ("cpsid i"); for (;;); } } while (0)
+
+/* Port handlers map onto the CMSIS vector names */
+#define vPortSVCHandler     SVC_Handler
+#define xPortPendSVHandler  PendSV_Handler
+#define xPortSysTickHandler SysTick_Handler
+
+#endif /* FREERTOS_CONFIG_H */
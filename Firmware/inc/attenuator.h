@@ -0,0 +1,85 @@
+#ifndef ATTENUATOR_H
+#define ATTENUATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * PE4314 Digital Step Attenuator
+ * 6-bit parallel control on PE0-PE5 (C0.5 ... C16, 0.5 dB LSB, 31.5 dB),
+ * LE on PE6 held high so the inputs are transparent. All six bits change
+ * in one GPIOE BSRR write, so the attenuator never passes through an
+ * intermediate state.
+ *
+ * Output levels are in 0.5 dB units. The attenuator covers 31.5 dB below
+ * the top of the range; the rest comes from the MAX2871 output power
+ * (APWR, 3 dB per step), which is only lowered when the attenuator alone
+ * cannot reach the level.
+ *
+ * A power sweep steps the attenuator from a table of BSRR words written
+ * by DMA2 Stream 2 on each TIM4 update, with the output power mode fixed
+ * for the sweep, so its span is limited to the attenuator range.
+ */
+
+/* Output level range, 0.5 dB units (RF_POWER_MIN/MAX * 2) */
+#define ATTEN_LEVEL_MIN         (-40)
+#define ATTEN_LEVEL_MAX         30
+
+#define ATTEN_CODE_MAX          63          /* 31.5 dB */
+#define ATTEN_MODE_STEP         6           /* One APWR step, 0.5 dB units */
+#define ATTEN_MODE_MAX          3
+
+/* Sweep limits */
+#define ATTEN_SWEEP_MAX_POINTS  (ATTEN_CODE_MAX + 1)
+#define ATTEN_SWEEP_DWELL_MIN_US    2UL
+#define ATTEN_SWEEP_DWELL_MAX_US    6500000UL
+
+/* Attenuator code and MAX2871 output power for one level */
+typedef struct {
+    uint8_t code;
+    uint8_t power_mode;
+} Attenuator_Setting_t;
+
+typedef struct {
+    int16_t start;              /* 0.5 dB units */
+    int16_t stop;
+    uint16_t step;
+    uint32_t dwell_us;
+    bool repeat;                /* Until stopped, else one pass */
+} Attenuator_SweepConfig_t;
+
+typedef enum {
+    ATTEN_SWEEP_IDLE = 0,
+    ATTEN_SWEEP_RUNNING,
+    ATTEN_SWEEP_DONE            /* Last dwell ended, or stopped */
+} Attenuator_SweepState_t;
+
+typedef struct {
+    Attenuator_SweepState_t state;
+    uint32_t points;
+    uint32_t index;             /* Point being output */
+    uint8_t power_mode;         /* Fixed for the sweep */
+    uint8_t code;               /* Attenuator code being output */
+} Attenuator_SweepStatus_t;
+
+/* Initialization */
+void Attenuator_Init(void);
+void Attenuator_Retime(void);
+
+/* Level control */
+bool Attenuator_Solve(int16_t level, Attenuator_Setting_t* setting);
+int16_t Attenuator_ClampLevel(int32_t level);
+void Attenuator_SetLevel(int16_t level);
+void Attenuator_SetPower(int8_t power_dbm);
+void Attenuator_WriteCode(uint8_t code);
+uint8_t Attenuator_GetCode(void);
+
+/* Power sweep - the caller must own the attenuator for the whole sweep */
+bool Attenuator_CheckSweep(const Attenuator_SweepConfig_t* config);
+bool Attenuator_StartSweep(const Attenuator_SweepConfig_t* config);
+void Attenuator_StopSweep(void);
+bool Attenuator_IsSweeping(void);
+Attenuator_SweepStatus_t Attenuator_GetSweepStatus(void);
+const char* Attenuator_GetSweepStateName(Attenuator_SweepState_t state);
+
+#endif /* ATTENUATOR_H */
@@ -0,0 +1,22 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/**
+ * Cache Microbenchmark
+ * Core cycles for fixed command-dispatch and math workloads, measured
+ * with the I/D caches disabled and enabled
+ */
+
+typedef struct {
+    uint32_t dispatch_off;
+    uint32_t dispatch_on;
+    uint32_t math_off;
+    uint32_t math_on;
+} Bench_Result_t;
+
+/* Runs with the scheduler suspended; takes a few milliseconds */
+Bench_Result_t Bench_RunCache(void);
+
+#endif /* BENCH_H */
@@ -0,0 +1,30 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * Boot Profiling
+ * DWT cycle timestamps taken at the end of each init stage
+ * (cycle counter is zeroed by Timer_Init)
+ */
+
+typedef enum {
+    BOOT_STAGE_TIMEBASE = 0,    /* Timer, logger */
+    BOOT_STAGE_GPIO,            /* RF gate forced off, LEDs */
+    BOOT_STAGE_FRAM,            /* I2C up, journal DMA read started */
+    BOOT_STAGE_SYNTH,           /* MAX2871 SPI + lock detect */
+    BOOT_STAGE_ADC,             /* Calibrated, protection armed */
+    BOOT_STAGE_JOURNAL,         /* Journal read complete */
+    BOOT_STAGE_RF_READY,        /* Synthesizer programmed, RF restored */
+    BOOT_STAGE_SCHEDULER,       /* Scheduler about to start */
+    BOOT_STAGE_DEFERRED,        /* Banner, calibration table loaded */
+    BOOT_STAGE_COUNT
+} BootStage_t;
+
+void BootProfile_Mark(BootStage_t stage);
+uint32_t BootProfile_GetCycles(BootStage_t stage);
+uint32_t BootProfile_GetMicros(BootStage_t stage);
+const char* BootProfile_GetName(BootStage_t stage);
+
+#endif /* BOOT_PROFILE_H */
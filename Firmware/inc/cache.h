@@ -0,0 +1,30 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Cortex-M7 Cache and MPU Setup
+ *
+ * The .dma_buffer section (see DMA_BUFFER) is mapped non-cacheable by the
+ * MPU, so DMA transfers to and from it need no maintenance. Any other
+ * buffer handed to a DMA must be cleaned before a TX and invalidated
+ * after an RX with the helpers below (32-byte cache line granularity).
+ */
+
+/* Size of the non-cacheable DMA region - must match linker.ld */
+#define CACHE_DMA_REGION_SIZE 0x10000UL
+
+/* Called from Reset_Handler before main() */
+void Cache_Init(void);
+
+/* Runtime control (benchmarking) */
+void Cache_Enable(bool enable);
+bool Cache_IsEnabled(void);
+
+/* Maintenance for DMA buffers outside the non-cacheable region */
+void Cache_Clean(const void* addr, uint32_t len);
+void Cache_Invalidate(void* addr, uint32_t len);
+
+#endif /* CACHE_H */
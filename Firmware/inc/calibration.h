@@ -2,18 +2,30 @@
 #define CALIBRATION_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "frequency.h"
 
 /**
  * Calibration Data Management
+ * Output power correction against frequency, measured by the host with an
+ * external power meter (CAL:START, CAL:POINT) and kept sorted by
+ * frequency. Between points the correction is interpolated linearly.
+ * The RF path adds it to the output level at the current frequency.
+ * CommandTask edits the table and RFControlTask reads it, under a mutex;
+ * Calibration_GetData() is for the editing task only.
  */
 
 typedef struct {
-    uint32_t frequency;
-    int8_t power_correction;
+    Frequency_t frequency;
+    int8_t power_correction;        /* CALIBRATION_UNIT_DB steps */
     double temp_coefficient;
 } CalibrationPoint_t;
 
 #define CALIBRATION_POINTS 256
+#define CALIBRATION_UNIT_DB 0.1
+
+/* Correction steps per output level step (0.5 dB, see attenuator.h) */
+#define CALIBRATION_LEVEL_STEPS 5
 
 typedef struct {
     CalibrationPoint_t points[CALIBRATION_POINTS];
@@ -23,9 +35,11 @@ typedef struct {
 
 void Calibration_Init(void);
 void Calibration_LoadFromFRAM(void);
-void Calibration_SaveToFRAM(void);
-void Calibration_AddPoint(uint32_t freq, int8_t power, double temp);
-int8_t Calibration_GetPowerCorrection(uint32_t freq);
+bool Calibration_SaveToFRAM(void);
+void Calibration_Clear(void);
+bool Calibration_AddPoint(Frequency_t freq, int8_t power, double temp);
+int8_t Calibration_GetPowerCorrection(Frequency_t freq);
+int16_t Calibration_GetLevelCorrection(Frequency_t freq);
 CalibrationData_t* Calibration_GetData(void);
 
-#endif
\ No newline at end of file
+#endif /* CALIBRATION_H */
@@ -0,0 +1,44 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Clock Tree Configuration for STM32H743
+ *
+ * Source is the 64 MHz HSI. SPI1, USART3, I2C1 and the ADC take their
+ * kernel clocks from HSI/PER_CK, so baud rates, SCK and ADC timing are
+ * identical in every profile. Only the core and bus clocks change.
+ */
+
+/* Kernel clock of SPI1, USART3, I2C1 and the ADC (HSI) */
+#define CLOCK_KERNEL_HZ 64000000UL
+
+typedef enum {
+    CLOCK_PROFILE_PERFORMANCE = 0,  /* PLL1 480 MHz core, 240 MHz AXI, VOS0 */
+    CLOCK_PROFILE_LOW_POWER         /* HSI 64 MHz core, PLL off, VOS3 */
+} Clock_Profile_t;
+
+typedef struct {
+    Clock_Profile_t profile;
+    uint32_t sysclk_hz;         /* Read back from RCC */
+    uint32_t hclk_hz;
+    uint32_t pclk1_hz;
+    uint32_t core_measured_hz;  /* DWT cycles over 1 ms of device time */
+    uint32_t spi_sck_hz;        /* MAX2871 SCK */
+    uint32_t uart_baud;         /* USART3 kernel clock / BRR */
+} Clock_Status_t;
+
+/* Initialization (after Timer_Init) */
+void Clock_Init(Clock_Profile_t profile);
+
+/* Runtime profile switch - re-times every timer and SysTick; not while
+ * an RF timer run is active */
+bool Clock_SetProfile(Clock_Profile_t profile);
+Clock_Profile_t Clock_GetProfile(void);
+
+/* Status */
+Clock_Status_t Clock_GetStatus(void);
+
+#endif /* CLOCK_H */
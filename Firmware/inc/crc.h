@@ -0,0 +1,14 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+
+/**
+ * CRC for records stored in FRAM and data received over the link
+ * CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF
+ */
+
+uint16_t CRC16_Compute(const void* data, uint32_t length);
+uint16_t CRC16_Update(uint16_t crc, const void* data, uint32_t length);
+
+#endif /* CRC_H */
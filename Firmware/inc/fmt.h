@@ -0,0 +1,45 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Response Formatter
+ * Decimal output of integers and fixed-point values into a caller-supplied
+ * buffer, without printf, the heap or software floating point. A reply is
+ * built up with the Fmt_* calls and handed to the TX path in one piece.
+ * Output past the end of the buffer is dropped and flagged.
+ */
+
+#define FMT_DECIMALS_MAX    6
+#define FMT_U32_DIGITS      10
+#define FMT_U64_DIGITS      20
+
+typedef struct {
+    char* data;
+    size_t size;
+    size_t length;
+    bool overflow;              /* Something did not fit */
+} Fmt_Buffer_t;
+
+/* Conversion into a raw buffer of at least FMT_U32_DIGITS, not terminated */
+size_t Fmt_U32ToDec(char* digits, uint32_t value);
+
+/* Reply building */
+void Fmt_Init(Fmt_Buffer_t* out, char* data, size_t size);
+void Fmt_Char(Fmt_Buffer_t* out, char c);
+void Fmt_Str(Fmt_Buffer_t* out, const char* str);
+void Fmt_U32(Fmt_Buffer_t* out, uint32_t value);
+void Fmt_U32Padded(Fmt_Buffer_t* out, uint32_t value, uint8_t width);
+void Fmt_I32(Fmt_Buffer_t* out, int32_t value);
+void Fmt_U64(Fmt_Buffer_t* out, uint64_t value);
+
+/* value / 10^decimals, e.g. Fmt_Fixed(out, -125, 1) -> "-12.5" */
+void Fmt_Fixed(Fmt_Buffer_t* out, int32_t value, uint8_t decimals);
+
+/* printf("%.<decimals>f") without printf, rounded half away from zero */
+void Fmt_Double(Fmt_Buffer_t* out, double value, uint8_t decimals);
+
+#endif /* FMT_H */
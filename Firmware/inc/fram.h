@@ -0,0 +1,50 @@
+#ifndef FRAM_H
+#define FRAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * FRAM Driver (FM24V02A, 32 KB, 16-bit addressing) on I2C1
+ * Objects are streamed in bounded DMA chunks directly from/to their
+ * location in RAM - buffers must be DMA-accessible (see DMA_BUFFER).
+ *
+ * The journal timer, CAL:SAVE and the VCO calibration share the device:
+ * the blocking transfers take a mutex, waiting up to FRAM_LOCK_TIMEOUT_MS
+ * for the transfer in progress, and block on its completion interrupt.
+ * The async pair is for boot, before the scheduler starts, or for a
+ * caller holding FRAM_Lock().
+ */
+
+#define FRAM_I2C_ADDR 0x50
+#define FRAM_SIZE 32768UL
+
+/* Largest single DMA transfer */
+#define FRAM_CHUNK_SIZE 1024
+
+/* Longest wait for another task's transfer (one full-size transfer) */
+#define FRAM_LOCK_TIMEOUT_MS 600
+
+/* Address map */
+#define FRAM_ADDR_CALIBRATION 0x0000    /* Calibration header + points, 8 KB */
+#define FRAM_ADDR_JOURNAL 0x2000        /* RF state journal, 256 B */
+#define FRAM_ADDR_VCO_TABLE 0x2100      /* Learned VCO band table, 308 B */
+
+/* Initialization */
+void FRAM_Init(void);
+
+/* Exclusive access across tasks */
+bool FRAM_Lock(uint32_t timeout_ms);
+void FRAM_Unlock(void);
+
+/* Non-blocking transfers - one at a time */
+bool FRAM_ReadAsync(uint16_t addr, void *data, uint32_t len);
+bool FRAM_WriteAsync(uint16_t addr, const void *data, uint32_t len);
+bool FRAM_Wait(uint32_t timeout_ms);
+bool FRAM_IsBusy(void);
+
+/* Blocking transfers */
+bool FRAM_Read(uint16_t addr, void *data, uint32_t len);
+bool FRAM_Write(uint16_t addr, const void *data, uint32_t len);
+
+#endif /* FRAM_H */
@@ -0,0 +1,40 @@
+#ifndef FREQUENCY_H
+#define FREQUENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "fmt.h"
+
+/**
+ * Frequency Representation
+ * Frequencies are unsigned 64-bit fixed point in millihertz: the whole
+ * band fits with room to spare (6 GHz is 43 bits) and fractional-N
+ * planning keeps sub-hertz resolution. The protocol text form is decimal
+ * hertz with up to FREQUENCY_DECIMALS places, e.g. "5800000000.125".
+ *
+ * The conversions below use multiplies and shifts only; a 64-bit
+ * division is a libgcc call on the M7.
+ */
+
+typedef uint64_t Frequency_t;
+
+#define FREQUENCY_UNITS_PER_HZ  1000U
+#define FREQUENCY_DECIMALS      3
+
+/* Whole hertz to Frequency_t, also usable in constant expressions */
+#define FREQUENCY_HZ(hz)        ((Frequency_t)(hz) * FREQUENCY_UNITS_PER_HZ)
+
+/* Longest text form: 20 digits, point, decimals, terminator */
+#define FREQUENCY_TEXT_SIZE     (FMT_U64_DIGITS + FREQUENCY_DECIMALS + 2)
+
+/* Conversion */
+uint64_t Frequency_ToHz(Frequency_t frequency);
+uint32_t Frequency_ToKHz(Frequency_t frequency);
+
+/* Protocol text */
+bool Frequency_Parse(const char* text, char** end, Frequency_t* frequency);
+void Frequency_Format(Fmt_Buffer_t* out, Frequency_t frequency);
+const char* Frequency_ToText(Frequency_t frequency, char* text);
+
+#endif /* FREQUENCY_H */
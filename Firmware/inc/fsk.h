@@ -0,0 +1,68 @@
+#ifndef FSK_H
+#define FSK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "frequency.h"
+
+/**
+ * FSK Modulation
+ * Up to FSK_TONES_MAX tones are solved together so that they differ only
+ * in R0 (MAX2871_SolveTones). Symbols streamed from the host index the
+ * tones. At each symbol boundary a TIM3 update requests DMA2 Stream 1 to
+ * write the next R0 word to the SPI1 data register, and hardware CS
+ * latches it - no CPU involvement per symbol.
+ *
+ * The DMA runs circular over a word buffer in two halves; its half and
+ * full transfer interrupts expand the next half from the symbol FIFO,
+ * which is the only CPU work while modulating. When the FIFO runs dry the
+ * last tone is held and the missing symbols are counted as underruns.
+ *
+ * Host format: two 4-bit symbols per byte, first symbol in the low nibble.
+ * Symbols past the tone count output the first tone.
+ */
+
+#define FSK_TONES_MAX       16
+#define FSK_FIFO_SYMBOLS    8192        /* Power of two */
+#define FSK_HALF_SYMBOLS    128         /* Symbols per DMA half buffer */
+#define FSK_RATE_MIN        10          /* Symbols per second */
+
+typedef struct {
+    bool running;
+    uint32_t tones;
+    uint32_t max_error_hz;      /* Worst tone error with the shared modulus */
+    uint32_t rate_hz;           /* Actual symbol rate, after timer rounding */
+    uint32_t max_rate_hz;       /* Bound set by the SPI word time */
+    uint32_t link_rate_hz;      /* Sustained streaming bound at the current baud */
+    uint32_t buffered;          /* Symbols waiting in the FIFO */
+    uint32_t symbols;           /* Symbols handed to the DMA since started */
+    uint32_t underruns;         /* Symbol slots with the FIFO empty */
+    Frequency_t frequency;      /* Tone being output, or the last one */
+    uint32_t refill_cycles;     /* Last half buffer refill, core cycles */
+    uint32_t cpu_permille;      /* Refill load at the current rate */
+} Fsk_Status_t;
+
+/* Initialization */
+void Fsk_Init(void);
+void Fsk_Retime(void);
+
+/* Configuration */
+bool Fsk_SetTones(const Frequency_t* frequency, uint32_t count);
+bool Fsk_SetRate(uint32_t rate_hz);
+uint32_t Fsk_GetMaxRate(void);
+
+/* Symbol stream (one producer task) */
+size_t Fsk_Write(const uint8_t* data, size_t length);
+uint32_t Fsk_GetFree(void);
+
+/* Execution - Fsk_Start and Fsk_Release from the synthesizer's owner */
+bool Fsk_Start(void);
+void Fsk_Stop(void);
+void Fsk_Release(void);
+bool Fsk_IsRunning(void);
+
+/* Status */
+Fsk_Status_t Fsk_GetStatus(void);
+
+#endif /* FSK_H */
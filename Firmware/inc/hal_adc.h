@@ -2,9 +2,11 @@
 #define HAL_ADC_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * ADC Driver for Temperature, Voltage and Current Monitoring
+ * Continuous scan with circular DMA - readings never block
  */
 
 typedef struct {
@@ -13,11 +15,36 @@ typedef struct {
     double current;
 } ADC_Readings_t;
 
+/* Scan ranks (raw codes, DMA order) */
+typedef enum {
+    ADC_RAW_TEMPERATURE = 0,
+    ADC_RAW_VOLTAGE,
+    ADC_RAW_CURRENT,
+    ADC_RAW_COUNT
+} ADC_RawChannel_t;
+
+/* Protection faults detected by the ADC analog watchdogs */
+#define ADC_FAULT_NONE          0x00
+#define ADC_FAULT_OVERTEMP      0x01
+#define ADC_FAULT_OVERCURRENT   0x02
+
+typedef struct {
+    uint8_t latched;        /* Faults tripped since the last clear */
+    uint8_t active;         /* Faults not yet back below the recovery threshold */
+    uint32_t trip_count;    /* Total watchdog trips since boot */
+} ADC_FaultStatus_t;
+
 void ADC_Init(void);
 void ADC_StartConversion(void);
+bool ADC_IsCalibrated(void);
+uint16_t ADC_GetRaw(ADC_RawChannel_t channel);
 ADC_Readings_t ADC_GetReadings(void);
 double ADC_GetTemperature(void);
 double ADC_GetVoltage(void);
 double ADC_GetCurrent(void);
 
-#endif
\ No newline at end of file
+/* Hardware protection */
+ADC_FaultStatus_t ADC_GetFaultStatus(void);
+bool ADC_ClearFault(void);
+
+#endif
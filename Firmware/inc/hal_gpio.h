@@ -19,7 +19,10 @@ void GPIO_Init(void);
 
 /* RF Control */
 void GPIO_SetRFOutput(bool enable);
+void GPIO_SetRFBlank(bool blank);
+void GPIO_SetRFInhibit(bool inhibit);
 bool GPIO_GetRFOutput(void);
+void GPIO_SetRFPulsed(bool pulsed);
 
 /* LED Control */
 void GPIO_SetStatusLED(bool on);
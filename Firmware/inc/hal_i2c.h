@@ -6,11 +6,24 @@
 
 /**
  * I2C Driver for FRAM Storage and Sensors
+ * I2C1 at 1 MHz Fast-mode Plus, DMA for 16-bit addressed memory access
  */
 
+/* Called from interrupt context when a DMA transfer finishes */
+typedef void (*I2C_CompleteCallback_t)(bool success);
+
 void I2C_Init(void);
+
+/* 8-bit register access (sensors), blocking with timeout */
 void I2C_WriteData(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len);
 void I2C_ReadData(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len);
 bool I2C_IsDeviceReady(uint8_t addr);
 
-#endif
\ No newline at end of file
+/* 16-bit addressed memory access via DMA (non-blocking) */
+bool I2C_MemWriteDMA(uint8_t addr, uint16_t mem_addr, const uint8_t *data,
+                     uint16_t len, I2C_CompleteCallback_t callback);
+bool I2C_MemReadDMA(uint8_t addr, uint16_t mem_addr, uint8_t *data,
+                    uint16_t len, I2C_CompleteCallback_t callback);
+void I2C_Abort(uint8_t addr);
+
+#endif
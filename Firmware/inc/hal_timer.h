@@ -0,0 +1,36 @@
+#ifndef HAL_TIMER_H
+#define HAL_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * System Timebase
+ * TIM2 free-running at 1 MHz (device time in microseconds)
+ * DWT cycle counter for sub-microsecond profiling
+ * TIM2 CH1 compare provides a one-shot alarm at an absolute device time
+ */
+
+/* Alarm callback - runs in the TIM2 ISR (priority 1, above the RTOS:
+ * must not call FreeRTOS API) */
+typedef void (*Timer_AlarmCallback_t)(void);
+
+/* Initialization */
+void Timer_Init(void);
+void Timer_Retime(uint64_t now_us);
+uint32_t Timer_GetClockHz(void);
+uint32_t Timer_GetApb2ClockHz(void);
+
+/* Device time */
+uint32_t Timer_GetMicros(void);
+uint64_t Timer_GetMicros64(void);
+void Timer_DelayMicros(uint32_t us);
+
+/* One-shot alarm */
+bool Timer_SetAlarm(uint32_t at_us, Timer_AlarmCallback_t callback);
+bool Timer_CancelAlarm(void);
+
+/* Core cycle counter */
+uint32_t Timer_GetCycles(void);
+
+#endif /* HAL_TIMER_H */
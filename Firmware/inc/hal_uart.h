@@ -7,26 +7,47 @@
 
 /**
  * UART/USB CDC Communication Handler
- * Supports 115200 baud rate, 8-N-1 format
+ * 8-N-1, 115200 baud at reset; up to 2 Mbaud after SYS:BAUD negotiation
+ *
+ * Both directions are interrupt driven through RAM rings, so printing a
+ * reply costs the caller a copy, not the time on the wire.
  */
 
+#define UART_DEFAULT_BAUD 115200
+
 /* Initialization */
 void UART_Init(void);
 void UART_DeInit(void);
 
+/* Baud rate */
+bool UART_IsBaudSupported(uint32_t baud);
+const uint32_t* UART_GetSupportedBauds(uint32_t* count);
+bool UART_SetBaudRate(uint32_t baud);
+uint32_t UART_GetConfiguredBaud(void);
+
 /* Transmission */
 void UART_SendByte(uint8_t byte);
 void UART_SendBuffer(const uint8_t* buffer, size_t length);
 void UART_SendString(const char* str);
+void UART_Flush(void);
+
+typedef void (*UART_LineCallback_t)(void);
 
 /* Reception */
 uint8_t UART_ReceiveByte(void);
 size_t UART_ReceiveBuffer(uint8_t* buffer, size_t max_length);
+size_t UART_ReceiveAvailable(uint8_t* buffer, size_t max_length);
+void UART_SetRawMode(bool raw);
 char* UART_ReceiveString(void);
+uint32_t UART_GetLineTimestamp(void);
+void UART_SetLineCallback(UART_LineCallback_t callback);
 
 /* Status */
 uint32_t UART_GetRxSize(void);
 bool UART_IsDataAvailable(void);
+uint32_t UART_GetBaudRate(void);
+uint32_t UART_GetRxErrors(void);
+uint32_t UART_GetTxPending(void);
 
 /* Low-level */
 void UART_PutChar(char c);
@@ -0,0 +1,80 @@
+#ifndef LIST_MODE_H
+#define LIST_MODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "frequency.h"
+
+/**
+ * List Mode
+ * An arbitrary (frequency, power, dwell) point list, uploaded in one
+ * binary transfer and kept in AXI SRAM. Every point is range checked and
+ * solved into a MAX2871 register image when the upload completes, so a
+ * run only writes registers: the TIM5 update ISR commits point n+1 when
+ * the dwell of point n expires.
+ *
+ * Wire format: LIST_POINT_BYTES per point, little endian, CRC-16/CCITT
+ * over all points (see ListMode_Point_t).
+ */
+
+#define LIST_MAX_POINTS     10000
+#define LIST_POINT_BYTES    16
+
+/* Dwell covers the register burst and ISR entry; 32-bit microseconds */
+#define LIST_DWELL_MIN_US   50UL
+
+/* Upload record */
+typedef struct {
+    Frequency_t frequency;      /* Millihertz */
+    uint32_t dwell_us;
+    int8_t power_dbm;
+    uint8_t reserved[3];
+} ListMode_Point_t;
+
+typedef enum {
+    LIST_STATE_EMPTY = 0,       /* Nothing loaded, or the last upload failed */
+    LIST_STATE_LOADING,         /* Upload in progress */
+    LIST_STATE_READY,           /* Loaded and solved */
+    LIST_STATE_RUNNING,         /* TIM5 stepping through the points */
+    LIST_STATE_DONE             /* Finished or stopped; can be run again */
+} ListMode_State_t;
+
+typedef enum {
+    LIST_LOAD_OK = 0,
+    LIST_LOAD_INCOMPLETE,       /* Fewer bytes than announced */
+    LIST_LOAD_CRC,
+    LIST_LOAD_RANGE             /* A point is out of range or cannot be solved */
+} ListMode_LoadResult_t;
+
+typedef struct {
+    ListMode_State_t state;
+    uint32_t points;
+    uint32_t index;             /* Point being output */
+    uint32_t loop;              /* Completed passes */
+    uint32_t loops;             /* Requested passes, 0 = until stopped */
+    uint32_t steps;             /* Points committed since the run started */
+    Frequency_t frequency;      /* Point being output */
+    int8_t power_dbm;
+    uint32_t solve_us;          /* Time to check and solve the last upload */
+} ListMode_Status_t;
+
+/* Initialization */
+void ListMode_Init(void);
+void ListMode_Retime(void);
+
+/* Upload (task context, not while running) */
+bool ListMode_BeginUpload(uint32_t points);
+void ListMode_Receive(const uint8_t* data, size_t length);
+ListMode_LoadResult_t ListMode_EndUpload(uint16_t crc, uint32_t* bad_point);
+
+/* Execution - the caller must own the synthesizer for the whole run */
+bool ListMode_Run(uint32_t loops);
+void ListMode_Stop(void);
+bool ListMode_IsRunning(void);
+
+/* Status */
+ListMode_Status_t ListMode_GetStatus(void);
+const char* ListMode_GetStateName(ListMode_State_t state);
+
+#endif /* LIST_MODE_H */
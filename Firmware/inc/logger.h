@@ -0,0 +1,106 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * Deferred Binary Logger
+ *
+ * Log calls store a format-string ID and raw 32-bit arguments in a RAM
+ * ring; formatting happens later in the low-priority LogTask or on the
+ * host. Format strings are placed in the .logstr section and the ID is
+ * the string's offset in it, so the host can rebuild the table from the
+ * ELF (firmware.logstr is extracted at build time).
+ *
+ * Arguments are stored as 32-bit words: integers pass through, floating
+ * point values must be wrapped with LOG_F() and string literals (flash
+ * only - the pointer is dereferenced later) with LOG_S().
+ */
+
+typedef enum {
+    LOG_LEVEL_ERROR = 0,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+} Log_Level_t;
+
+typedef enum {
+    LOG_MODE_TEXT = 0,      /* Decoded on device by LogTask */
+    LOG_MODE_BINARY         /* Raw records, decoded on the host */
+} Log_Mode_t;
+
+#define LOG_MAX_ARGS 4
+
+/* Binary record - sent as-is in LOG_MODE_BINARY after LOG_FRAME_SYNC */
+typedef struct {
+    uint32_t timestamp_us;
+    uint16_t id;                /* Format offset in .logstr (<= 64KB, checked at link) */
+    uint8_t level;
+    uint8_t nargs;
+    uint32_t args[LOG_MAX_ARGS];
+} Log_Record_t;
+
+#define LOG_FRAME_SYNC 0xA5
+
+/* Runtime level filter - checked inline at every call site */
+extern volatile uint8_t log_level;
+
+/* Initialization */
+void Log_Init(void);
+
+/* Producer (any context, including ISRs) */
+void Log_Write(uint8_t level, const char* fmt, const uint32_t* args, uint8_t nargs);
+
+/* Consumer */
+void Log_Process(void);
+bool Log_ProcessOne(void);
+bool Log_Read(Log_Record_t* record);
+const char* Log_GetFormat(uint16_t id);
+
+/* Configuration */
+void Log_SetLevel(uint8_t level);
+uint8_t Log_GetLevel(void);
+void Log_SetMode(Log_Mode_t mode);
+Log_Mode_t Log_GetMode(void);
+
+/* Status */
+uint32_t Log_GetPending(void);
+uint32_t Log_GetDropped(void);
+
+/**
+ * @brief Store a float argument as its raw bit pattern
+ */
+static inline uint32_t Log_Float(float value)
+{
+    uint32_t word;
+    memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+#define LOG_F(x) Log_Float((float)(x))
+#define LOG_S(s) ((uint32_t)(uintptr_t)(s))
+
+/* Split "fmt, args..." - a trailing 0 keeps the argument list non-empty */
+#define LOG_FMT_(fmt, ...) fmt
+#define LOG_ARGS_(fmt, ...) __VA_ARGS__
+
+#define LOG_WRITE(level, ...) \
+    do { \
+        static const char log_fmt_[] __attribute__((section(".logstr"), used)) = \
+            LOG_FMT_(__VA_ARGS__, 0); \
+        if ((level) <= log_level) \
+        { \
+            const uint32_t log_args_[] = { LOG_ARGS_(__VA_ARGS__, 0) }; \
+            Log_Write((level), log_fmt_, log_args_, \
+                      (uint8_t)(sizeof(log_args_) / sizeof(log_args_[0]) - 1)); \
+        } \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_WRITE(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_WRITE(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_WRITE(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_WRITE(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif /* LOGGER_H */
@@ -6,20 +6,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "attenuator.h"
+#include "frequency.h"
+#include "max2871.h"
 
 /* System Configuration */
-#define SYSTEM_CLOCK_HZ 480000000UL
+#define SYSTEM_CLOCK_HZ 480000000UL     /* Performance profile, see clock.h */
 #define UART_BAUD_RATE 115200
 
+/* Place an object in DMA-accessible AXI SRAM (DMA1/2 cannot reach DTCM).
+ * The region is non-cacheable, so no cache maintenance is needed. */
+#define DMA_BUFFER __attribute__((section(".dma_buffer"), aligned(32)))
+
 /* RF Parameters */
-#define RF_FREQ_MIN 10000000UL      /* 10 MHz */
-#define RF_FREQ_MAX 6000000000UL    /* 6 GHz */
+#define RF_FREQ_MIN FREQUENCY_HZ(MAX2871_FREQ_MIN_HZ) /* 23.4375 MHz, solver floor */
+#define RF_FREQ_MAX FREQUENCY_HZ(6000000000ULL)      /* 6 GHz */
 #define RF_POWER_MIN -20            /* dBm */
 #define RF_POWER_MAX 15             /* dBm */
 
+/* Scheduled retunes: at least this far ahead, at most half the 32-bit
+ * device time range */
+#define RF_SCHEDULE_MIN_LEAD_US 2000UL
+#define RF_SCHEDULE_MAX_LEAD_US 0x7FFFFFFFUL
+
 /* Temperature Limits */
 #define TEMP_WARNING 70             /* °C */
 #define TEMP_SHUTDOWN 85            /* °C */
+#define TEMP_RECOVER 75             /* °C - protection hysteresis */
+
+/* Current Limits */
+#define CURRENT_SHUTDOWN 1.8        /* A */
+#define CURRENT_RECOVER 1.5         /* A - protection hysteresis */
 
 /* =========================== */
 /* SYSTEM INITIALIZATION       */
@@ -32,10 +49,17 @@ int SystemRun(void);
 /* RF CONTROL FUNCTIONS        */
 /* =========================== */
 void RF_Init(void);
-void RF_SetFrequency(uint32_t frequency_hz);
+void RF_SetFrequency(Frequency_t frequency);
+void RF_ScheduleFrequency(Frequency_t frequency, uint32_t at_us);
+void RF_CancelSchedule(void);
+void RF_RunList(uint32_t loops);
+void RF_StopList(void);
+void RF_StartFsk(void);
+void RF_StopFsk(void);
+void RF_StartPowerSweep(const Attenuator_SweepConfig_t* config);
+void RF_StopPowerSweep(void);
 void RF_SetPower(int8_t power_dbm);
 void RF_Enable(bool enable);
-void Attenuator_SetPower(int8_t power_dbm);
 
 /* =========================== */
 /* MONITORING FUNCTIONS        */
@@ -51,7 +75,7 @@ double Monitor_GetCurrent(void);
 /* =========================== */
 void Calibration_Init(void);
 void Calibration_LoadFromFRAM(void);
-void Calibration_SaveToFRAM(void);
+bool Calibration_SaveToFRAM(void);
 
 /* =========================== */
 /* UART COMMUNICATION          */
@@ -87,12 +111,19 @@ void I2C_WriteData(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len);
 void I2C_ReadData(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len);
 bool I2C_IsDeviceReady(uint8_t addr);
 
+/* =========================== */
+/* FRAM STORAGE                */
+/* =========================== */
+void FRAM_Init(void);
+bool FRAM_Read(uint16_t addr, void *data, uint32_t len);
+bool FRAM_Write(uint16_t addr, const void *data, uint32_t len);
+
 /* =========================== */
 /* MAX2871 RF SYNTHESIZER      */
 /* =========================== */
 void MAX2871_Init(void);
-void MAX2871_SetFrequency(uint32_t frequency_hz);
-uint32_t MAX2871_GetFrequency(void);
+bool MAX2871_SetFrequency(Frequency_t frequency);
+Frequency_t MAX2871_GetFrequency(void);
 bool MAX2871_IsPLLLocked(void);
 
 #endif /* MAIN_H */
\ No newline at end of file
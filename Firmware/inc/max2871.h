@@ -1,37 +1,158 @@
 #ifndef MAX2871_H
 #define MAX2871_H
 
-#include <stdint. h>
+#include <stdint.h>
 #include <stdbool.h>
+#include "frequency.h"
 
 /**
  * MAX2871 RF Synthesizer Driver
- * Frequency range: 10 MHz - 6 GHz
+ * Frequency range: 23.5 MHz - 6 GHz (VCO 3-6 GHz, output divider 1-128)
+ *
+ * A frequency is solved into a complete register image first; applying
+ * the image writes only the registers that changed, R0 last, so a
+ * retune is a single short SPI burst.
+ *
+ * An image can also be staged for a given device time. The words to send
+ * are worked out when it is armed, and the TIM2 compare ISR only shifts
+ * them out, so the R0 latch lands within a few microseconds of the
+ * requested time.
+ *
+ * Solved images are kept in a fixed-size open-addressed cache keyed by
+ * frequency, so hop sets that revisit the same frequencies skip the
+ * divider search. The cache is shared by the tasks that solve (under a
+ * mutex), so MAX2871_Solve is task context only.
+ *
+ * VCO autoselect can be bypassed with a band table learned from the chip
+ * itself (MAX2871_CalibrateVCO). Each retune then programs the band
+ * directly, which saves the band search from the lock time.
+ *
+ * For modulation, a set of tones sharing everything but R0 can be solved
+ * together and SPI1 handed to a DMA stream that writes R0 words directly,
+ * with hardware CS latching each one.
  */
 
+#define MAX2871_REF_HZ          25000000UL  /* Reference = PFD (R = 1) */
+#define MAX2871_FREQ_MIN_HZ     23437500UL  /* 3 GHz VCO / 128 */
+
+/* Learned VCO band grid: 3.00 - 5.99 GHz VCO in 10 MHz steps */
+#define MAX2871_VCO_TABLE_STEP_HZ   10000000UL
+#define MAX2871_VCO_TABLE_POINTS    300
+
+/* Solve cache: 2^MAX2871_CACHE_BITS images, 32 bytes each */
+#define MAX2871_CACHE_BITS      9
+#define MAX2871_CACHE_SIZE      (1UL << MAX2871_CACHE_BITS)
+
+/* Complete register image, address bits included */
+typedef struct {
+    uint32_t reg[6];                /* R0..R5 */
+    Frequency_t frequency;          /* Frequency the image was solved for */
+} MAX2871_Registers_t;
+
 typedef struct {
-    uint32_t frequency_hz;
+    Frequency_t frequency;
     bool pll_locked;
     uint8_t power_mode;
+    bool vco_direct;                /* Learned band table in use */
+    uint32_t vco_fallbacks;         /* Learned band missed, autoselect retry */
+    uint32_t relock_auto_us;        /* Mean retune-to-lock, autoselect */
+    uint32_t relock_direct_us;      /* Mean retune-to-lock, band programmed */
+    uint32_t relocks_auto;
+    uint32_t relocks_direct;
 } MAX2871_Status_t;
 
+/* Lock detect statistics (timestamps in device microseconds) */
+typedef struct {
+    bool locked;
+    uint32_t unlock_events;         /* Unexpected losses of lock */
+    uint32_t last_lock_us;
+    uint32_t last_unlock_us;
+    uint32_t total_unlocked_us;     /* Accumulated unexpected unlock time */
+    uint32_t longest_unlocked_us;
+    uint32_t last_relock_us;        /* Retune-to-lock time of last retune */
+} MAX2871_LockStats_t;
+
+/* Solve cache statistics (cycle counts are DWT core cycles) */
+typedef struct {
+    uint32_t entries;
+    uint32_t capacity;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t hit_cycles;            /* Last MAX2871_Solve served from the cache */
+    uint32_t miss_cycles;           /* Last MAX2871_Solve that had to solve */
+} MAX2871_CacheStats_t;
+
+/* Scheduled commit status (times in device microseconds) */
+typedef struct {
+    bool pending;                   /* Armed, not yet written */
+    Frequency_t frequency;          /* Frequency of the last armed image */
+    uint32_t at_us;                 /* Its commit time */
+    uint32_t commits;
+    uint32_t late;                  /* Armed too late to meet the commit time */
+    int32_t last_error_us;          /* R0 latch time - commit time */
+    int32_t min_error_us;
+    int32_t max_error_us;
+} MAX2871_CommitStats_t;
+
+/* Called from the lock detect ISR on every lock state change */
+typedef void (*MAX2871_LockCallback_t)(bool locked);
+
 /* Initialization */
 void MAX2871_Init(void);
 void MAX2871_DeInit(void);
 
 /* Frequency Control */
-void MAX2871_SetFrequency(uint32_t frequency_hz);
-uint32_t MAX2871_GetFrequency(void);
+bool MAX2871_Solve(Frequency_t frequency, MAX2871_Registers_t* image);
+bool MAX2871_SolveUncached(Frequency_t frequency, MAX2871_Registers_t* image);
+uint32_t MAX2871_GetPlanGeneration(void);
+bool MAX2871_Apply(const MAX2871_Registers_t* image);
+void MAX2871_Commit(const MAX2871_Registers_t* image);
+bool MAX2871_SetFrequency(Frequency_t frequency);
+Frequency_t MAX2871_GetFrequency(void);
 bool MAX2871_IsPLLLocked(void);
 
+/* VCO band table */
+bool MAX2871_CalibrateVCO(uint8_t* bands);
+void MAX2871_SetVcoTable(const uint8_t* bands);
+bool MAX2871_IsVcoTableActive(void);
+
+/* Streaming - R0 words written to the SPI data register by a DMA */
+bool MAX2871_SolveTones(const Frequency_t* frequency, uint32_t count,
+                        MAX2871_Registers_t* image, uint32_t* words, uint32_t* max_error_hz);
+bool MAX2871_BeginStream(const MAX2871_Registers_t* image);
+void MAX2871_EndStream(Frequency_t frequency);
+volatile uint32_t* MAX2871_GetStreamRegister(void);
+uint32_t MAX2871_GetStreamWordNs(void);
+
+/* Solve cache */
+bool MAX2871_CachePreload(Frequency_t frequency);
+void MAX2871_CacheClear(void);
+MAX2871_CacheStats_t MAX2871_GetCacheStats(void);
+
+/* Scheduled commit - the image is written from the TIM2 compare ISR */
+bool MAX2871_Schedule(const MAX2871_Registers_t* image, uint32_t at_us);
+bool MAX2871_CancelSchedule(void);
+bool MAX2871_IsCommitPending(void);
+MAX2871_CommitStats_t MAX2871_GetCommitStats(void);
+void MAX2871_ClearCommitStats(void);
+
+/* Lock Detect */
+MAX2871_LockStats_t MAX2871_GetLockStats(void);
+void MAX2871_SetLockCallback(MAX2871_LockCallback_t callback);
+void MAX2871_SetUnlockBlanking(bool enable);
+bool MAX2871_GetUnlockBlanking(void);
+
 /* Power Control */
 void MAX2871_SetPowerMode(uint8_t mode);
+void MAX2871_SelectPowerMode(uint8_t mode);
 uint8_t MAX2871_GetPowerMode(void);
 
 /* Status */
 MAX2871_Status_t MAX2871_GetStatus(void);
 
 /* SPI Communication */
+void MAX2871_WriteRegisters(const MAX2871_Registers_t* image);
 void MAX2871_WriteRegister(uint8_t reg, uint32_t data);
 uint32_t MAX2871_ReadRegister(uint8_t reg);
 
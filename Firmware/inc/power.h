@@ -0,0 +1,34 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Low-Power Idle
+ * FreeRTOS tickless idle (configUSE_TICKLESS_IDLE = 2): SysTick is
+ * stopped while no task is ready and LPTIM1 (LSI, 1 ms resolution)
+ * wakes the core for the next timeout. The LSI rate is measured against
+ * TIM2 on every timed wake, and the wake lands early by a margin scaled
+ * to the sleep. Elapsed time is measured on the TIM2 device timebase, so
+ * the RTOS tick does not drift.
+ */
+
+typedef struct {
+    uint32_t sleeps;            /* Tickless sleep entries */
+    uint64_t asleep_us;         /* Total time with the tick suppressed */
+    uint64_t uptime_us;         /* Device time at query */
+    float idle_current_a;       /* Averaged supply current while parked */
+    bool idle_current_valid;
+} Power_Status_t;
+
+/* Initialization (LSI + LPTIM1) */
+void Power_Init(void);
+
+/* Supply current sample from the monitor; averaged only while parked */
+void Power_SampleCurrent(double current_a, bool parked);
+
+/* Status */
+Power_Status_t Power_GetStatus(void);
+
+#endif /* POWER_H */
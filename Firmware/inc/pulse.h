@@ -0,0 +1,54 @@
+#ifndef PULSE_H
+#define PULSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Pulse Modulation
+ * TIM15_CH1N drives the RF enable pin (PA1, AF4) in PWM mode 2, so each
+ * period starts with the off time and ends with the pulse:
+ *
+ *     start/trigger      period - width         width
+ *     |__________________________________|‾‾‾‾‾‾‾‾‾‾‾‾‾|___ ...
+ *
+ * The timer counts the bus timer clock (4.17 ns at 240 MHz). A burst of
+ * up to PULSE_COUNT_MAX pulses is counted by the repetition counter in
+ * one-pulse mode, with no interrupts. The RF gate (output request,
+ * unlock blanking, protection inhibit) still applies: it enables the
+ * timer output (MOE) instead of driving the pin.
+ */
+
+/* Burst length limit: 8-bit repetition counter */
+#define PULSE_COUNT_MAX     256
+
+/* Period and width are given in ns; 16-bit counter with a prescaler */
+#define PULSE_PERIOD_MAX_NS 4000000000UL
+
+typedef struct {
+    bool enabled;               /* TIM15 owns the RF enable pin */
+    bool sync;                  /* Burst fired at each list mode point */
+    uint32_t count;             /* Pulses per burst, 0 = continuous */
+    uint32_t period_ns;         /* Actual, after rounding to the timer clock */
+    uint32_t width_ns;
+    uint32_t resolution_ps;     /* One timer tick */
+    uint32_t bursts;            /* Bursts fired since enabled */
+} Pulse_Status_t;
+
+/* Initialization */
+void Pulse_Init(void);
+bool Pulse_Retime(void);
+
+/* Configuration - applied at the next period when running */
+bool Pulse_Configure(uint32_t period_ns, uint32_t width_ns, uint32_t count);
+void Pulse_Enable(bool enable);
+void Pulse_SetSync(bool sync);
+
+/* Burst start (any context, including the list mode ISR) */
+bool Pulse_Trigger(void);
+void Pulse_SyncPoint(void);
+
+/* Status */
+Pulse_Status_t Pulse_GetStatus(void);
+
+#endif /* PULSE_H */
@@ -0,0 +1,98 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Telemetry Recorder
+ * TIM6 samples the raw ADC codes and the PLL lock state into a RAM ring
+ * at up to 10 kHz, independent of the link. Samples are packed into
+ * fixed-size blocks as zigzag varint deltas from the previous sample;
+ * each block restarts from zero so it decodes on its own, and the
+ * oldest block is overwritten when the ring is full. A triggered capture
+ * is limited to what the ring holds in the worst case, so the
+ * pre-trigger history is never overwritten.
+ *
+ * Sample encoding: for each enabled channel, in bit order,
+ * varint(zigzag(value - previous value)).
+ */
+
+/* Channels (bitmask) */
+#define REC_CH_TEMP         0x01    /* Raw 12-bit ADC code */
+#define REC_CH_VOLT         0x02    /* Raw 12-bit ADC code */
+#define REC_CH_CURR         0x04    /* Raw 12-bit ADC code */
+#define REC_CH_LOCK         0x08    /* 1 = PLL locked */
+#define REC_CH_ALL          0x0F
+#define REC_CHANNEL_COUNT   4
+
+/* TIM6 counts at 100 kHz; the 16-bit period bounds the slowest rate */
+#define REC_RATE_MIN_HZ     2
+#define REC_RATE_MAX_HZ     10000
+
+/* Ring: 128 x 256 B = 32 KB */
+#define REC_BLOCK_BYTES     256
+#define REC_BLOCK_COUNT     128
+
+/* Blocks per REC:DATA? chunk */
+#define REC_CHUNK_BLOCKS    16
+
+typedef enum {
+    REC_TRIGGER_NONE = 0,   /* Free-running until stopped */
+    REC_TRIGGER_LOCK,       /* PLL loss of lock */
+    REC_TRIGGER_FAULT,      /* Over-temperature / over-current trip */
+    REC_TRIGGER_MANUAL      /* Recorder_Trigger(REC_TRIGGER_MANUAL) only */
+} Recorder_Trigger_t;
+
+typedef enum {
+    REC_STATE_IDLE = 0,     /* Stopped; ring holds the last capture */
+    REC_STATE_RUNNING,      /* Free-running */
+    REC_STATE_ARMED,        /* Recording, waiting for the trigger */
+    REC_STATE_TRIGGERED,    /* Recording post-trigger samples */
+    REC_STATE_DONE          /* Triggered capture complete */
+} Recorder_State_t;
+
+/* Block header - sent as-is (little endian) by REC:DATA? */
+typedef struct {
+    uint32_t first_sample;  /* Sample number of the first sample */
+    uint32_t timestamp_us;  /* Device time of the first sample */
+    uint16_t samples;
+    uint16_t length;        /* Encoded payload bytes that follow */
+} Recorder_BlockHeader_t;
+
+typedef struct {
+    Recorder_State_t state;
+    Recorder_Trigger_t trigger;
+    uint8_t channels;
+    uint32_t rate_hz;           /* Actual rate after TIM6 rounding */
+    uint32_t pre_samples;
+    uint32_t post_samples;
+    uint32_t samples;           /* Samples taken since start */
+    uint32_t trigger_sample;    /* Sample number at the trigger */
+    uint32_t first_sample;      /* First sample of the download window */
+    uint32_t blocks;            /* Blocks in the download window */
+    uint32_t bytes;             /* Encoded bytes in the download window */
+} Recorder_Status_t;
+
+/* Initialization */
+void Recorder_Init(void);
+void Recorder_Retime(void);
+
+/* Capture control (task context) */
+bool Recorder_Configure(uint8_t channels, uint32_t rate_hz);
+bool Recorder_Start(Recorder_Trigger_t trigger, uint32_t pre_samples, uint32_t post_samples);
+void Recorder_Stop(void);
+
+/* Trigger event (any context, including ISRs) */
+void Recorder_Trigger(Recorder_Trigger_t source);
+
+/* Download - only while not recording; index 0 is the oldest block */
+const Recorder_BlockHeader_t* Recorder_GetBlock(uint32_t index);
+
+/* Status */
+uint32_t Recorder_GetCapacity(void);
+Recorder_Status_t Recorder_GetStatus(void);
+const char* Recorder_GetStateName(Recorder_State_t state);
+const char* Recorder_GetTriggerName(Recorder_Trigger_t trigger);
+
+#endif /* RECORDER_H */
@@ -0,0 +1,40 @@
+#ifndef RTOS_CONFIG_H
+#define RTOS_CONFIG_H
+
+/**
+ * RTOS Object Sizing
+ * Single source for every task, queue and timer in the firmware.
+ * All RTOS objects are statically allocated from these values - there
+ * is no RTOS heap (configSUPPORT_DYNAMIC_ALLOCATION = 0).
+ */
+
+/* Application tasks: stack depth in words, priority */
+#define TASK_MONITOR_STACK_WORDS    512
+#define TASK_MONITOR_PRIORITY       2
+
+#define TASK_RFCONTROL_STACK_WORDS  256
+#define TASK_RFCONTROL_PRIORITY     2
+
+#define TASK_COMMAND_STACK_WORDS    512
+#define TASK_COMMAND_PRIORITY       3
+
+#define TASK_LOG_STACK_WORDS        384
+#define TASK_LOG_PRIORITY           1
+
+/* Kernel tasks */
+#define TASK_IDLE_STACK_WORDS       128
+#define TASK_TIMER_STACK_WORDS      256
+#define TASK_TIMER_PRIORITY         (RTOS_MAX_PRIORITIES - 1)
+#define TIMER_QUEUE_LENGTH          8
+
+#define RTOS_MAX_PRIORITIES         5
+
+/* Total task stack RAM (bytes) - cross-check against the link map */
+#define RTOS_STACK_BYTES            (4 * (TASK_MONITOR_STACK_WORDS + \
+                                          TASK_RFCONTROL_STACK_WORDS + \
+                                          TASK_COMMAND_STACK_WORDS + \
+                                          TASK_LOG_STACK_WORDS + \
+                                          TASK_IDLE_STACK_WORDS + \
+                                          TASK_TIMER_STACK_WORDS))
+
+#endif /* RTOS_CONFIG_H */
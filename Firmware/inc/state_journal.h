@@ -0,0 +1,42 @@
+#ifndef STATE_JOURNAL_H
+#define STATE_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frequency.h"
+
+/**
+ * RF State Journal in FRAM
+ * Append-only ring of CRC-protected records; the valid record with the
+ * highest sequence number is restored at boot. A torn write only ever
+ * damages the newest slot, leaving the previous state intact.
+ */
+
+typedef struct {
+    Frequency_t frequency;
+    int8_t power_dbm;
+    bool rf_enabled;
+    uint16_t program_id;        /* Loaded program/list, 0 = none */
+} StateJournal_State_t;
+
+typedef struct {
+    bool restored;
+    uint32_t sequence;
+    uint32_t restore_us;        /* Journal read start to restore complete */
+    uint32_t writes;
+} StateJournal_Status_t;
+
+/* Initialization / boot restore */
+void StateJournal_Init(void);
+bool StateJournal_Restore(StateJournal_State_t* state);
+bool StateJournal_RestoreStart(void);
+bool StateJournal_RestoreFinish(StateJournal_State_t* state);
+
+/* Coalesced updates: Update() is cheap, Flush() writes FRAM */
+void StateJournal_Update(const StateJournal_State_t* state);
+bool StateJournal_Flush(void);
+
+/* Status */
+StateJournal_Status_t StateJournal_GetStatus(void);
+
+#endif /* STATE_JOURNAL_H */
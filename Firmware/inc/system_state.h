@@ -0,0 +1,48 @@
+#ifndef SYSTEM_STATE_H
+#define SYSTEM_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frequency.h"
+
+/**
+ * Shared System State (seqlock)
+ * One versioned block holds the RF settings and the latest monitor
+ * readings. Writers bracket their updates with BeginWrite/EndWrite; the
+ * sequence counter is odd while an update is in progress. Readers copy
+ * the block and retry only if the sequence changed underneath them, so
+ * they never block a writer or each other and never see torn doubles.
+ *
+ * Writers run with interrupts masked for the few stores of an update,
+ * which serialises writers and means a reader in an ISR can never spin
+ * on a writer it interrupted.
+ */
+
+typedef struct {
+    /* Requested RF settings (RF mailbox) */
+    Frequency_t frequency;
+    int8_t power_dbm;
+    bool rf_enabled;
+    bool rf_busy;               /* Settings above not yet applied */
+    
+    /* Monitor readings (MonitorTask) */
+    double temperature;
+    double voltage;
+    double current;
+    uint32_t monitor_us;        /* Device time of the readings */
+    
+    uint32_t sequence;          /* Version of this snapshot (even) */
+} SystemState_t;
+
+/* Initialization */
+void SystemState_Init(const SystemState_t* initial);
+
+/* Writers - keep the bracketed section to plain stores */
+SystemState_t* SystemState_BeginWrite(void);
+void SystemState_EndWrite(void);
+
+/* Readers (any context) */
+void SystemState_Read(SystemState_t* snapshot);
+uint32_t SystemState_GetSequence(void);
+
+#endif /* SYSTEM_STATE_H */
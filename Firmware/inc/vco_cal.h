@@ -0,0 +1,33 @@
+#ifndef VCO_CAL_H
+#define VCO_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Learned MAX2871 VCO Band Table
+ * The band the chip's autoselect picks is recorded across the VCO range
+ * (MAX2871_CalibrateVCO) and kept in FRAM, CRC protected. While the
+ * table is valid and enabled, retunes program the band directly.
+ */
+
+typedef struct {
+    bool valid;                 /* Table loaded or measured */
+    bool enabled;               /* Installed in the driver */
+    bool complete;              /* Every grid point locked and read back */
+    uint32_t points;
+    uint32_t cal_us;            /* Duration of the last characterization */
+} VcoCal_Status_t;
+
+/* Load from FRAM and install if valid (deferred init) */
+void VcoCal_Init(void);
+
+/* Characterize, store and install - RF task only, RF output off */
+bool VcoCal_Run(void);
+
+/* Use or bypass a valid table */
+void VcoCal_SetEnabled(bool enable);
+
+VcoCal_Status_t VcoCal_GetStatus(void);
+
+#endif /* VCO_CAL_H */
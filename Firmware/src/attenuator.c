@@ -0,0 +1,412 @@
+/**
+ * PE4314 Digital Step Attenuator for STM32H743
+ * Parallel mode on GPIOE, single BSRR write per level change
+ */
+
+#include "attenuator.h"
+#include "hal_timer.h"
+#include "main.h"
+#include "max2871.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+/* Control bits C0.5 ... C16 on PE0-PE5, LE on PE6 */
+#define ATTEN_PORT          GPIOE
+#define ATTEN_PIN_MASK      0x3FUL
+#define ATTEN_PIN_LE        GPIO_PIN_6
+
+/* TIM4 count rate: 1 us steps, 100 us for dwells past 16 bits */
+#define ATTEN_TICK_FINE_HZ      1000000UL
+#define ATTEN_TICK_COARSE_HZ    10000UL
+#define ATTEN_COUNTER_MAX       65535UL
+
+static DMA_HandleTypeDef hdma_sweep;
+
+static volatile uint8_t atten_code = ATTEN_CODE_MAX;
+
+/* Sweep - BSRR word per point, in the order the DMA writes them */
+static uint32_t sweep_table[ATTEN_SWEEP_MAX_POINTS] DMA_BUFFER;
+static uint8_t sweep_codes[ATTEN_SWEEP_MAX_POINTS];
+static uint32_t sweep_points = 0;
+static uint32_t sweep_transfers = 0;
+static bool sweep_repeat = false;
+static uint8_t sweep_mode = ATTEN_MODE_MAX;
+static uint32_t sweep_tick_hz = ATTEN_TICK_FINE_HZ;
+static volatile Attenuator_SweepState_t sweep_state = ATTEN_SWEEP_IDLE;
+static volatile uint32_t sweep_stop_index = 0;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Configure the control pins at full attenuation, and the sweep
+ * timer and DMA stream
+ */
+void Attenuator_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    
+    __HAL_RCC_GPIOE_CLK_ENABLE();
+    __HAL_RCC_TIM4_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    
+    /* Full attenuation before the pins become outputs */
+    ATTEN_PORT->BSRR = ATTEN_PIN_MASK | ATTEN_PIN_LE;
+    atten_code = ATTEN_CODE_MAX;
+    
+    GPIO_InitStruct.Pin = ATTEN_PIN_MASK | ATTEN_PIN_LE;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_MEDIUM;
+    HAL_GPIO_Init(ATTEN_PORT, &GPIO_InitStruct);
+    
+    TIM4->CR1 = 0;
+    TIM4->DIER = 0;
+    
+    hdma_sweep.Instance = DMA2_Stream2;
+    hdma_sweep.Init.Request = DMA_REQUEST_TIM4_UP;
+    hdma_sweep.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_sweep.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_sweep.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_sweep.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_sweep.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_sweep.Init.Mode = DMA_NORMAL;
+    hdma_sweep.Init.Priority = DMA_PRIORITY_MEDIUM;
+    hdma_sweep.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    HAL_DMA_Init(&hdma_sweep);
+    
+    /* End of a one-pass sweep only - no timing depends on these */
+    HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+    HAL_NVIC_SetPriority(TIM4_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(TIM4_IRQn);
+}
+
+/**
+ * @brief Reload the TIM4 prescaler after a bus clock change
+ * Buffered: a running sweep picks it up at the next point.
+ */
+void Attenuator_Retime(void)
+{
+    TIM4->PSC = (Timer_GetClockHz() / sweep_tick_hz) - 1;
+}
+
+/* ============================= */
+/* LEVEL CONTROL                 */
+/* ============================= */
+
+/**
+ * @brief BSRR word that sets all six control bits at once
+ */
+static uint32_t Attenuator_BsrrWord(uint8_t code)
+{
+    return code | ((~(uint32_t)code & ATTEN_PIN_MASK) << 16);
+}
+
+/**
+ * @brief Split a level into attenuator code and output power mode
+ * @param level Output level, 0.5 dB units (ATTEN_LEVEL_MIN - MAX)
+ * @return false if out of range
+ */
+bool Attenuator_Solve(int16_t level, Attenuator_Setting_t* setting)
+{
+    if (level < ATTEN_LEVEL_MIN || level > ATTEN_LEVEL_MAX)
+        return false;
+    
+    uint32_t attenuation = (uint32_t)(ATTEN_LEVEL_MAX - level);
+    uint32_t drop = 0;
+    
+    /* Lower APWR only for what the attenuator cannot cover */
+    if (attenuation > ATTEN_CODE_MAX)
+        drop = (attenuation - ATTEN_CODE_MAX + ATTEN_MODE_STEP - 1) / ATTEN_MODE_STEP;
+    
+    setting->code = (uint8_t)(attenuation - drop * ATTEN_MODE_STEP);
+    setting->power_mode = (uint8_t)(ATTEN_MODE_MAX - drop);
+    return true;
+}
+
+/**
+ * @brief Limit a corrected level to the output range
+ */
+int16_t Attenuator_ClampLevel(int32_t level)
+{
+    if (level < ATTEN_LEVEL_MIN)
+        return ATTEN_LEVEL_MIN;
+    if (level > ATTEN_LEVEL_MAX)
+        return ATTEN_LEVEL_MAX;
+    return (int16_t)level;
+}
+
+/**
+ * @brief Write the attenuator code (safe to call from ISR)
+ */
+void Attenuator_WriteCode(uint8_t code)
+{
+    ATTEN_PORT->BSRR = Attenuator_BsrrWord(code & ATTEN_PIN_MASK);
+    atten_code = code & ATTEN_PIN_MASK;
+}
+
+/**
+ * @brief Set the output level (task context - may write the synthesizer)
+ * When both parts change, the one that lowers the output goes first, so
+ * the level in between is never above either end.
+ * @param level 0.5 dB units
+ */
+void Attenuator_SetLevel(int16_t level)
+{
+    Attenuator_Setting_t setting;
+    
+    if (!Attenuator_Solve(level, &setting))
+        return;
+    
+    bool attenuate_first = setting.code > atten_code;
+    
+    if (attenuate_first)
+        Attenuator_WriteCode(setting.code);
+    if (setting.power_mode != MAX2871_GetPowerMode())
+        MAX2871_SetPowerMode(setting.power_mode);
+    if (!attenuate_first)
+        Attenuator_WriteCode(setting.code);
+}
+
+/**
+ * @brief Set the output level in whole dBm
+ */
+void Attenuator_SetPower(int8_t power_dbm)
+{
+    Attenuator_SetLevel((int16_t)power_dbm * 2);
+}
+
+/**
+ * @brief Get the code being output
+ */
+uint8_t Attenuator_GetCode(void)
+{
+    return atten_code;
+}
+
+/* ============================= */
+/* POWER SWEEP                   */
+/* ============================= */
+
+/**
+ * @brief Output power mode that reaches every level of a sweep
+ * @return false if the span needs more than the attenuator range
+ */
+static bool Attenuator_SweepMode(const Attenuator_SweepConfig_t* config, uint8_t* mode)
+{
+    int16_t low = (config->start < config->stop) ? config->start : config->stop;
+    int16_t high = (config->start < config->stop) ? config->stop : config->start;
+    Attenuator_Setting_t weakest;
+    
+    if (!Attenuator_Solve(low, &weakest) || high > ATTEN_LEVEL_MAX)
+        return false;
+    
+    /* The strongest level must not need negative attenuation */
+    int32_t top = (int32_t)weakest.code - (high - low);
+    if (top < 0)
+        return false;
+    
+    *mode = weakest.power_mode;
+    return true;
+}
+
+/**
+ * @brief Validate a sweep without starting it
+ */
+bool Attenuator_CheckSweep(const Attenuator_SweepConfig_t* config)
+{
+    uint8_t mode;
+    
+    if (config->step == 0 || config->start == config->stop)
+        return false;
+    
+    uint32_t span = (uint32_t)((config->start < config->stop) ?
+                               config->stop - config->start : config->start - config->stop);
+    
+    if (span % config->step != 0 || span / config->step + 1 > ATTEN_SWEEP_MAX_POINTS)
+        return false;
+    
+    if (config->dwell_us < ATTEN_SWEEP_DWELL_MIN_US || config->dwell_us > ATTEN_SWEEP_DWELL_MAX_US)
+        return false;
+    
+    return Attenuator_SweepMode(config, &mode);
+}
+
+/**
+ * @brief Output the first point and start stepping
+ * Each TIM4 update has the DMA write the next point's BSRR word. The table
+ * holds points 1..n-1, then point 0 when repeating, so a circular transfer
+ * wraps to the start.
+ * @return false if the sweep is invalid or one is running
+ */
+bool Attenuator_StartSweep(const Attenuator_SweepConfig_t* config)
+{
+    uint8_t mode;
+    
+    if (sweep_state == ATTEN_SWEEP_RUNNING || !Attenuator_CheckSweep(config) ||
+        !Attenuator_SweepMode(config, &mode))
+    {
+        return false;
+    }
+    
+    int16_t direction = (config->stop > config->start) ? 1 : -1;
+    uint32_t span = (uint32_t)((config->stop - config->start) * direction);
+    uint32_t attenuation_max = (uint32_t)(ATTEN_LEVEL_MAX - (ATTEN_MODE_MAX - mode) * ATTEN_MODE_STEP);
+    
+    sweep_points = span / config->step + 1;
+    for (uint32_t i = 0; i < sweep_points; i++)
+    {
+        int16_t level = config->start + direction * (int16_t)(i * config->step);
+        sweep_codes[i] = (uint8_t)(attenuation_max - level);
+    }
+    for (uint32_t i = 1; i < sweep_points; i++)
+        sweep_table[i - 1] = Attenuator_BsrrWord(sweep_codes[i]);
+    sweep_table[sweep_points - 1] = Attenuator_BsrrWord(sweep_codes[0]);
+    
+    sweep_repeat = config->repeat;
+    sweep_transfers = sweep_repeat ? sweep_points : sweep_points - 1;
+    sweep_mode = mode;
+    
+    /* Point 0: lower the output first if the mode goes up */
+    if (sweep_codes[0] > atten_code)
+        Attenuator_WriteCode(sweep_codes[0]);
+    if (mode != MAX2871_GetPowerMode())
+        MAX2871_SetPowerMode(mode);
+    Attenuator_WriteCode(sweep_codes[0]);
+    
+    /* Dwell in TIM4 ticks */
+    uint32_t ticks;
+    if (config->dwell_us <= ATTEN_COUNTER_MAX)
+    {
+        sweep_tick_hz = ATTEN_TICK_FINE_HZ;
+        ticks = config->dwell_us;
+    }
+    else
+    {
+        sweep_tick_hz = ATTEN_TICK_COARSE_HZ;
+        ticks = config->dwell_us / (ATTEN_TICK_FINE_HZ / ATTEN_TICK_COARSE_HZ);
+    }
+    
+    hdma_sweep.Init.Mode = sweep_repeat ? DMA_CIRCULAR : DMA_NORMAL;
+    HAL_DMA_Init(&hdma_sweep);
+    HAL_DMA_Start(&hdma_sweep, (uint32_t)sweep_table, (uint32_t)&ATTEN_PORT->BSRR, sweep_transfers);
+    if (!sweep_repeat)
+        __HAL_DMA_ENABLE_IT(&hdma_sweep, DMA_IT_TC);
+    
+    sweep_state = ATTEN_SWEEP_RUNNING;
+    
+    TIM4->CR1 = TIM_CR1_URS | TIM_CR1_ARPE;
+    Attenuator_Retime();
+    TIM4->ARR = ticks - 1;
+    TIM4->CNT = 0;
+    TIM4->EGR = TIM_EGR_UG;
+    TIM4->SR = 0;
+    TIM4->DIER = TIM_DIER_UDE;
+    TIM4->CR1 = TIM_CR1_URS | TIM_CR1_ARPE | TIM_CR1_CEN;
+    return true;
+}
+
+/**
+ * @brief Stop the timer; the attenuator keeps the current point
+ */
+static void Attenuator_StopTimer(void)
+{
+    TIM4->CR1 &= ~TIM_CR1_CEN;
+    TIM4->DIER = 0;
+    TIM4->SR = 0;
+}
+
+/**
+ * @brief Points the DMA has written since the start
+ */
+static uint32_t Attenuator_SweepIndex(void)
+{
+    uint32_t done = sweep_transfers - __HAL_DMA_GET_COUNTER(&hdma_sweep);
+    
+    return sweep_repeat ? done % sweep_points : done;
+}
+
+/**
+ * @brief Stop a sweep at the current point
+ */
+void Attenuator_StopSweep(void)
+{
+    if (sweep_state != ATTEN_SWEEP_RUNNING)
+        return;
+    
+    Attenuator_StopTimer();
+    sweep_stop_index = Attenuator_SweepIndex();
+    atten_code = sweep_codes[sweep_stop_index];
+    HAL_DMA_Abort(&hdma_sweep);
+    HAL_NVIC_ClearPendingIRQ(TIM4_IRQn);
+    HAL_NVIC_ClearPendingIRQ(DMA2_Stream2_IRQn);
+    sweep_state = ATTEN_SWEEP_DONE;
+}
+
+/**
+ * @brief Check whether TIM4 owns the attenuator
+ */
+bool Attenuator_IsSweeping(void)
+{
+    return sweep_state == ATTEN_SWEEP_RUNNING;
+}
+
+/**
+ * @brief Get sweep status
+ */
+Attenuator_SweepStatus_t Attenuator_GetSweepStatus(void)
+{
+    Attenuator_SweepStatus_t status;
+    
+    status.state = sweep_state;
+    status.points = sweep_points;
+    status.power_mode = sweep_mode;
+    status.index = (status.state == ATTEN_SWEEP_RUNNING) ? Attenuator_SweepIndex() : sweep_stop_index;
+    status.code = (status.state == ATTEN_SWEEP_IDLE) ? atten_code : sweep_codes[status.index];
+    return status;
+}
+
+/**
+ * @brief Get sweep state name for status reports
+ */
+const char* Attenuator_GetSweepStateName(Attenuator_SweepState_t state)
+{
+    static const char* const names[] = { "IDLE", "RUNNING", "DONE" };
+    
+    return (state <= ATTEN_SWEEP_DONE) ? names[state] : "UNKNOWN";
+}
+
+/* ============================= */
+/* INTERRUPT HANDLERS            */
+/* ============================= */
+
+/**
+ * @brief DMA2 Stream 2 Interrupt Handler - last point of a one-pass sweep
+ * written; its dwell ends at the next TIM4 update
+ */
+void DMA2_Stream2_IRQHandler(void)
+{
+    if (DMA2->LISR & DMA_LISR_TCIF2)
+    {
+        DMA2->LIFCR = DMA_LIFCR_CTCIF2;
+        TIM4->SR = ~TIM_SR_UIF;
+        TIM4->DIER = TIM_DIER_UIE;
+    }
+}
+
+/**
+ * @brief TIM4 Interrupt Handler - one-pass sweep finished
+ */
+void TIM4_IRQHandler(void)
+{
+    if (TIM4->SR & TIM_SR_UIF)
+    {
+        TIM4->SR = ~TIM_SR_UIF;
+        Attenuator_StopTimer();
+        sweep_stop_index = sweep_points - 1;
+        atten_code = sweep_codes[sweep_stop_index];
+        sweep_state = ATTEN_SWEEP_DONE;
+    }
+}
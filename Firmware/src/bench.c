@@ -0,0 +1,135 @@
+/**
+ * Cache Microbenchmark
+ * Workloads mirror the command parser and the monitor conversions
+ */
+
+#include "bench.h"
+#include "cache.h"
+#include "hal_timer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS Includes */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_DISPATCH_ROUNDS 200
+#define BENCH_MATH_ROUNDS 500
+
+/* Command prefixes in ProcessCommand order */
+static const char* const bench_prefixes[] = {
+    "SYS:IDN?", "SYS:RESET", "SYS:STAT?", "SYS:FAULT?", "SYS:FAULT:CLR",
+    "SYS:BOOT?", "SYS:RESTORE?", "RF:FREQ ", "RF:FREQ?", "RF:POWER ",
+    "RF:POWER?", "RF:OUTPUT?", "RF:LOCK?", "RF:BLANK?", "LOG:LEVEL ",
+    "LOG:LEVEL?", "LOG:STAT?", "PROG:RUN", "PROG:STOP", "CAL:START",
+    "CAL:SAVE"
+};
+
+/* Typical host traffic */
+static const char* const bench_lines[] = {
+    "RF:FREQ 2400000000",
+    "RF:POWER -10",
+    "SYS:STAT?",
+    "RF:FREQ?",
+    "CAL:SAVE"
+};
+
+/* Results are written here so the work is not optimized away */
+static volatile uint32_t bench_sink;
+static volatile double bench_sink_f;
+
+/* ============================= */
+/* WORKLOADS                     */
+/* ============================= */
+
+/**
+ * @brief Match each line against the command chain and parse arguments
+ */
+static void Bench_Dispatch(void)
+{
+    uint32_t hits = 0;
+    
+    for (uint32_t round = 0; round < BENCH_DISPATCH_ROUNDS; round++)
+    {
+        for (uint32_t line = 0; line < sizeof(bench_lines) / sizeof(bench_lines[0]); line++)
+        {
+            const char* command = bench_lines[line];
+            
+            for (uint32_t i = 0; i < sizeof(bench_prefixes) / sizeof(bench_prefixes[0]); i++)
+            {
+                size_t len = strlen(bench_prefixes[i]);
+                
+                if (strncmp(command, bench_prefixes[i], len) == 0)
+                {
+                    hits += i + (uint32_t)strtoul(command + len, NULL, 10);
+                    break;
+                }
+            }
+        }
+    }
+    
+    bench_sink = hits;
+}
+
+/**
+ * @brief Sensor conversions and dB math as done by the monitor path
+ */
+static void Bench_Math(void)
+{
+    double acc = 0.0;
+    
+    for (uint32_t i = 0; i < BENCH_MATH_ROUNDS; i++)
+    {
+        double raw = (double)(i & 0xFFF);
+        double mv = (raw / 4096.0) * 3300.0;
+        double temperature = 25.0 + (mv - 750.0) / -3.5;
+        double power_mw = pow(10.0, (double)((int32_t)(i % 36) - 20) / 10.0);
+        
+        acc += temperature + 10.0 * log10(power_mw + 1e-3) + sqrt(mv);
+    }
+    
+    bench_sink_f = acc;
+}
+
+/**
+ * @brief Cycles for one run of a workload
+ */
+static uint32_t Bench_Measure(void (*workload)(void))
+{
+    uint32_t start = Timer_GetCycles();
+    workload();
+    return Timer_GetCycles() - start;
+}
+
+/* ============================= */
+/* BENCHMARK                     */
+/* ============================= */
+
+/**
+ * @brief Run both workloads with caches off, then on
+ * The cached runs follow an untimed warm-up pass.
+ */
+Bench_Result_t Bench_RunCache(void)
+{
+    Bench_Result_t result;
+    bool was_enabled = Cache_IsEnabled();
+    
+    vTaskSuspendAll();
+    
+    Cache_Enable(false);
+    result.dispatch_off = Bench_Measure(Bench_Dispatch);
+    result.math_off = Bench_Measure(Bench_Math);
+    
+    Cache_Enable(true);
+    Bench_Dispatch();
+    Bench_Math();
+    result.dispatch_on = Bench_Measure(Bench_Dispatch);
+    result.math_on = Bench_Measure(Bench_Math);
+    
+    Cache_Enable(was_enabled);
+    
+    xTaskResumeAll();
+    
+    return result;
+}
@@ -0,0 +1,56 @@
+/**
+ * Boot Profiling
+ * Stage timestamps for SYS:BOOT?
+ */
+
+#include "boot_profile.h"
+#include "hal_timer.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+static uint32_t boot_cycles[BOOT_STAGE_COUNT];
+
+static const char* const boot_stage_names[BOOT_STAGE_COUNT] = {
+    "TIMEBASE",
+    "GPIO",
+    "FRAM",
+    "SYNTH",
+    "ADC",
+    "JOURNAL",
+    "RFREADY",
+    "SCHED",
+    "DEFERRED"
+};
+
+/**
+ * @brief Record the end of an init stage
+ */
+void BootProfile_Mark(BootStage_t stage)
+{
+    if (stage < BOOT_STAGE_COUNT)
+        boot_cycles[stage] = Timer_GetCycles();
+}
+
+/**
+ * @brief Get stage timestamp in core cycles (0 = not reached)
+ */
+uint32_t BootProfile_GetCycles(BootStage_t stage)
+{
+    return (stage < BOOT_STAGE_COUNT) ? boot_cycles[stage] : 0;
+}
+
+/**
+ * @brief Get stage timestamp in microseconds at the current core clock
+ */
+uint32_t BootProfile_GetMicros(BootStage_t stage)
+{
+    return (uint32_t)(((uint64_t)BootProfile_GetCycles(stage) * 1000000ULL) / SystemCoreClock);
+}
+
+/**
+ * @brief Get stage name as reported by SYS:BOOT?
+ */
+const char* BootProfile_GetName(BootStage_t stage)
+{
+    return (stage < BOOT_STAGE_COUNT) ? boot_stage_names[stage] : "?";
+}
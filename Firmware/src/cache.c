@@ -0,0 +1,115 @@
+/**
+ * Cortex-M7 Cache and MPU Setup for STM32H743
+ */
+
+#include "cache.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+#define CACHE_LINE_SIZE 32UL
+
+/* Start of the DMA region (linker.ld) */
+extern uint32_t __dma_buffer_start__;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Configure the MPU
+ *
+ * Region 0: .dma_buffer in AXI SRAM - normal memory, non-cacheable,
+ * shareable. Everything else keeps the default memory map (PRIVDEFENA),
+ * so flash and SRAM are write-back cacheable and peripherals are device
+ * memory.
+ */
+static void Cache_ConfigMPU(void)
+{
+    MPU_Region_InitTypeDef region = {0};
+    
+    HAL_MPU_Disable();
+    
+    region.Enable = MPU_REGION_ENABLE;
+    region.Number = MPU_REGION_NUMBER0;
+    region.BaseAddress = (uint32_t)&__dma_buffer_start__;
+    region.Size = MPU_REGION_SIZE_64KB;
+    region.SubRegionDisable = 0x00;
+    region.TypeExtField = MPU_TEX_LEVEL1;
+    region.AccessPermission = MPU_REGION_FULL_ACCESS;
+    region.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+    region.IsShareable = MPU_ACCESS_SHAREABLE;
+    region.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+    region.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+    HAL_MPU_ConfigRegion(&region);
+    
+    HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+}
+
+/**
+ * @brief Program the MPU and enable I/D caches
+ * Runs before main() - no HAL state or .data dependencies
+ */
+void Cache_Init(void)
+{
+    Cache_ConfigMPU();
+    
+    SCB_EnableICache();
+    SCB_EnableDCache();
+}
+
+/* ============================= */
+/* RUNTIME CONTROL               */
+/* ============================= */
+
+/**
+ * @brief Enable or disable both caches (D-cache is cleaned first)
+ */
+void Cache_Enable(bool enable)
+{
+    if (enable)
+    {
+        SCB_EnableICache();
+        SCB_EnableDCache();
+    }
+    else
+    {
+        SCB_DisableDCache();
+        SCB_DisableICache();
+    }
+}
+
+/**
+ * @brief Check if the caches are enabled
+ */
+bool Cache_IsEnabled(void)
+{
+    return (SCB->CCR & (SCB_CCR_IC_Msk | SCB_CCR_DC_Msk)) ==
+           (SCB_CCR_IC_Msk | SCB_CCR_DC_Msk);
+}
+
+/* ============================= */
+/* MAINTENANCE                   */
+/* ============================= */
+
+/**
+ * @brief Write back cached data before a DMA reads it
+ */
+void Cache_Clean(const void* addr, uint32_t len)
+{
+    uint32_t start = (uint32_t)addr & ~(CACHE_LINE_SIZE - 1);
+    uint32_t end = ((uint32_t)addr + len + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+    
+    SCB_CleanDCache_by_Addr((uint32_t*)start, (int32_t)(end - start));
+}
+
+/**
+ * @brief Discard cached data after a DMA wrote it
+ * The buffer must own whole cache lines (align and pad to 32 bytes)
+ */
+void Cache_Invalidate(void* addr, uint32_t len)
+{
+    uint32_t start = (uint32_t)addr & ~(CACHE_LINE_SIZE - 1);
+    uint32_t end = ((uint32_t)addr + len + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+    
+    SCB_InvalidateDCache_by_Addr((uint32_t*)start, (int32_t)(end - start));
+}
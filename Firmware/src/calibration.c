@@ -1,46 +1,234 @@
 #include "calibration.h"
-#include "hal_i2c.h"
+#include "fram.h"
+#include "main.h"
 
-static CalibrationData_t calib_data;
+/* FreeRTOS */
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+/* FRAM record: header followed by 'count' points */
+#define CALIBRATION_MAGIC 0x43414C32UL      /* "CAL2" */
+#define CALIBRATION_MAGIC_V1 0x43414C31UL   /* "CAL1": 32-bit Hz keys, converted on load */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+    uint32_t timestamp;
+    uint32_t reserved;
+} CalibrationHeader_t;
+
+typedef struct {
+    uint32_t frequency_hz;
+    int8_t power_correction;
+    double temp_coefficient;
+} CalibrationPointV1_t;
+
+#define CALIBRATION_POINTS_ADDR (FRAM_ADDR_CALIBRATION + sizeof(CalibrationHeader_t))
+
+/* Header after the magic - written before it on save */
+#define CALIBRATION_HEADER_BODY offsetof(CalibrationHeader_t, count)
+
+/* DMA reads/writes these in place - no intermediate buffers */
+static CalibrationData_t calib_data DMA_BUFFER;
+static CalibrationHeader_t calib_header DMA_BUFFER;
+
+/* CommandTask edits the table while RFControlTask interpolates in it */
+static SemaphoreHandle_t calib_mutex = NULL;
+static StaticSemaphore_t calib_mutex_buffer;
+
+/**
+ * @brief Take the table (no-op before the scheduler starts; until
+ * Calibration_Init the table is empty)
+ */
+static void Calibration_Lock(void)
+{
+    if (calib_mutex != NULL && xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+        xSemaphoreTake(calib_mutex, portMAX_DELAY);
+}
+
+/**
+ * @brief Release the table
+ */
+static void Calibration_Unlock(void)
+{
+    if (calib_mutex != NULL && xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+        xSemaphoreGive(calib_mutex);
+}
 
 void Calibration_Init(void)
 {
+    if (calib_mutex == NULL)
+        calib_mutex = xSemaphoreCreateMutexStatic(&calib_mutex_buffer);
+    
+    Calibration_Lock();
     calib_data.count = 0;
     calib_data.timestamp = 0;
+    Calibration_Unlock();
 }
 
 void Calibration_LoadFromFRAM(void)
 {
-    // Load from FRAM via I2C
-    uint8_t buffer[sizeof(CalibrationData_t)];
-    I2C_ReadData(0x50, 0, buffer, sizeof(CalibrationData_t));
+    /* Unsaved points are dropped even if nothing valid is stored. With the
+     * count at zero no reader looks at the points, so the DMA below fills
+     * them without holding the table */
+    Calibration_Lock();
+    calib_data.count = 0;
+    Calibration_Unlock();
+    
+    /* Header first, then only the points actually stored */
+    if (!FRAM_Read(FRAM_ADDR_CALIBRATION, &calib_header, sizeof(calib_header)))
+        return;
+    
+    bool v1 = (calib_header.magic == CALIBRATION_MAGIC_V1);
+    
+    if ((calib_header.magic != CALIBRATION_MAGIC && !v1) || calib_header.count > CALIBRATION_POINTS)
+        return;
+    
+    size_t point_size = v1 ? sizeof(CalibrationPointV1_t) : sizeof(CalibrationPoint_t);
+    if (calib_header.count > 0 &&
+        !FRAM_Read(CALIBRATION_POINTS_ADDR, calib_data.points, calib_header.count * point_size))
+        return;
+    
+    /* Old points are smaller: widen them in place, last one first */
+    for (int32_t i = (int32_t)calib_header.count - 1; v1 && i >= 0; i--)
+    {
+        CalibrationPointV1_t old;
+        
+        memcpy(&old, (const uint8_t*)calib_data.points + i * sizeof(old), sizeof(old));
+        calib_data.points[i].frequency = FREQUENCY_HZ(old.frequency_hz);
+        calib_data.points[i].power_correction = old.power_correction;
+        calib_data.points[i].temp_coefficient = old.temp_coefficient;
+    }
+    
+    Calibration_Lock();
+    calib_data.count = calib_header.count;
+    calib_data.timestamp = calib_header.timestamp;
+    Calibration_Unlock();
 }
 
-void Calibration_SaveToFRAM(void)
+bool Calibration_SaveToFRAM(void)
 {
-    // Save to FRAM via I2C
-    uint8_t buffer[sizeof(CalibrationData_t)];
-    I2C_WriteData(0x50, 0, buffer, sizeof(CalibrationData_t));
+    /* Invalidate, write the points and the rest of the header, then the
+     * magic on its own, so a torn save never leaves a valid magic over
+     * partial data. On failure the stored table stays invalid and the
+     * caller reports it; the table in RAM is kept for another try. The
+     * table is only edited from CommandTask, which is the caller here. */
+    calib_header.magic = 0;
+    if (!FRAM_Write(FRAM_ADDR_CALIBRATION, &calib_header.magic, sizeof(calib_header.magic)))
+        return false;
+    
+    if (calib_data.count > 0 &&
+        !FRAM_Write(CALIBRATION_POINTS_ADDR, calib_data.points,
+                    calib_data.count * sizeof(CalibrationPoint_t)))
+        return false;
+    
+    calib_header.count = calib_data.count;
+    calib_header.timestamp = calib_data.timestamp;
+    calib_header.reserved = 0;
+    if (!FRAM_Write(FRAM_ADDR_CALIBRATION + CALIBRATION_HEADER_BODY, &calib_header.count,
+                    sizeof(calib_header) - CALIBRATION_HEADER_BODY))
+        return false;
+    
+    calib_header.magic = CALIBRATION_MAGIC;
+    return FRAM_Write(FRAM_ADDR_CALIBRATION, &calib_header.magic, sizeof(calib_header.magic));
 }
 
-void Calibration_AddPoint(uint32_t freq, int8_t power, double temp)
+void Calibration_Clear(void)
 {
-    if (calib_data.count < CALIBRATION_POINTS)
+    /* RAM only - the stored table stays until CAL:SAVE */
+    Calibration_Lock();
+    calib_data.count = 0;
+    Calibration_Unlock();
+}
+
+bool Calibration_AddPoint(Frequency_t freq, int8_t power, double temp)
+{
+    uint32_t i = 0;
+    
+    Calibration_Lock();
+    
+    /* Keep the table sorted; a repeated frequency replaces its point */
+    while (i < calib_data.count && calib_data.points[i].frequency < freq)
+        i++;
+    
+    if (i == calib_data.count || calib_data.points[i].frequency != freq)
     {
-        calib_data.points[calib_data.count].frequency = freq;
-        calib_data.points[calib_data.count].power_correction = power;
-        calib_data.points[calib_data.count].temp_coefficient = temp;
+        if (calib_data.count >= CALIBRATION_POINTS)
+        {
+            Calibration_Unlock();
+            return false;
+        }
+        
+        memmove(&calib_data.points[i + 1], &calib_data.points[i],
+                (calib_data.count - i) * sizeof(CalibrationPoint_t));
         calib_data.count++;
     }
+    
+    calib_data.points[i].frequency = freq;
+    calib_data.points[i].power_correction = power;
+    calib_data.points[i].temp_coefficient = temp;
+    
+    Calibration_Unlock();
+    return true;
+}
+
+/**
+ * @brief Interpolate in the table (caller holds it)
+ */
+static int8_t Calibration_Interpolate(Frequency_t freq)
+{
+    const CalibrationPoint_t* points = calib_data.points;
+    uint32_t count = calib_data.count;
+    
+    if (count == 0)
+        return 0;
+    
+    /* Held flat outside the measured range */
+    if (freq <= points[0].frequency)
+        return points[0].power_correction;
+    if (freq >= points[count - 1].frequency)
+        return points[count - 1].power_correction;
+    
+    /* First point above freq */
+    uint32_t low = 0, high = count - 1;
+    while (high - low > 1)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (points[mid].frequency > freq)
+            high = mid;
+        else
+            low = mid;
+    }
+    
+    int32_t span = points[high].power_correction - points[low].power_correction;
+    int64_t width = (int64_t)(points[high].frequency - points[low].frequency);
+    int64_t offset = span * (int64_t)(freq - points[low].frequency);
+    
+    /* Rounded to the nearest step */
+    offset += (offset < 0) ? -(width / 2) : width / 2;
+    return (int8_t)(points[low].power_correction + offset / width);
 }
 
-int8_t Calibration_GetPowerCorrection(uint32_t freq)
+int8_t Calibration_GetPowerCorrection(Frequency_t freq)
 {
-    // Simple linear interpolation
-    return 0;
+    Calibration_Lock();
+    int8_t correction = Calibration_Interpolate(freq);
+    Calibration_Unlock();
+    
+    return correction;
+}
+
+int16_t Calibration_GetLevelCorrection(Frequency_t freq)
+{
+    int32_t correction = Calibration_GetPowerCorrection(freq);
+    
+    /* Correction steps to the nearest output level step */
+    correction += (correction < 0) ? -(CALIBRATION_LEVEL_STEPS / 2) : CALIBRATION_LEVEL_STEPS / 2;
+    return (int16_t)(correction / CALIBRATION_LEVEL_STEPS);
 }
 
 CalibrationData_t* Calibration_GetData(void)
 {
     return &calib_data;
-}
\ No newline at end of file
+}
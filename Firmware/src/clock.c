@@ -0,0 +1,275 @@
+/**
+ * Clock Tree Configuration for STM32H743
+ * HSI 64 MHz -> PLL1 (M=4, N=60, P=2) -> 480 MHz SYSCLK
+ */
+
+#include "clock.h"
+#include "attenuator.h"
+#include "fsk.h"
+#include "hal_timer.h"
+#include "hal_uart.h"
+#include "list_mode.h"
+#include "logger.h"
+#include "pulse.h"
+#include "recorder.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+/* FreeRTOS Includes */
+#include "FreeRTOS.h"
+
+/* MAX2871 SPI prescaler (see MAX2871_Init) */
+#define CLOCK_SPI_PRESCALER 4
+
+/* Regulator voltage scaling settles in well under this */
+#define CLOCK_VOS_TIMEOUT_MS 10
+
+/* Interrupts at or below TIM2/TIM5 (priority 1) are held off while the
+ * clocks move; the ADC protection at priority 0 stays live */
+#define CLOCK_SWITCH_BASEPRI (1UL << (8U - __NVIC_PRIO_BITS))
+
+static Clock_Profile_t clock_profile = CLOCK_PROFILE_LOW_POWER;
+
+/* Core cycle count at the SYSCLK switch of the last profile change */
+static uint32_t clock_switch_cycles = 0;
+
+/* ============================= */
+/* PROFILES                      */
+/* ============================= */
+
+/**
+ * @brief Bus dividers common to both profiles
+ * AXI/AHB = SYSCLK/2 at 480 MHz, every APB = HCLK/2
+ */
+static void Clock_FillBusConfig(RCC_ClkInitTypeDef* clk, uint32_t source, uint32_t hpre)
+{
+    clk->ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK |
+                     RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2 |
+                     RCC_CLOCKTYPE_D3PCLK1 | RCC_CLOCKTYPE_D1PCLK1;
+    clk->SYSCLKSource = source;
+    clk->SYSCLKDivider = RCC_SYSCLK_DIV1;
+    clk->AHBCLKDivider = hpre;
+    clk->APB3CLKDivider = RCC_APB3_DIV2;
+    clk->APB1CLKDivider = RCC_APB1_DIV2;
+    clk->APB2CLKDivider = RCC_APB2_DIV2;
+    clk->APB4CLKDivider = RCC_APB4_DIV2;
+}
+
+/**
+ * @brief Wait for the regulator to reach a new voltage scale
+ * Bounded by HAL_GetTick, like the HAL's own oscillator and PLL waits;
+ * the TIM2 timebase must be running.
+ */
+static bool Clock_WaitVoltage(void)
+{
+    uint32_t start = HAL_GetTick();
+    
+    while (!__HAL_PWR_GET_FLAG(PWR_FLAG_VOSRDY))
+    {
+        if ((HAL_GetTick() - start) > CLOCK_VOS_TIMEOUT_MS)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 480 MHz from PLL1 - voltage raised before the clock
+ */
+static bool Clock_ApplyPerformance(void)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+    
+    __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE0);
+    if (!Clock_WaitVoltage())
+        return false;
+    
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+    osc.HSIState = RCC_HSI_DIV1;
+    osc.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+    osc.PLL.PLLState = RCC_PLL_ON;
+    osc.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+    osc.PLL.PLLM = 4;
+    osc.PLL.PLLN = 60;
+    osc.PLL.PLLP = 2;
+    osc.PLL.PLLQ = 4;
+    osc.PLL.PLLR = 2;
+    osc.PLL.PLLRGE = RCC_PLL1VCIRANGE_3;
+    osc.PLL.PLLVCOSEL = RCC_PLL1VCOWIDE;
+    osc.PLL.PLLFRACN = 0;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+        return false;
+    
+    Clock_FillBusConfig(&clk, RCC_SYSCLKSOURCE_PLLCLK, RCC_HCLK_DIV2);
+    clock_switch_cycles = Timer_GetCycles();
+    return HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_4) == HAL_OK;
+}
+
+/**
+ * @brief 64 MHz straight from HSI - PLL stopped, voltage lowered after
+ */
+static bool Clock_ApplyLowPower(void)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+    
+    Clock_FillBusConfig(&clk, RCC_SYSCLKSOURCE_HSI, RCC_HCLK_DIV1);
+    clock_switch_cycles = Timer_GetCycles();
+    if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_1) != HAL_OK)
+        return false;
+    
+    osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    osc.PLL.PLLState = RCC_PLL_OFF;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+        return false;
+    
+    __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE3);
+    return Clock_WaitVoltage();
+}
+
+/**
+ * @brief Apply a profile to the core/bus clocks and re-time TIM2
+ * TIM2 counts at the wrong rate once the bus clock moves, so the time the
+ * change took is rebuilt from core cycles on either side of the SYSCLK
+ * switch (the PLL lock and VOS waits fall on the HSI side).
+ */
+static bool Clock_Apply(Clock_Profile_t profile)
+{
+    uint32_t old_hz = SystemCoreClock;
+    uint64_t start_us = Timer_GetMicros64();
+    uint32_t start_cycles = Timer_GetCycles();
+    
+    /* Unchanged if the profile fails before the switch: old and new rates
+     * are then the same */
+    clock_switch_cycles = start_cycles;
+    
+    bool ok = (profile == CLOCK_PROFILE_PERFORMANCE) ?
+              Clock_ApplyPerformance() : Clock_ApplyLowPower();
+    
+    uint32_t end_cycles = Timer_GetCycles();
+    
+    if (ok)
+        clock_profile = profile;
+    
+    SystemCoreClockUpdate();
+    
+    uint64_t elapsed_us = ((uint64_t)(clock_switch_cycles - start_cycles) * 1000000ULL) / old_hz +
+                          ((uint64_t)(end_cycles - clock_switch_cycles) * 1000000ULL) / SystemCoreClock;
+    Timer_Retime(start_us + elapsed_us);
+    
+    return ok;
+}
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Configure supply, kernel clocks and the initial profile
+ * Call with the timebase already running (Timer_Init), so the RCC and PLL
+ * timeouts count; TIM2 is re-timed to the new bus clocks here.
+ */
+void Clock_Init(Clock_Profile_t profile)
+{
+    RCC_PeriphCLKInitTypeDef periph = {0};
+    
+    /* SYSCFG holds the ODEN bit that VOS0 sets; without its clock the
+     * write is lost and the 480 MHz profile would run at VOS1 */
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+    
+    /* LDO supply, required before any VOS change */
+    HAL_PWREx_ConfigSupply(PWR_LDO_SUPPLY);
+    
+    /* Profile-independent kernel clocks (PER_CK = HSI) */
+    periph.PeriphClockSelection = RCC_PERIPHCLK_SPI123 | RCC_PERIPHCLK_USART234578 |
+                                  RCC_PERIPHCLK_I2C123 | RCC_PERIPHCLK_ADC |
+                                  RCC_PERIPHCLK_CKPER;
+    periph.CkperClockSelection = RCC_CLKPSOURCE_HSI;
+    periph.Spi123ClockSelection = RCC_SPI123CLKSOURCE_CLKP;
+    periph.Usart234578ClockSelection = RCC_USART234578CLKSOURCE_HSI;
+    periph.I2c123ClockSelection = RCC_I2C123CLKSOURCE_HSI;
+    periph.AdcClockSelection = RCC_ADCCLKSOURCE_CLKP;
+    HAL_RCCEx_PeriphCLKConfig(&periph);
+    
+    Clock_Apply(profile);
+}
+
+/* ============================= */
+/* RUNTIME SWITCHING             */
+/* ============================= */
+
+/**
+ * @brief Switch profile at runtime
+ * Kernel clocks are fixed, so only the timebases need re-timing. They are
+ * all re-timed before any timer interrupt runs again, so no ISR sees a
+ * timer counting on the old prescaler. Call from task context, with no
+ * scheduled commit, list run, FSK stream, power sweep or pulse running:
+ * those would still be re-clocked mid-run.
+ */
+bool Clock_SetProfile(Clock_Profile_t profile)
+{
+    if (profile == clock_profile)
+        return true;
+    
+    uint32_t basepri = __get_BASEPRI();
+    __set_BASEPRI_MAX(CLOCK_SWITCH_BASEPRI);
+    
+    bool ok = Clock_Apply(profile);
+    
+    /* TIM3/TIM4/TIM5/TIM6/TIM15 timing and the RTOS tick follow the new bus clocks */
+    Recorder_Retime();
+    ListMode_Retime();
+    bool pulse_exact = Pulse_Retime();
+    Fsk_Retime();
+    Attenuator_Retime();
+    SysTick->LOAD = (SystemCoreClock / configTICK_RATE_HZ) - 1;
+    SysTick->VAL = 0;
+    
+    __set_BASEPRI(basepri);
+    
+    if (!pulse_exact)
+        LOG_WARN("[Clock] Pulse timing clamped to %lu ps ticks\n", Pulse_GetStatus().resolution_ps);
+    
+    return ok;
+}
+
+/**
+ * @brief Get the active profile
+ */
+Clock_Profile_t Clock_GetProfile(void)
+{
+    return clock_profile;
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Clocks read back from RCC, core clock measured against TIM2
+ */
+Clock_Status_t Clock_GetStatus(void)
+{
+    Clock_Status_t status;
+    
+    status.profile = clock_profile;
+    status.sysclk_hz = HAL_RCC_GetSysClockFreq();
+    status.hclk_hz = HAL_RCC_GetHCLKFreq();
+    status.pclk1_hz = HAL_RCC_GetPCLK1Freq();
+    status.spi_sck_hz = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_SPI123) / CLOCK_SPI_PRESCALER;
+    status.uart_baud = UART_GetBaudRate();
+    
+    /* 1 ms of device time in core cycles */
+    uint32_t start_us = Timer_GetMicros();
+    while (Timer_GetMicros() == start_us)
+    {
+    }
+    start_us = Timer_GetMicros();
+    uint32_t start_cycles = Timer_GetCycles();
+    while ((Timer_GetMicros() - start_us) < 1000)
+    {
+    }
+    status.core_measured_hz = (Timer_GetCycles() - start_cycles) * 1000UL;
+    
+    return status;
+}
@@ -0,0 +1,31 @@
+/**
+ * CRC-16/CCITT
+ * Bitwise - the records it covers are small and written rarely
+ */
+
+#include "crc.h"
+
+/**
+ * @brief CRC of a buffer, starting from the initial value
+ */
+uint16_t CRC16_Compute(const void* data, uint32_t length)
+{
+    return CRC16_Update(0xFFFF, data, length);
+}
+
+/**
+ * @brief Continue a CRC over more data (for data arriving in pieces)
+ */
+uint16_t CRC16_Update(uint16_t crc, const void* data, uint32_t length)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    
+    return crc;
+}
@@ -0,0 +1,210 @@
+/**
+ * Response Formatter
+ * Two digits per division by 100 (a multiply on the M7), table lookup for
+ * the digit pair
+ */
+
+#include "fmt.h"
+#include <string.h>
+
+static const char fmt_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint32_t fmt_pow10[FMT_DECIMALS_MAX + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000
+};
+
+/* ============================= */
+/* CONVERSION                    */
+/* ============================= */
+
+/**
+ * @brief Write the decimal digits of value, most significant first
+ * @return Number of digits written (1 - FMT_U32_DIGITS)
+ */
+size_t Fmt_U32ToDec(char* digits, uint32_t value)
+{
+    char scratch[FMT_U32_DIGITS];
+    char* p = &scratch[FMT_U32_DIGITS];
+    
+    while (value >= 100)
+    {
+        uint32_t pair = value % 100;
+        
+        value /= 100;
+        p -= 2;
+        memcpy(p, &fmt_pairs[pair * 2], 2);
+    }
+    
+    if (value >= 10)
+    {
+        p -= 2;
+        memcpy(p, &fmt_pairs[value * 2], 2);
+    }
+    else
+    {
+        *--p = (char)('0' + value);
+    }
+    
+    size_t count = (size_t)(&scratch[FMT_U32_DIGITS] - p);
+    memcpy(digits, p, count);
+    return count;
+}
+
+/**
+ * @brief Append raw bytes, as many as fit
+ */
+static void Fmt_Append(Fmt_Buffer_t* out, const char* data, size_t count)
+{
+    size_t room = out->size - out->length;
+    
+    if (count > room)
+    {
+        count = room;
+        out->overflow = true;
+    }
+    
+    memcpy(&out->data[out->length], data, count);
+    out->length += count;
+}
+
+/**
+ * @brief Append value zero-padded to exactly width digits (width <= 9)
+ */
+void Fmt_U32Padded(Fmt_Buffer_t* out, uint32_t value, uint8_t width)
+{
+    char digits[FMT_U32_DIGITS];
+    char zeros[FMT_U32_DIGITS];
+    size_t count = Fmt_U32ToDec(digits, value);
+    
+    if (count < width)
+    {
+        memset(zeros, '0', width - count);
+        Fmt_Append(out, zeros, width - count);
+    }
+    Fmt_Append(out, digits, count);
+}
+
+/**
+ * @brief Append magnitude / 10^decimals with all the decimals
+ */
+static void Fmt_Scaled(Fmt_Buffer_t* out, bool negative, uint64_t magnitude, uint8_t decimals)
+{
+    if (decimals > FMT_DECIMALS_MAX)
+        decimals = FMT_DECIMALS_MAX;
+    
+    if (negative)
+        Fmt_Char(out, '-');
+    
+    if (decimals == 0)
+    {
+        Fmt_U64(out, magnitude);
+        return;
+    }
+    
+    Fmt_U64(out, magnitude / fmt_pow10[decimals]);
+    Fmt_Char(out, '.');
+    Fmt_U32Padded(out, (uint32_t)(magnitude % fmt_pow10[decimals]), decimals);
+}
+
+/* ============================= */
+/* REPLY BUILDING                */
+/* ============================= */
+
+/**
+ * @brief Start an empty reply in data
+ */
+void Fmt_Init(Fmt_Buffer_t* out, char* data, size_t size)
+{
+    out->data = data;
+    out->size = size;
+    out->length = 0;
+    out->overflow = false;
+}
+
+void Fmt_Char(Fmt_Buffer_t* out, char c)
+{
+    Fmt_Append(out, &c, 1);
+}
+
+void Fmt_Str(Fmt_Buffer_t* out, const char* str)
+{
+    Fmt_Append(out, str, strlen(str));
+}
+
+void Fmt_U32(Fmt_Buffer_t* out, uint32_t value)
+{
+    char digits[FMT_U32_DIGITS];
+    
+    Fmt_Append(out, digits, Fmt_U32ToDec(digits, value));
+}
+
+void Fmt_I32(Fmt_Buffer_t* out, int32_t value)
+{
+    if (value < 0)
+    {
+        Fmt_Char(out, '-');
+        Fmt_U32(out, 0U - (uint32_t)value);
+    }
+    else
+    {
+        Fmt_U32(out, (uint32_t)value);
+    }
+}
+
+/**
+ * @brief 64-bit values in 9-digit pieces - one 64-bit division for
+ * anything below 10^18 (frequencies take one at most)
+ */
+void Fmt_U64(Fmt_Buffer_t* out, uint64_t value)
+{
+    if (value <= UINT32_MAX)
+    {
+        Fmt_U32(out, (uint32_t)value);
+        return;
+    }
+    
+    uint64_t high = value / 1000000000U;
+    uint32_t low = (uint32_t)(value - high * 1000000000U);
+    
+    Fmt_U64(out, high);
+    Fmt_U32Padded(out, low, 9);
+}
+
+void Fmt_Fixed(Fmt_Buffer_t* out, int32_t value, uint8_t decimals)
+{
+    bool negative = value < 0;
+    
+    Fmt_Scaled(out, negative, negative ? 0U - (uint32_t)value : (uint32_t)value, decimals);
+}
+
+/**
+ * @brief Scaled and rounded in the FPU, then printed as an integer
+ * Values too large for 64 bits print as "ovf", NaN as "nan".
+ */
+void Fmt_Double(Fmt_Buffer_t* out, double value, uint8_t decimals)
+{
+    if (decimals > FMT_DECIMALS_MAX)
+        decimals = FMT_DECIMALS_MAX;
+    
+    if (value != value)
+    {
+        Fmt_Str(out, "nan");
+        return;
+    }
+    
+    bool negative = value < 0.0;
+    double scaled = (negative ? -value : value) * fmt_pow10[decimals] + 0.5;
+    
+    if (scaled >= 18446744073709551616.0)
+    {
+        Fmt_Str(out, "ovf");
+        return;
+    }
+    
+    Fmt_Scaled(out, negative, (uint64_t)scaled, decimals);
+}
@@ -0,0 +1,245 @@
+/**
+ * FRAM Driver
+ * Chunked DMA transfers chained from the I2C completion interrupt
+ */
+
+#include "fram.h"
+#include "hal_i2c.h"
+#include "hal_timer.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+/* FreeRTOS */
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+/* Timeout per blocking transfer, generous for 32 KB at 1 MHz */
+#define FRAM_TIMEOUT_MS 500
+
+/* Transfer state - advanced from the I2C completion ISR */
+static volatile bool fram_busy = false;
+static volatile bool fram_error = false;
+static volatile bool fram_writing = false;
+static volatile uint16_t fram_addr = 0;
+static uint8_t * volatile fram_data = NULL;
+static volatile uint32_t fram_remaining = 0;
+
+/* Held across a blocking transfer, so tasks queue instead of failing */
+static SemaphoreHandle_t fram_mutex = NULL;
+static StaticSemaphore_t fram_mutex_buffer;
+
+/* Given by the completion ISR; a waiting task blocks on it */
+static SemaphoreHandle_t fram_done = NULL;
+static StaticSemaphore_t fram_done_buffer;
+
+static bool FRAM_StartChunk(void);
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Initialize FRAM driver (I2C must be initialized)
+ */
+void FRAM_Init(void)
+{
+    fram_busy = false;
+    fram_error = false;
+    fram_mutex = xSemaphoreCreateMutexStatic(&fram_mutex_buffer);
+    fram_done = xSemaphoreCreateBinaryStatic(&fram_done_buffer);
+}
+
+/* ============================= */
+/* LOCKING                       */
+/* ============================= */
+
+/**
+ * @brief Take the FRAM for a sequence of transfers
+ * Before the scheduler starts there is only one caller - always granted.
+ * @return false if another task held it for timeout_ms
+ */
+bool FRAM_Lock(uint32_t timeout_ms)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+        return true;
+    
+    return xSemaphoreTake(fram_mutex, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+/**
+ * @brief Release the FRAM taken by FRAM_Lock()
+ */
+void FRAM_Unlock(void)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+        xSemaphoreGive(fram_mutex);
+}
+
+/* ============================= */
+/* CHUNKED TRANSFERS             */
+/* ============================= */
+
+/**
+ * @brief End the current transfer and wake its waiter (I2C ISR)
+ */
+static void FRAM_Finish(bool success)
+{
+    BaseType_t higher_priority_woken = pdFALSE;
+    
+    if (!success)
+        fram_error = true;
+    fram_busy = false;
+    
+    xSemaphoreGiveFromISR(fram_done, &higher_priority_woken);
+    portYIELD_FROM_ISR(higher_priority_woken);
+}
+
+/**
+ * @brief Chunk completion - start the next chunk or finish
+ */
+static void FRAM_ChunkComplete(bool success)
+{
+    if (!success || fram_remaining == 0)
+    {
+        FRAM_Finish(success);
+        return;
+    }
+    
+    if (!FRAM_StartChunk())
+        FRAM_Finish(false);
+}
+
+/**
+ * @brief Start DMA for the next chunk of the current transfer
+ */
+static bool FRAM_StartChunk(void)
+{
+    uint16_t len = (fram_remaining > FRAM_CHUNK_SIZE) ?
+                   FRAM_CHUNK_SIZE : (uint16_t)fram_remaining;
+    uint16_t addr = fram_addr;
+    uint8_t *data = fram_data;
+    
+    fram_addr = (uint16_t)(addr + len);
+    fram_data = data + len;
+    fram_remaining -= len;
+    
+    if (fram_writing)
+        return I2C_MemWriteDMA(FRAM_I2C_ADDR, addr, data, len, FRAM_ChunkComplete);
+    
+    return I2C_MemReadDMA(FRAM_I2C_ADDR, addr, data, len, FRAM_ChunkComplete);
+}
+
+/**
+ * @brief Start a transfer
+ */
+static bool FRAM_Start(uint16_t addr, uint8_t *data, uint32_t len, bool write)
+{
+    if (fram_busy || len == 0 || (uint32_t)addr + len > FRAM_SIZE)
+        return false;
+    
+    /* Drop a completion left over from a transfer that timed out */
+    xSemaphoreTake(fram_done, 0);
+    
+    fram_addr = addr;
+    fram_data = data;
+    fram_remaining = len;
+    fram_writing = write;
+    fram_error = false;
+    fram_busy = true;
+    
+    if (!FRAM_StartChunk())
+    {
+        fram_busy = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Start reading FRAM directly into a DMA-accessible destination
+ */
+bool FRAM_ReadAsync(uint16_t addr, void *data, uint32_t len)
+{
+    return FRAM_Start(addr, (uint8_t *)data, len, false);
+}
+
+/**
+ * @brief Start writing a DMA-accessible object to FRAM
+ */
+bool FRAM_WriteAsync(uint16_t addr, const void *data, uint32_t len)
+{
+    return FRAM_Start(addr, (uint8_t *)data, len, true);
+}
+
+/**
+ * @brief Wait for the current transfer
+ * A task blocks until the completion ISR gives fram_done; before the
+ * scheduler starts (boot reads), or with it suspended, the core sleeps
+ * between interrupts instead.
+ * @return true if it completed without error
+ */
+bool FRAM_Wait(uint32_t timeout_ms)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+    {
+        if (fram_busy)
+            xSemaphoreTake(fram_done, pdMS_TO_TICKS(timeout_ms));
+    }
+    else
+    {
+        uint32_t start = Timer_GetMicros();
+        
+        while (fram_busy && (Timer_GetMicros() - start) < timeout_ms * 1000UL)
+            __WFI();
+    }
+    
+    if (fram_busy)
+    {
+        I2C_Abort(FRAM_I2C_ADDR);
+        fram_busy = false;
+        fram_error = true;
+    }
+    
+    return !fram_error;
+}
+
+/**
+ * @brief Check if a transfer is in progress
+ */
+bool FRAM_IsBusy(void)
+{
+    return fram_busy;
+}
+
+/* ============================= */
+/* BLOCKING WRAPPERS             */
+/* ============================= */
+
+/**
+ * @brief Read FRAM (blocking, bounded by the lock wait and FRAM_TIMEOUT_MS)
+ */
+bool FRAM_Read(uint16_t addr, void *data, uint32_t len)
+{
+    if (!FRAM_Lock(FRAM_LOCK_TIMEOUT_MS))
+        return false;
+    
+    bool ok = FRAM_ReadAsync(addr, data, len) && FRAM_Wait(FRAM_TIMEOUT_MS);
+    
+    FRAM_Unlock();
+    return ok;
+}
+
+/**
+ * @brief Write FRAM (blocking, bounded by the lock wait and FRAM_TIMEOUT_MS)
+ */
+bool FRAM_Write(uint16_t addr, const void *data, uint32_t len)
+{
+    if (!FRAM_Lock(FRAM_LOCK_TIMEOUT_MS))
+        return false;
+    
+    bool ok = FRAM_WriteAsync(addr, data, len) && FRAM_Wait(FRAM_TIMEOUT_MS);
+    
+    FRAM_Unlock();
+    return ok;
+}
@@ -0,0 +1,153 @@
+/**
+ * Frequency Representation
+ * Divisions by the powers of ten the conversions need are done as a
+ * multiply by the rounded-up reciprocal, taking the high 64 bits of the
+ * 128-bit product (four 32x32 multiplies). The constants are the usual
+ * round-up magic numbers and are exact for every 64-bit input.
+ */
+
+#include "frequency.h"
+
+/* Largest hertz value whose Frequency_t still fits 64 bits */
+#define FREQUENCY_MAX_HZ    (UINT64_MAX / FREQUENCY_UNITS_PER_HZ)
+
+static const uint16_t frequency_scale[FREQUENCY_DECIMALS + 1] = { 1000, 100, 10, 1 };
+
+/* ============================= */
+/* CONVERSION                    */
+/* ============================= */
+
+/**
+ * @brief High 64 bits of a * b
+ */
+static uint64_t Frequency_MulHigh(uint64_t a, uint64_t b)
+{
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+/**
+ * @brief Whole hertz, truncated (frequency / 1000)
+ */
+uint64_t Frequency_ToHz(Frequency_t frequency)
+{
+    return Frequency_MulHigh(frequency >> 3, 0x20C49BA5E353F7CFULL) >> 4;
+}
+
+/**
+ * @brief Whole kilohertz, truncated (frequency / 10^6) - for log records,
+ * whose arguments are 32-bit
+ */
+uint32_t Frequency_ToKHz(Frequency_t frequency)
+{
+    return (uint32_t)(Frequency_MulHigh(frequency, 0x431BDE82D7B634DBULL) >> 18);
+}
+
+/* ============================= */
+/* PROTOCOL TEXT                 */
+/* ============================= */
+
+/**
+ * @brief Parse decimal hertz with up to FREQUENCY_DECIMALS places
+ * Leading spaces are skipped, as strtoul does.
+ * @param end First character after the number (may be NULL)
+ * @return false if there are no digits, too many decimals or the value
+ * does not fit; *end is then text
+ */
+bool Frequency_Parse(const char* text, char** end, Frequency_t* frequency)
+{
+    const char* p = text;
+    uint64_t hz = 0;
+    uint32_t fraction = 0;
+    uint8_t decimals = 0;
+    
+    while (*p == ' ')
+        p++;
+    
+    if (*p < '0' || *p > '9')
+        goto invalid;
+    
+    while (*p >= '0' && *p <= '9')
+    {
+        if (hz > (FREQUENCY_MAX_HZ - 9) / 10)
+            goto invalid;
+        hz = hz * 10 + (uint32_t)(*p++ - '0');
+    }
+    
+    if (*p == '.')
+    {
+        p++;
+        while (*p >= '0' && *p <= '9')
+        {
+            if (decimals == FREQUENCY_DECIMALS)
+                goto invalid;
+            fraction = fraction * 10 + (uint32_t)(*p++ - '0');
+            decimals++;
+        }
+    }
+    
+    *frequency = FREQUENCY_HZ(hz) + fraction * frequency_scale[decimals];
+    if (end != NULL)
+        *end = (char*)p;
+    return true;
+    
+invalid:
+    if (end != NULL)
+        *end = (char*)text;
+    return false;
+}
+
+/**
+ * @brief Append the text form; only the decimals needed are printed
+ * ("2400000000", "5800000000.125", "10000000.5")
+ */
+void Frequency_Format(Fmt_Buffer_t* out, Frequency_t frequency)
+{
+    uint64_t hz = Frequency_ToHz(frequency);
+    uint32_t fraction = (uint32_t)(frequency - FREQUENCY_HZ(hz));
+    uint8_t decimals = FREQUENCY_DECIMALS;
+    
+    if (hz <= UINT32_MAX)
+    {
+        Fmt_U32(out, (uint32_t)hz);
+    }
+    else
+    {
+        /* hz / 10^9, then the low nine digits */
+        uint32_t giga = (uint32_t)(Frequency_MulHigh(hz >> 9, 0x44B82FA09B5A53ULL) >> 11);
+        
+        Fmt_U32(out, giga);
+        Fmt_U32Padded(out, (uint32_t)(hz - (uint64_t)giga * 1000000000U), 9);
+    }
+    
+    if (fraction == 0)
+        return;
+    
+    while (fraction % 10 == 0)
+    {
+        fraction /= 10;
+        decimals--;
+    }
+    Fmt_Char(out, '.');
+    Fmt_U32Padded(out, fraction, decimals);
+}
+
+/**
+ * @brief Text form into a FREQUENCY_TEXT_SIZE buffer, for printf replies
+ * @return text
+ */
+const char* Frequency_ToText(Frequency_t frequency, char* text)
+{
+    Fmt_Buffer_t out;
+    
+    Fmt_Init(&out, text, FREQUENCY_TEXT_SIZE - 1);
+    Frequency_Format(&out, frequency);
+    text[out.length] = '\0';
+    return text;
+}
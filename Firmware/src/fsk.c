@@ -0,0 +1,384 @@
+/**
+ * FSK Modulation for STM32H743
+ * TIM3 update -> DMA2 Stream 1 -> SPI1 TXDR, one R0 word per symbol
+ */
+
+#include "fsk.h"
+#include "hal_timer.h"
+#include "hal_uart.h"
+#include "main.h"
+#include "max2871.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+#define FSK_FIFO_MASK       (FSK_FIFO_SYMBOLS - 1)
+#define FSK_BUFFER_SYMBOLS  (2 * FSK_HALF_SYMBOLS)
+#define FSK_TIMER_SPAN      65536UL
+
+static DMA_HandleTypeDef hdma_fsk;
+
+/* Tones - R0 word per symbol value; unused values repeat tone 0 */
+static Frequency_t fsk_frequency[FSK_TONES_MAX];
+static uint32_t fsk_word[FSK_TONES_MAX];
+static uint32_t fsk_tones = 0;
+static uint32_t fsk_max_error_hz = 0;
+static MAX2871_Registers_t fsk_image;
+
+/* Symbol FIFO - task writes head, the refill ISR advances tail */
+static uint8_t fsk_fifo[FSK_FIFO_SYMBOLS];
+static volatile uint32_t fsk_head = 0;
+static volatile uint32_t fsk_tail = 0;
+
+/* DMA source (non-cacheable) and the symbol behind each word */
+static uint32_t fsk_buffer[FSK_BUFFER_SYMBOLS] DMA_BUFFER;
+static uint8_t fsk_buffer_symbol[FSK_BUFFER_SYMBOLS];
+static uint8_t fsk_last_symbol = 0;
+
+/* Symbol clock */
+static uint32_t fsk_rate_hz = 1000;
+static uint32_t fsk_prescaler = 0;
+static uint32_t fsk_period = 0;
+
+static volatile bool fsk_running = false;
+static bool fsk_streaming = false;
+static volatile uint32_t fsk_symbols = 0;
+static volatile uint32_t fsk_underruns = 0;
+static volatile uint32_t fsk_refill_cycles = 0;
+static uint32_t fsk_stop_symbol = 0;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Enable TIM3 and the DMA stream; nothing runs until Fsk_Start()
+ */
+void Fsk_Init(void)
+{
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    
+    TIM3->CR1 = 0;
+    TIM3->DIER = 0;
+    
+    hdma_fsk.Instance = DMA2_Stream1;
+    hdma_fsk.Init.Request = DMA_REQUEST_TIM3_UP;
+    hdma_fsk.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_fsk.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_fsk.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_fsk.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_fsk.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_fsk.Init.Mode = DMA_CIRCULAR;
+    hdma_fsk.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_fsk.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    HAL_DMA_Init(&hdma_fsk);
+    
+    /* Above the RTOS - the refill must beat the DMA to the next half */
+    HAL_NVIC_SetPriority(DMA2_Stream1_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+    
+    Fsk_Retime();
+}
+
+/**
+ * @brief Timer prescaler and period for the symbol rate
+ * The prescaler is the smallest that fits the period in 16 bits.
+ */
+static void Fsk_Solve(uint32_t rate_hz, uint32_t* prescaler, uint32_t* period)
+{
+    uint32_t ticks = (Timer_GetClockHz() + rate_hz / 2) / rate_hz;
+    
+    *prescaler = (ticks - 1) / FSK_TIMER_SPAN;
+    *period = (ticks + *prescaler / 2) / (*prescaler + 1);
+}
+
+/**
+ * @brief Reload the symbol clock after a bus clock or rate change
+ * Both registers are buffered; a running stream changes rate at the next
+ * symbol boundary.
+ */
+void Fsk_Retime(void)
+{
+    Fsk_Solve(fsk_rate_hz, &fsk_prescaler, &fsk_period);
+    
+    TIM3->PSC = fsk_prescaler;
+    TIM3->ARR = fsk_period - 1;
+}
+
+/* ============================= */
+/* CONFIGURATION                 */
+/* ============================= */
+
+/**
+ * @brief Solve the tone set (not while running)
+ * @return false if any tone is out of range or needs another output divider
+ */
+bool Fsk_SetTones(const Frequency_t* frequency, uint32_t count)
+{
+    if (fsk_running || count < 2 || count > FSK_TONES_MAX)
+        return false;
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (frequency[i] < RF_FREQ_MIN || frequency[i] > RF_FREQ_MAX)
+            return false;
+    }
+    
+    if (!MAX2871_SolveTones(frequency, count, &fsk_image, fsk_word, &fsk_max_error_hz))
+    {
+        fsk_tones = 0;
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < FSK_TONES_MAX; i++)
+    {
+        fsk_frequency[i] = (i < count) ? frequency[i] : frequency[0];
+        if (i >= count)
+            fsk_word[i] = fsk_word[0];
+    }
+    fsk_tones = count;
+    return true;
+}
+
+/**
+ * @brief Fastest symbol rate: one R0 word per symbol on the SPI
+ */
+uint32_t Fsk_GetMaxRate(void)
+{
+    return 1000000000UL / MAX2871_GetStreamWordNs();
+}
+
+/**
+ * @brief Set the symbol rate (applied at the next symbol when running)
+ */
+bool Fsk_SetRate(uint32_t rate_hz)
+{
+    if (rate_hz < FSK_RATE_MIN || rate_hz > Fsk_GetMaxRate())
+        return false;
+    
+    fsk_rate_hz = rate_hz;
+    Fsk_Retime();
+    return true;
+}
+
+/* ============================= */
+/* SYMBOL STREAM                 */
+/* ============================= */
+
+/**
+ * @brief Free FIFO space in symbols
+ */
+uint32_t Fsk_GetFree(void)
+{
+    return FSK_FIFO_SYMBOLS - (fsk_head - fsk_tail);
+}
+
+/**
+ * @brief Queue packed symbols (two per byte, low nibble first)
+ * @return Bytes taken; stops short when the FIFO is full
+ */
+size_t Fsk_Write(const uint8_t* data, size_t length)
+{
+    uint32_t head = fsk_head;
+    size_t i;
+    
+    for (i = 0; i < length && (FSK_FIFO_SYMBOLS - (head - fsk_tail)) >= 2; i++)
+    {
+        fsk_fifo[head & FSK_FIFO_MASK] = data[i] & 0x0F;
+        fsk_fifo[(head + 1) & FSK_FIFO_MASK] = data[i] >> 4;
+        head += 2;
+    }
+    
+    /* Symbols are in place before the ISR can see the new head */
+    __DMB();
+    fsk_head = head;
+    return i;
+}
+
+/**
+ * @brief Expand one half of the DMA buffer from the FIFO
+ * An empty FIFO holds the last symbol.
+ */
+static void Fsk_Refill(uint32_t half)
+{
+    uint32_t start = Timer_GetCycles();
+    uint32_t tail = fsk_tail;
+    uint32_t available = fsk_head - tail;
+    uint32_t* words = &fsk_buffer[half * FSK_HALF_SYMBOLS];
+    uint8_t* symbols = &fsk_buffer_symbol[half * FSK_HALF_SYMBOLS];
+    uint8_t symbol = fsk_last_symbol;
+    
+    for (uint32_t i = 0; i < FSK_HALF_SYMBOLS; i++)
+    {
+        if (available > 0)
+        {
+            symbol = fsk_fifo[tail & FSK_FIFO_MASK];
+            tail++;
+            available--;
+        }
+        else
+        {
+            fsk_underruns++;
+        }
+        words[i] = fsk_word[symbol];
+        symbols[i] = symbol;
+    }
+    
+    fsk_last_symbol = symbol;
+    fsk_tail = tail;
+    fsk_symbols += FSK_HALF_SYMBOLS;
+    fsk_refill_cycles = Timer_GetCycles() - start;
+}
+
+/* ============================= */
+/* EXECUTION                     */
+/* ============================= */
+
+/**
+ * @brief Lock on the first tone and start the symbol clock
+ * The tones are solved again first, so the power mode and VCO band table
+ * in effect now are the ones used.
+ * @return false without tones, or if the PLL did not lock
+ */
+bool Fsk_Start(void)
+{
+    uint32_t max_error_hz;
+    
+    if (fsk_running || fsk_tones == 0)
+        return false;
+    
+    if (!MAX2871_SolveTones(fsk_frequency, fsk_tones, &fsk_image, fsk_word, &max_error_hz) ||
+        !MAX2871_BeginStream(&fsk_image))
+    {
+        return false;
+    }
+    fsk_streaming = true;
+    
+    fsk_last_symbol = 0;
+    fsk_symbols = 0;
+    fsk_underruns = 0;
+    Fsk_Refill(0);
+    Fsk_Refill(1);
+    
+    HAL_DMA_Start(&hdma_fsk, (uint32_t)fsk_buffer, (uint32_t)MAX2871_GetStreamRegister(),
+                  FSK_BUFFER_SYMBOLS);
+    __HAL_DMA_ENABLE_IT(&hdma_fsk, DMA_IT_HT | DMA_IT_TC);
+    
+    fsk_running = true;
+    
+    /* First word goes out one symbol period from now */
+    TIM3->CR1 = TIM_CR1_URS | TIM_CR1_ARPE;
+    Fsk_Retime();
+    TIM3->CNT = 0;
+    TIM3->EGR = TIM_EGR_UG;
+    TIM3->SR = 0;
+    TIM3->DIER = TIM_DIER_UDE;
+    TIM3->CR1 = TIM_CR1_URS | TIM_CR1_ARPE | TIM_CR1_CEN;
+    return true;
+}
+
+/**
+ * @brief Stop the symbol clock; the output stays on the last tone
+ * Symbols still queued are discarded. SPI1 stays with the stream until
+ * Fsk_Release().
+ */
+void Fsk_Stop(void)
+{
+    if (!fsk_running)
+        return;
+    
+    TIM3->CR1 &= ~TIM_CR1_CEN;
+    TIM3->DIER = 0;
+    
+    /* Index of the last word the DMA wrote */
+    uint32_t remaining = __HAL_DMA_GET_COUNTER(&hdma_fsk);
+    uint32_t sent = (2 * FSK_BUFFER_SYMBOLS - remaining - 1) % FSK_BUFFER_SYMBOLS;
+    
+    HAL_DMA_Abort(&hdma_fsk);
+    HAL_NVIC_ClearPendingIRQ(DMA2_Stream1_IRQn);
+    
+    fsk_stop_symbol = fsk_buffer_symbol[sent];
+    fsk_tail = fsk_head;
+    fsk_running = false;
+}
+
+/**
+ * @brief Hand SPI1 back to the register driver after Fsk_Stop()
+ */
+void Fsk_Release(void)
+{
+    if (fsk_running || !fsk_streaming)
+        return;
+    
+    MAX2871_EndStream(fsk_frequency[fsk_stop_symbol]);
+    fsk_streaming = false;
+}
+
+/**
+ * @brief Check whether the symbol clock is running
+ */
+bool Fsk_IsRunning(void)
+{
+    return fsk_running;
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get configuration and stream status
+ */
+Fsk_Status_t Fsk_GetStatus(void)
+{
+    Fsk_Status_t status;
+    uint32_t ticks = (fsk_prescaler + 1) * fsk_period;
+    
+    status.running = fsk_running;
+    status.tones = fsk_tones;
+    status.max_error_hz = fsk_max_error_hz;
+    status.rate_hz = (Timer_GetClockHz() + ticks / 2) / ticks;
+    status.max_rate_hz = Fsk_GetMaxRate();
+    status.link_rate_hz = UART_GetBaudRate() / 10 * 2;
+    status.buffered = fsk_head - fsk_tail;
+    status.symbols = fsk_symbols;
+    status.underruns = fsk_underruns;
+    status.refill_cycles = fsk_refill_cycles;
+    status.cpu_permille = (uint32_t)(((uint64_t)status.refill_cycles * status.rate_hz * 1000) /
+                                     ((uint64_t)FSK_HALF_SYMBOLS * SystemCoreClock));
+    
+    if (fsk_running)
+    {
+        uint32_t remaining = __HAL_DMA_GET_COUNTER(&hdma_fsk);
+        uint32_t sent = (2 * FSK_BUFFER_SYMBOLS - remaining - 1) % FSK_BUFFER_SYMBOLS;
+        status.frequency = fsk_frequency[fsk_buffer_symbol[sent]];
+    }
+    else
+    {
+        status.frequency = fsk_frequency[fsk_stop_symbol];
+    }
+    return status;
+}
+
+/* ============================= */
+/* INTERRUPT HANDLER             */
+/* ============================= */
+
+/**
+ * @brief DMA2 Stream 1 Interrupt Handler - refill the half just sent
+ */
+void DMA2_Stream1_IRQHandler(void)
+{
+    uint32_t flags = DMA2->LISR;
+    
+    if (flags & DMA_LISR_HTIF1)
+    {
+        DMA2->LIFCR = DMA_LIFCR_CHTIF1;
+        Fsk_Refill(0);
+    }
+    if (flags & DMA_LISR_TCIF1)
+    {
+        DMA2->LIFCR = DMA_LIFCR_CTCIF1;
+        Fsk_Refill(1);
+    }
+}
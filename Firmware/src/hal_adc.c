@@ -4,13 +4,20 @@
  */
 
 #include "hal_adc.h"
+#include "hal_gpio.h"
+#include "hal_timer.h"
+#include "logger.h"
+#include "main.h"
 #include "stm32h743xx.h"
 #include "stm32h7xx_hal.h"
-#include <stdio.h>
 #include <math.h>
 
 /* ADC Handle */
 static ADC_HandleTypeDef hadc;
+static DMA_HandleTypeDef hdma_adc;
+
+/* Latest code of each scan rank, kept current by circular DMA */
+static volatile uint16_t adc_raw[ADC_RAW_COUNT] DMA_BUFFER;
 
 /* Calibration constants */
 #define ADC_REF_VOLTAGE 3.3
@@ -27,17 +34,45 @@ static ADC_HandleTypeDef hadc;
 /* Current sensing: 0.1 Ohm shunt = 100mV per Amp */
 #define CURRENT_GAIN 10.0
 
+/* Engineering units -> raw 12-bit ADC codes for the analog watchdogs */
+#define ADC_MV_TO_RAW(mv)   ((uint32_t)(((mv) / (ADC_REF_VOLTAGE * 1000.0)) * ADC_RESOLUTION))
+#define TEMP_TO_MV(t)       (TEMP_SENSOR_OFFSET_25 - ((t) - TEMP_25_CELSIUS) * TEMP_SENSOR_SLOPE)
+#define CURRENT_TO_MV(a)    ((a) * 1000.0 / CURRENT_GAIN)
+
+#define AWD_TEMP_TRIP       ADC_MV_TO_RAW(TEMP_TO_MV(TEMP_SHUTDOWN))
+#define AWD_TEMP_RECOVER    ADC_MV_TO_RAW(TEMP_TO_MV(TEMP_RECOVER))
+#define AWD_CURR_TRIP       ADC_MV_TO_RAW(CURRENT_TO_MV(CURRENT_SHUTDOWN))
+#define AWD_CURR_RECOVER    ADC_MV_TO_RAW(CURRENT_TO_MV(CURRENT_RECOVER))
+#define AWD_RAW_MAX         0xFFFUL
+
+/* Offset + linearity calibration takes well under this */
+#define ADC_CALIBRATION_TIMEOUT_US 20000UL
+
+/* Protection state - written from the ADC ISR */
+static volatile uint8_t fault_latched = ADC_FAULT_NONE;
+static volatile uint8_t fault_active = ADC_FAULT_NONE;
+static volatile uint32_t fault_trips = 0;
+
+static bool adc_calibrated = false;
+
+static void ADC_ConfigWatchdog(uint32_t watchdog, uint32_t channel, uint32_t high);
+static void ADC_HandleWatchdog(uint32_t awd, uint8_t fault,
+                               uint32_t trip, uint32_t recover);
+
 /* ============================= */
 /* INITIALIZATION                */
 /* ============================= */
 
 /**
- * @brief Initialize ADC
+ * @brief Initialize ADC and start self-calibration
+ *
+ * Calibration runs in hardware while the caller brings up other
+ * peripherals; ADC_StartConversion() completes it.
  */
 void ADC_Init(void)
 {
     hadc.Instance = ADC1;
-    hadc.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
+    hadc.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV4;     /* 64 MHz HSI kernel / 4, any clock profile */
     hadc.Init.Resolution = ADC_RESOLUTION_12B;
     hadc.Init.ScanConvMode = ADC_SCAN_ENABLE;
     hadc.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
@@ -47,7 +82,7 @@ void ADC_Init(void)
     hadc.Init.DiscontinuousConvMode = DISABLE;
     hadc.Init.ExternalTrigConv = ADC_SOFTWARE_START;
     hadc.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
-    hadc.Init.DMAContinuousRequests = DISABLE;
+    hadc.Init.ConversionDataManagement = ADC_CONVERSIONDATA_DMA_CIRCULAR;
     hadc.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
     hadc.Init.LeftAlignment = ADC_LEFTALGN_DISABLE;
     
@@ -79,7 +114,38 @@ void ADC_Init(void)
     __HAL_ADC_ENABLE_TEMP_SENSOR();
     __HAL_ADC_ENABLE_VREF();
     
-    printf("ADC initialized\n");
+    /**
+     * Hardware protection: AWD2 watches temperature, AWD3 watches current.
+     * The ISR cuts RF as soon as a conversion leaves the window, so
+     * protection latency does not depend on any task's polling period.
+     */
+    ADC_ConfigWatchdog(ADC_ANALOGWATCHDOG_2, ADC_CHANNEL_10, AWD_TEMP_TRIP);
+    ADC_ConfigWatchdog(ADC_ANALOGWATCHDOG_3, ADC_CHANNEL_12, AWD_CURR_TRIP);
+    
+    /* Watchdogs only compare while converting - caller starts them */
+    adc_calibrated = false;
+    LL_ADC_StartCalibration(hadc.Instance, LL_ADC_CALIB_OFFSET_LINEARITY, LL_ADC_SINGLE_ENDED);
+    
+    LOG_INFO("ADC initialized\n");
+}
+
+/**
+ * @brief Arm an analog watchdog on a single channel
+ * @param watchdog ADC_ANALOGWATCHDOG_2 or ADC_ANALOGWATCHDOG_3
+ * @param channel Monitored ADC channel
+ * @param high Raw trip threshold
+ */
+static void ADC_ConfigWatchdog(uint32_t watchdog, uint32_t channel, uint32_t high)
+{
+    ADC_AnalogWDGConfTypeDef sWdg = {0};
+    
+    sWdg.WatchdogNumber = watchdog;
+    sWdg.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG;
+    sWdg.Channel = channel;
+    sWdg.ITMode = ENABLE;
+    sWdg.HighThreshold = high;
+    sWdg.LowThreshold = 0;
+    HAL_ADC_AnalogWDGConfig(&hadc, &sWdg);
 }
 
 /* ============================= */
@@ -91,13 +157,45 @@ void ADC_Init(void)
  */
 void ADC_StartConversion(void)
 {
-    HAL_ADC_Start(&hadc);
+    uint32_t start = Timer_GetMicros();
+    
+    /* ADC cannot be enabled while calibration is still running */
+    while (LL_ADC_IsCalibrationOnGoing(hadc.Instance))
+    {
+        if ((Timer_GetMicros() - start) >= ADC_CALIBRATION_TIMEOUT_US)
+        {
+            LOG_ERROR("ADC calibration timeout\n");
+            break;
+        }
+    }
+    adc_calibrated = !LL_ADC_IsCalibrationOnGoing(hadc.Instance);
+    
+    HAL_ADC_Start_DMA(&hadc, (uint32_t*)adc_raw, ADC_RAW_COUNT);
+}
+
+/**
+ * @brief Check if self-calibration completed
+ */
+bool ADC_IsCalibrated(void)
+{
+    return adc_calibrated;
 }
 
 /* ============================= */
 /* DATA ACQUISITION              */
 /* ============================= */
 
+/**
+ * @brief Get the latest raw 12-bit code of a channel (any context)
+ */
+uint16_t ADC_GetRaw(ADC_RawChannel_t channel)
+{
+    if (channel >= ADC_RAW_COUNT)
+        return 0;
+    
+    return adc_raw[channel];
+}
+
 /**
  * @brief Get all ADC readings
  */
@@ -116,9 +214,7 @@ ADC_Readings_t ADC_GetReadings(void)
  */
 double ADC_GetTemperature(void)
 {
-    /* Wait for conversion and get value */
-    HAL_ADC_PollForConversion(&hadc, HAL_MAX_DELAY);
-    uint16_t adc_value = HAL_ADC_GetValue(&hadc);
+    uint16_t adc_value = adc_raw[ADC_RAW_TEMPERATURE];
     
     /* Convert ADC value to voltage (mV) */
     double voltage_mv = (adc_value / ADC_RESOLUTION) * ADC_REF_VOLTAGE * 1000;
@@ -141,9 +237,7 @@ double ADC_GetTemperature(void)
  */
 double ADC_GetVoltage(void)
 {
-    /* Wait for conversion */
-    HAL_ADC_PollForConversion(&hadc, HAL_MAX_DELAY);
-    uint16_t adc_value = HAL_ADC_GetValue(&hadc);
+    uint16_t adc_value = adc_raw[ADC_RAW_VOLTAGE];
     
     /* Convert ADC value to voltage */
     /* 10:1 divider: ADC reads 0-3.3V for 0-33V input */
@@ -163,9 +257,7 @@ double ADC_GetVoltage(void)
  */
 double ADC_GetCurrent(void)
 {
-    /* Wait for conversion */
-    HAL_ADC_PollForConversion(&hadc, HAL_MAX_DELAY);
-    uint16_t adc_value = HAL_ADC_GetValue(&hadc);
+    uint16_t adc_value = adc_raw[ADC_RAW_CURRENT];
     
     /* Convert ADC value to voltage */
     double voltage = (adc_value / ADC_RESOLUTION) * ADC_REF_VOLTAGE;
@@ -181,6 +273,92 @@ double ADC_GetCurrent(void)
     return current;
 }
 
+/* ============================= */
+/* HARDWARE PROTECTION           */
+/* ============================= */
+
+/**
+ * @brief Get latched and active protection faults
+ */
+ADC_FaultStatus_t ADC_GetFaultStatus(void)
+{
+    ADC_FaultStatus_t status;
+    status.latched = fault_latched;
+    status.active = fault_active;
+    status.trip_count = fault_trips;
+    return status;
+}
+
+/**
+ * @brief Clear latched faults
+ * @return false if a fault condition has not recovered yet
+ */
+bool ADC_ClearFault(void)
+{
+    if (fault_active != ADC_FAULT_NONE)
+        return false;
+    
+    fault_latched = ADC_FAULT_NONE;
+    GPIO_SetRFInhibit(false);
+    GPIO_SetErrorLED(false);
+    return true;
+}
+
+/**
+ * @brief Common watchdog handling with hysteresis
+ *
+ * Normal window is [0, trip]. On a trip RF is cut, the fault is latched
+ * and the window flips to [recover, max] so the next event reports
+ * recovery instead of re-firing on every conversion.
+ */
+static void ADC_HandleWatchdog(uint32_t awd, uint8_t fault,
+                               uint32_t trip, uint32_t recover)
+{
+    if ((fault_active & fault) == 0)
+    {
+        GPIO_SetRFOutput(false);
+        GPIO_SetRFInhibit(true);
+        GPIO_SetErrorLED(true);
+        
+        fault_active |= fault;
+        fault_latched |= fault;
+        fault_trips++;
+        
+        LL_ADC_ConfigAnalogWDThresholds(hadc.Instance, awd, AWD_RAW_MAX, recover);
+    }
+    else
+    {
+        /* Back below recovery threshold - fault stays latched until cleared */
+        fault_active &= (uint8_t)~fault;
+        
+        LL_ADC_ConfigAnalogWDThresholds(hadc.Instance, awd, trip, 0);
+    }
+}
+
+/**
+ * @brief AWD2 (temperature) out-of-window callback
+ */
+void HAL_ADCEx_LevelOutOfWindow2Callback(ADC_HandleTypeDef* hadc_cb)
+{
+    if (hadc_cb->Instance == ADC1)
+    {
+        ADC_HandleWatchdog(LL_ADC_AWD2, ADC_FAULT_OVERTEMP,
+                           AWD_TEMP_TRIP, AWD_TEMP_RECOVER);
+    }
+}
+
+/**
+ * @brief AWD3 (current) out-of-window callback
+ */
+void HAL_ADCEx_LevelOutOfWindow3Callback(ADC_HandleTypeDef* hadc_cb)
+{
+    if (hadc_cb->Instance == ADC1)
+    {
+        ADC_HandleWatchdog(LL_ADC_AWD3, ADC_FAULT_OVERCURRENT,
+                           AWD_CURR_TRIP, AWD_CURR_RECOVER);
+    }
+}
+
 /* ============================= */
 /* ADC MSP INITIALIZATION        */
 /* ============================= */
@@ -199,6 +377,7 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* hadc_msp)
         
         /* Enable GPIO clock */
         __HAL_RCC_GPIOC_CLK_ENABLE();
+        __HAL_RCC_DMA1_CLK_ENABLE();
         
         /* Configure ADC input pins as analog */
         /* PC0, PC1, PC2 */
@@ -207,7 +386,25 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* hadc_msp)
         GPIO_InitStruct.Pull = GPIO_NOPULL;
         HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
         
-        printf("ADC GPIO initialized\n");
+        /* Scan results: DMA1 Stream 2, circular, no interrupts needed */
+        hdma_adc.Instance = DMA1_Stream2;
+        hdma_adc.Init.Request = DMA_REQUEST_ADC1;
+        hdma_adc.Init.Direction = DMA_PERIPH_TO_MEMORY;
+        hdma_adc.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_adc.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_adc.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        hdma_adc.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+        hdma_adc.Init.Mode = DMA_CIRCULAR;
+        hdma_adc.Init.Priority = DMA_PRIORITY_LOW;
+        hdma_adc.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        HAL_DMA_Init(&hdma_adc);
+        __HAL_LINKDMA(hadc_msp, DMA_Handle, hdma_adc);
+        
+        /* Protection interrupt - highest priority, makes no RTOS calls */
+        HAL_NVIC_SetPriority(ADC_IRQn, 0, 0);
+        HAL_NVIC_EnableIRQ(ADC_IRQn);
+        
+        LOG_DEBUG("ADC GPIO initialized\n");
     }
 }
 
@@ -219,6 +416,20 @@ void HAL_ADC_MspDeInit(ADC_HandleTypeDef* hadc_msp)
     if (hadc_msp->Instance == ADC1)
     {
         __HAL_RCC_ADC12_CLK_DISABLE();
+        HAL_DMA_DeInit(&hdma_adc);
         HAL_GPIO_DeInit(GPIOC, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2);
+        HAL_NVIC_DisableIRQ(ADC_IRQn);
     }
+}
+
+/* ============================= */
+/* ADC IRQ HANDLER               */
+/* ============================= */
+
+/**
+ * @brief ADC1/ADC2 Interrupt Handler
+ */
+void ADC_IRQHandler(void)
+{
+    HAL_ADC_IRQHandler(&hadc);
 }
\ No newline at end of file
@@ -2,6 +2,15 @@
 #include "stm32h743xx.h"
 #include "stm32h7xx_hal.h"
 
+/* RF gate: pin is driven high only when requested, not blanked and not
+ * inhibited by a protection fault */
+static volatile bool rf_requested = false;
+static volatile bool rf_blanked = false;
+static volatile bool rf_inhibited = false;
+
+/* Pulse modulation: TIM15_CH1N drives the pin and the gate switches MOE */
+static volatile bool rf_pulsed = false;
+
 /**
  * @brief Initialize GPIO ports
  */
@@ -31,14 +40,99 @@ void GPIO_Init(void)
 }
 
 /**
- * @brief Set RF output
+ * @brief Drive the pin, or the timer output enable, from the gate inputs
+ * Called with interrupts masked.
  */
-void GPIO_SetRFOutput(bool enable)
+static void GPIO_ApplyRFGate(void)
 {
-    if (enable)
-        HAL_GPIO_WritePin(GPIOA, GPIO_PIN_1, GPIO_PIN_SET);
+    bool open = rf_requested && !rf_blanked && !rf_inhibited;
+    
+    if (rf_pulsed)
+    {
+        if (open)
+            TIM15->BDTR |= TIM_BDTR_MOE;
+        else
+            TIM15->BDTR &= ~TIM_BDTR_MOE;
+    }
     else
-        HAL_GPIO_WritePin(GPIOA, GPIO_PIN_1, GPIO_PIN_RESET);
+    {
+        HAL_GPIO_WritePin(GPIOA, GPIO_PIN_1, open ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+}
+
+/**
+ * @brief Update one RF gate input and drive the pin
+ * Interrupts are masked so a protection ISR cannot be overridden by a
+ * preempted task writing a stale "on" state.
+ */
+static void GPIO_UpdateRFGate(volatile bool* input, bool value)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    *input = value;
+    GPIO_ApplyRFGate();
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Hand PA1 to TIM15_CH1N (AF4) for pulse modulation, or take it back
+ * The gate is applied before the switch, so the pin never glitches high.
+ */
+void GPIO_SetRFPulsed(bool pulsed)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    GPIO_InitStruct.Pin = GPIO_PIN_1;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    
+    if (pulsed)
+    {
+        rf_pulsed = true;
+        GPIO_ApplyRFGate();
+        GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+        GPIO_InitStruct.Alternate = GPIO_AF4_TIM15;
+    }
+    else
+    {
+        TIM15->BDTR &= ~TIM_BDTR_MOE;
+        rf_pulsed = false;
+        GPIO_ApplyRFGate();
+        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    }
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Set RF output (safe to call from ISR)
+ */
+void GPIO_SetRFOutput(bool enable)
+{
+    GPIO_UpdateRFGate(&rf_requested, enable);
+}
+
+/**
+ * @brief Temporarily blank RF output without changing the request
+ * @param blank true to force the output off (e.g. PLL unlocked)
+ */
+void GPIO_SetRFBlank(bool blank)
+{
+    GPIO_UpdateRFGate(&rf_blanked, blank);
+}
+
+/**
+ * @brief Inhibit RF output until a protection fault is cleared
+ */
+void GPIO_SetRFInhibit(bool inhibit)
+{
+    GPIO_UpdateRFGate(&rf_inhibited, inhibit);
 }
 
 /**
@@ -46,6 +140,10 @@ void GPIO_SetRFOutput(bool enable)
  */
 bool GPIO_GetRFOutput(void)
 {
+    /* While pulsed the pin toggles; report whether the gate is open */
+    if (rf_pulsed)
+        return (TIM15->BDTR & TIM_BDTR_MOE) != 0;
+    
     return HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_1) == GPIO_PIN_SET;
 }
 
@@ -3,38 +3,203 @@
 #include "stm32h7xx_hal.h"
 
 static I2C_HandleTypeDef hi2c;
+static DMA_HandleTypeDef hdma_rx;
+static DMA_HandleTypeDef hdma_tx;
+
+/**
+ * TIMINGR for 1 MHz Fast-mode Plus with the 64 MHz HSI kernel clock
+ * (fixed in every clock profile):
+ * PRESC=1 (31.25 ns), SCLDEL=2, SDADEL=0, SCLH=9, SCLL=18
+ */
+#define I2C_TIMING_FMP_1MHZ 0x10200912
+
+/* Upper bound for blocking register transfers */
+#define I2C_TIMEOUT_MS 10
+
+/* Completion callback of the DMA transfer in flight */
+static volatile I2C_CompleteCallback_t dma_callback = NULL;
 
 void I2C_Init(void)
 {
     hi2c.Instance = I2C1;
-    hi2c.Init. Timing = 0x00C0EAFF;
+    hi2c.Init.Timing = I2C_TIMING_FMP_1MHZ;
     hi2c.Init.OwnAddress1 = 0;
-    hi2c.Init. AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+    hi2c.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
     hi2c.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
     hi2c.Init.OwnAddress2 = 0;
-    hi2c. Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    hi2c.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
     hi2c.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
     
     HAL_I2C_Init(&hi2c);
+    
+    /* Fast-mode Plus drive strength on SCL/SDA */
+    HAL_I2CEx_EnableFastModePlus(I2C_FASTMODEPLUS_I2C1);
 }
 
 void I2C_WriteData(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len)
 {
-    uint8_t buffer[256];
-    buffer[0] = reg;
-    for (uint16_t i = 0; i < len; i++)
-        buffer[i + 1] = data[i];
-    
-    HAL_I2C_Master_Transmit(&hi2c, (uint16_t)(addr << 1), buffer, len + 1, HAL_MAX_DELAY);
+    HAL_I2C_Mem_Write(&hi2c, (uint16_t)(addr << 1), reg, I2C_MEMADD_SIZE_8BIT,
+                      data, len, I2C_TIMEOUT_MS);
 }
 
 void I2C_ReadData(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len)
 {
-    HAL_I2C_Master_Transmit(&hi2c, (uint16_t)(addr << 1), &reg, 1, HAL_MAX_DELAY);
-    HAL_I2C_Master_Receive(&hi2c, (uint16_t)(addr << 1), data, len, HAL_MAX_DELAY);
+    HAL_I2C_Mem_Read(&hi2c, (uint16_t)(addr << 1), reg, I2C_MEMADD_SIZE_8BIT,
+                     data, len, I2C_TIMEOUT_MS);
 }
 
 bool I2C_IsDeviceReady(uint8_t addr)
 {
     return HAL_I2C_IsDeviceReady(&hi2c, (uint16_t)(addr << 1), 3, 100) == HAL_OK;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Start a 16-bit addressed DMA write
+ * @param data Source buffer - must be in DMA-accessible RAM
+ * @return false if the bus is busy or the transfer could not start
+ */
+bool I2C_MemWriteDMA(uint8_t addr, uint16_t mem_addr, const uint8_t *data,
+                     uint16_t len, I2C_CompleteCallback_t callback)
+{
+    dma_callback = callback;
+    
+    if (HAL_I2C_Mem_Write_DMA(&hi2c, (uint16_t)(addr << 1), mem_addr,
+                              I2C_MEMADD_SIZE_16BIT, (uint8_t *)data, len) != HAL_OK)
+    {
+        dma_callback = NULL;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Start a 16-bit addressed DMA read
+ * @param data Destination buffer - must be in DMA-accessible RAM
+ * @return false if the bus is busy or the transfer could not start
+ */
+bool I2C_MemReadDMA(uint8_t addr, uint16_t mem_addr, uint8_t *data,
+                    uint16_t len, I2C_CompleteCallback_t callback)
+{
+    dma_callback = callback;
+    
+    if (HAL_I2C_Mem_Read_DMA(&hi2c, (uint16_t)(addr << 1), mem_addr,
+                             I2C_MEMADD_SIZE_16BIT, data, len) != HAL_OK)
+    {
+        dma_callback = NULL;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Abort the transfer in flight (e.g. after a timeout)
+ */
+void I2C_Abort(uint8_t addr)
+{
+    dma_callback = NULL;
+    HAL_I2C_Master_Abort_IT(&hi2c, (uint16_t)(addr << 1));
+}
+
+/**
+ * @brief Invoke and clear the completion callback
+ */
+static void I2C_Complete(bool success)
+{
+    I2C_CompleteCallback_t callback = dma_callback;
+    
+    dma_callback = NULL;
+    if (callback != NULL)
+        callback(success);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c_cb)
+{
+    if (hi2c_cb->Instance == I2C1)
+        I2C_Complete(true);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c_cb)
+{
+    if (hi2c_cb->Instance == I2C1)
+        I2C_Complete(true);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c_cb)
+{
+    if (hi2c_cb->Instance == I2C1)
+        I2C_Complete(false);
+}
+
+/**
+ * @brief I2C MSP Init - pins, DMA streams and interrupts
+ */
+void HAL_I2C_MspInit(I2C_HandleTypeDef* hi2c_msp)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    
+    if (hi2c_msp->Instance == I2C1)
+    {
+        __HAL_RCC_I2C1_CLK_ENABLE();
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+        __HAL_RCC_DMA1_CLK_ENABLE();
+        
+        /* PB6=SCL, PB7=SDA */
+        GPIO_InitStruct.Pin = GPIO_PIN_6 | GPIO_PIN_7;
+        GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+        GPIO_InitStruct.Alternate = GPIO_AF4_I2C1;
+        HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+        
+        /* RX: DMA1 Stream 0 */
+        hdma_rx.Instance = DMA1_Stream0;
+        hdma_rx.Init.Request = DMA_REQUEST_I2C1_RX;
+        hdma_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+        hdma_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_rx.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_rx.Init.Mode = DMA_NORMAL;
+        hdma_rx.Init.Priority = DMA_PRIORITY_MEDIUM;
+        hdma_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        HAL_DMA_Init(&hdma_rx);
+        __HAL_LINKDMA(hi2c_msp, hdmarx, hdma_rx);
+        
+        /* TX: DMA1 Stream 1 */
+        hdma_tx.Instance = DMA1_Stream1;
+        hdma_tx.Init = hdma_rx.Init;
+        hdma_tx.Init.Request = DMA_REQUEST_I2C1_TX;
+        hdma_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+        HAL_DMA_Init(&hdma_tx);
+        __HAL_LINKDMA(hi2c_msp, hdmatx, hdma_tx);
+        
+        HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, 6, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+        HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 6, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+        HAL_NVIC_SetPriority(I2C1_EV_IRQn, 6, 0);
+        HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+        HAL_NVIC_SetPriority(I2C1_ER_IRQn, 6, 0);
+        HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+    }
+}
+
+void I2C1_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&hi2c);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&hi2c);
+}
+
+void DMA1_Stream0_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_rx);
+}
+
+void DMA1_Stream1_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_tx);
+}
@@ -0,0 +1,269 @@
+/**
+ * System Timebase for STM32H743
+ * TIM2 (32-bit) counts microseconds, extended to 64 bits in software
+ */
+
+#include "hal_timer.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+/* Timer Handle */
+static TIM_HandleTypeDef htim;
+
+/* Upper 32 bits of device time, incremented on TIM2 overflow */
+static volatile uint32_t timer_overflows = 0;
+
+/* CH1 compare alarm; NULL when disarmed */
+static volatile Timer_AlarmCallback_t alarm_callback = NULL;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Get the APB1 timer kernel clock (TIM2-7, TIM12-14)
+ * APB1 timers run at 2x PCLK1 whenever the APB1 prescaler is not 1
+ */
+uint32_t Timer_GetClockHz(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    
+    if ((RCC->D2CFGR & RCC_D2CFGR_D2PPRE1) != RCC_D2CFGR_D2PPRE1_DIV1)
+        return pclk1 * 2;
+    
+    return pclk1;
+}
+
+/**
+ * @brief Get the APB2 timer kernel clock (TIM1, TIM8, TIM15-17)
+ * APB2 timers run at 2x PCLK2 whenever the APB2 prescaler is not 1
+ */
+uint32_t Timer_GetApb2ClockHz(void)
+{
+    uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+    
+    if ((RCC->D2CFGR & RCC_D2CFGR_D2PPRE2) != RCC_D2CFGR_D2PPRE2_DIV1)
+        return pclk2 * 2;
+    
+    return pclk2;
+}
+
+/**
+ * @brief Initialize microsecond timebase and cycle counter
+ */
+void Timer_Init(void)
+{
+    /* DWT cycle counter (unlock required on Cortex-M7) */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    
+    /* TIM2: 1 MHz free-running, full 32-bit period */
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    
+    htim.Instance = TIM2;
+    htim.Init.Prescaler = (Timer_GetClockHz() / 1000000UL) - 1;
+    htim.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim.Init.Period = 0xFFFFFFFFUL;
+    htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    
+    HAL_TIM_Base_Init(&htim);
+    
+    /* Overflow interrupt extends the counter to 64 bits */
+    HAL_NVIC_SetPriority(TIM2_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+    
+    HAL_TIM_Base_Start_IT(&htim);
+}
+
+/**
+ * @brief Reload the prescaler after a bus clock change
+ * TIM2 miscounts while the bus clock moves under the old prescaler, so the
+ * caller passes the device time to resume from; URS keeps the forced
+ * update from being counted as an overflow. An alarm the corrected time
+ * has reached fires at once.
+ * @param now_us Device time measured across the change
+ */
+void Timer_Retime(uint64_t now_us)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    TIM2->PSC = (Timer_GetClockHz() / 1000000UL) - 1;
+    TIM2->CR1 |= TIM_CR1_URS;
+    TIM2->EGR = TIM_EGR_UG;
+    
+    /* A wrap during the change is already counted in now_us */
+    TIM2->SR = ~TIM_SR_UIF;
+    timer_overflows = (uint32_t)(now_us >> 32);
+    TIM2->CNT = (uint32_t)now_us;
+    
+    if ((TIM2->DIER & TIM_DIER_CC1IE) && (int32_t)(TIM2->CNT - TIM2->CCR1) >= 0)
+        TIM2->EGR = TIM_EGR_CC1G;
+    
+    __set_PRIMASK(primask);
+}
+
+/* ============================= */
+/* DEVICE TIME                   */
+/* ============================= */
+
+/**
+ * @brief Get device time (wraps every ~71 minutes)
+ */
+uint32_t Timer_GetMicros(void)
+{
+    return TIM2->CNT;
+}
+
+/**
+ * @brief Get 64-bit device time in microseconds
+ */
+uint64_t Timer_GetMicros64(void)
+{
+    uint32_t hi;
+    uint32_t lo;
+    
+    do
+    {
+        hi = timer_overflows;
+        lo = TIM2->CNT;
+    } while (hi != timer_overflows);
+    
+    /* Overflow pending but not yet serviced (caller has the IRQ masked) */
+    if ((TIM2->SR & TIM_SR_UIF) && lo < 0x80000000UL)
+        hi++;
+    
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief Busy-wait on device time (usable before the scheduler starts)
+ */
+void Timer_DelayMicros(uint32_t us)
+{
+    uint32_t start = TIM2->CNT;
+    
+    while ((TIM2->CNT - start) < us)
+    {
+    }
+}
+
+/**
+ * @brief Get core cycle count
+ */
+uint32_t Timer_GetCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* ============================= */
+/* ALARM                         */
+/* ============================= */
+
+/**
+ * @brief Arm the one-shot alarm at an absolute device time
+ * A time that has already passed fires at once.
+ * @return false if an alarm is already armed
+ */
+bool Timer_SetAlarm(uint32_t at_us, Timer_AlarmCallback_t callback)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (alarm_callback != NULL || callback == NULL)
+    {
+        __set_PRIMASK(primask);
+        return false;
+    }
+    
+    /* CH1 in frozen output compare mode: flag only, no pin */
+    TIM2->CCMR1 &= ~(TIM_CCMR1_OC1M | TIM_CCMR1_CC1S);
+    TIM2->CCR1 = at_us;
+    TIM2->SR = ~TIM_SR_CC1IF;
+    alarm_callback = callback;
+    TIM2->DIER |= TIM_DIER_CC1IE;
+    
+    if ((int32_t)(TIM2->CNT - at_us) >= 0)
+        TIM2->EGR = TIM_EGR_CC1G;
+    
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief Disarm the alarm
+ * @return true if it was disarmed before firing
+ */
+bool Timer_CancelAlarm(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    bool armed = (alarm_callback != NULL);
+    
+    TIM2->DIER &= ~TIM_DIER_CC1IE;
+    TIM2->SR = ~TIM_SR_CC1IF;
+    alarm_callback = NULL;
+    
+    __set_PRIMASK(primask);
+    return armed;
+}
+
+/* ============================= */
+/* HAL TIMEBASE                  */
+/* ============================= */
+
+/**
+ * @brief HAL tick from device time
+ * SysTick belongs to FreeRTOS; HAL timeouts and HAL_Delay run off TIM2
+ * instead, so they also work before the scheduler starts.
+ */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+    (void)TickPriority;
+    return HAL_OK;
+}
+
+/**
+ * @brief HAL tick in milliseconds (0 until Timer_Init, which runs before
+ * the clock setup so its HAL timeouts work)
+ */
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(Timer_GetMicros64() / 1000ULL);
+}
+
+/* ============================= */
+/* TIM2 IRQ HANDLER              */
+/* ============================= */
+
+/**
+ * @brief TIM2 Interrupt Handler
+ * Handled at register level - HAL_TIM_PeriodElapsedCallback is shared by
+ * every timer in the system
+ */
+void TIM2_IRQHandler(void)
+{
+    uint32_t sr = TIM2->SR;
+    
+    if (sr & TIM_SR_UIF)
+    {
+        TIM2->SR = ~TIM_SR_UIF;
+        timer_overflows++;
+    }
+    
+    if ((sr & TIM_SR_CC1IF) && (TIM2->DIER & TIM_DIER_CC1IE))
+    {
+        Timer_AlarmCallback_t callback = alarm_callback;
+        
+        TIM2->DIER &= ~TIM_DIER_CC1IE;
+        TIM2->SR = ~TIM_SR_CC1IF;
+        alarm_callback = NULL;
+        
+        if (callback != NULL)
+            callback();
+    }
+}
@@ -4,19 +4,70 @@
  */
 
 #include "hal_uart.h"
+#include "clock.h"
+#include "hal_timer.h"
 #include "stm32h743xx.h"
 #include "stm32h7xx_hal.h"
 #include <stdio.h>
 #include <string.h>
 
+/* FreeRTOS */
+#include "FreeRTOS.h"
+#include "task.h"
+
 /* UART Handle */
 static UART_HandleTypeDef huart;
 
-/* RX Buffer */
+/* Rates offered to the host by SYS:BAUD? - exact or <0.1% error from the
+ * 64 MHz kernel clock, up to the CH340G maximum */
+static const uint32_t uart_baud_rates[] = {
+    115200, 230400, 460800, 921600, 1000000, 2000000
+};
+
+/* RX ring - filled by USART3_IRQHandler, drained by UART_ReceiveString */
 #define RX_BUFFER_SIZE 512
 static uint8_t rx_buffer[RX_BUFFER_SIZE];
-static uint32_t rx_index = 0;
-static uint32_t rx_start = 0;
+static volatile uint32_t rx_index = 0;
+static volatile uint32_t rx_start = 0;
+static volatile uint32_t rx_overruns = 0;
+
+/* Receive time of each complete line still in the RX ring */
+#define RX_LINE_SLOTS 16
+static uint32_t rx_line_us[RX_LINE_SLOTS];
+static volatile uint32_t rx_line_head = 0;
+static volatile uint32_t rx_line_tail = 0;
+static bool rx_line_open = false;
+static uint32_t line_timestamp_us = 0;
+
+/* Binary transfer in progress - bytes are not lines */
+static volatile bool rx_raw = false;
+
+/* TX ring - filled by _write/UART_SendBuffer, drained by the TXE interrupt */
+#define TX_BUFFER_SIZE 2048
+static uint8_t tx_buffer[TX_BUFFER_SIZE];
+static volatile uint32_t tx_head = 0;
+static volatile uint32_t tx_tail = 0;
+
+/* Task waiting for TX ring room, woken by the TX interrupt through its own
+ * notification index so the task's other notifications are untouched */
+#define TX_NOTIFY_INDEX 1
+#define TX_WAIT_MAX_MS  100
+static TaskHandle_t tx_waiter = NULL;
+static uint32_t tx_wait_free = 0;
+
+/* stdout is line buffered here so each printed line reaches the TX ring
+ * in one _write call */
+#define STDOUT_BUFFER_SIZE 256
+static char stdout_buffer[STDOUT_BUFFER_SIZE];
+
+/* Line being assembled by UART_ReceiveString */
+static char line_buffer[256];
+static uint32_t line_length = 0;
+
+/* Called from the RX ISR at the end of each non-empty line */
+static UART_LineCallback_t line_callback = NULL;
+
+static void UART_ResetRx(void);
 
 /* ============================= */
 /* INITIALIZATION                */
@@ -29,7 +80,7 @@ void UART_Init(void)
 {
     /* Configure UART3 (USB CDC mapped) */
     huart.Instance = USART3;
-    huart.Init.BaudRate = 115200;
+    huart.Init.BaudRate = UART_DEFAULT_BAUD;
     huart.Init.WordLength = UART_WORDLENGTH_8B;
     huart.Init.StopBits = UART_STOPBITS_1;
     huart.Init.Parity = UART_PARITY_NONE;
@@ -39,28 +90,204 @@ void UART_Init(void)
     
     HAL_UART_Init(&huart);
     
+    setvbuf(stdout, stdout_buffer, _IOLBF, sizeof(stdout_buffer));
+    
     /* Enable RX interrupt */
+    tx_head = 0;
+    tx_tail = 0;
+    UART_ResetRx();
     __HAL_UART_ENABLE_IT(&huart, UART_IT_RXNE);
 }
 
+/**
+ * @brief Check if a baud rate is offered
+ */
+bool UART_IsBaudSupported(uint32_t baud)
+{
+    for (uint32_t i = 0; i < sizeof(uart_baud_rates) / sizeof(uart_baud_rates[0]); i++)
+    {
+        if (uart_baud_rates[i] == baud)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Get the offered baud rates
+ */
+const uint32_t* UART_GetSupportedBauds(uint32_t* count)
+{
+    *count = sizeof(uart_baud_rates) / sizeof(uart_baud_rates[0]);
+    return uart_baud_rates;
+}
+
+/**
+ * @brief Switch baud rate once the last byte has left the shifter
+ * Rates above 115200 use oversampling by 8 (kernel clock / 8 max).
+ * Pending RX data is discarded - it straddles the switch.
+ */
+bool UART_SetBaudRate(uint32_t baud)
+{
+    if (!UART_IsBaudSupported(baud))
+        return false;
+    
+    UART_Flush();
+    
+    __HAL_UART_DISABLE_IT(&huart, UART_IT_RXNE);
+    
+    huart.Init.BaudRate = baud;
+    huart.Init.OverSampling = (baud > UART_DEFAULT_BAUD) ?
+                              UART_OVERSAMPLING_8 : UART_OVERSAMPLING_16;
+    bool ok = (HAL_UART_Init(&huart) == HAL_OK);
+    
+    UART_ResetRx();
+    __HAL_UART_ENABLE_IT(&huart, UART_IT_RXNE);
+    
+    return ok;
+}
+
+/**
+ * @brief Get the configured (nominal) baud rate
+ */
+uint32_t UART_GetConfiguredBaud(void)
+{
+    return huart.Init.BaudRate;
+}
+
 /**
  * @brief De-initialize UART
  */
 void UART_DeInit(void)
 {
+    UART_Flush();
     HAL_UART_DeInit(&huart);
 }
 
+/**
+ * @brief Discard pending RX data and line timestamps
+ */
+static void UART_ResetRx(void)
+{
+    rx_index = 0;
+    rx_start = 0;
+    rx_line_head = 0;
+    rx_line_tail = 0;
+    rx_line_open = false;
+    line_length = 0;
+}
+
 /* ============================= */
 /* TRANSMISSION                  */
 /* ============================= */
 
+/**
+ * @brief Free space in the TX ring
+ */
+static uint32_t UART_GetTxFree(void)
+{
+    return (tx_tail + TX_BUFFER_SIZE - tx_head - 1) % TX_BUFFER_SIZE;
+}
+
+/**
+ * @brief Move bytes to the data register by polling
+ * Keeps the ring draining when the TX interrupt cannot run (interrupts
+ * masked before the scheduler starts, or called from a higher priority).
+ */
+static void UART_DrainTx(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (tx_tail != tx_head && (huart.Instance->ISR & USART_ISR_TXE_TXFNF))
+    {
+        huart.Instance->TDR = tx_buffer[tx_tail];
+        tx_tail = (tx_tail + 1) % TX_BUFFER_SIZE;
+    }
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Wait until the TX ring has the given room
+ * A task blocks until the TX interrupt has drained enough; one task waits
+ * at a time and the others retry each tick. Polls where the interrupt
+ * cannot run (before the scheduler starts, interrupts masked, or ISR).
+ */
+static void UART_WaitTxFree(uint32_t needed)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING ||
+        __get_PRIMASK() != 0 || __get_BASEPRI() != 0 || __get_IPSR() != 0)
+    {
+        while (UART_GetTxFree() < needed)
+            UART_DrainTx();
+        return;
+    }
+    
+    while (UART_GetTxFree() < needed)
+    {
+        TaskHandle_t self = xTaskGetCurrentTaskHandle();
+        
+        taskENTER_CRITICAL();
+        bool waiting = (tx_waiter == NULL);
+        if (waiting)
+        {
+            tx_waiter = self;
+            tx_wait_free = needed;
+        }
+        __HAL_UART_ENABLE_IT(&huart, UART_IT_TXE);
+        taskEXIT_CRITICAL();
+        
+        if (!waiting)
+        {
+            vTaskDelay(1);
+            continue;
+        }
+        
+        ulTaskNotifyTakeIndexed(TX_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(TX_WAIT_MAX_MS));
+        
+        taskENTER_CRITICAL();
+        if (tx_waiter == self)
+            tx_waiter = NULL;
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief Queue bytes for the TX interrupt
+ * Waits for room for the whole buffer (up to the ring size), so output
+ * from different tasks is never interleaved within one call.
+ */
+static void UART_QueueTx(const uint8_t* data, size_t length)
+{
+    while (length > 0)
+    {
+        uint32_t chunk = (length < TX_BUFFER_SIZE - 1) ? length : TX_BUFFER_SIZE - 1;
+        
+        UART_WaitTxFree(chunk);
+        
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        
+        for (uint32_t i = 0; i < chunk; i++)
+        {
+            tx_buffer[tx_head] = data[i];
+            tx_head = (tx_head + 1) % TX_BUFFER_SIZE;
+        }
+        __HAL_UART_ENABLE_IT(&huart, UART_IT_TXE);
+        
+        __set_PRIMASK(primask);
+        
+        data += chunk;
+        length -= chunk;
+    }
+}
+
 /**
  * @brief Send single byte
  */
 void UART_SendByte(uint8_t byte)
 {
-    HAL_UART_Transmit(&huart, &byte, 1, HAL_MAX_DELAY);
+    UART_QueueTx(&byte, 1);
 }
 
 /**
@@ -70,7 +297,7 @@ void UART_SendBuffer(const uint8_t* buffer, size_t length)
 {
     if (buffer && length > 0)
     {
-        HAL_UART_Transmit(&huart, (uint8_t*)buffer, length, HAL_MAX_DELAY);
+        UART_QueueTx(buffer, length);
     }
 }
 
@@ -90,65 +317,156 @@ void UART_SendString(const char* str)
  */
 void UART_PutChar(char c)
 {
-    HAL_UART_Transmit(&huart, (uint8_t*)&c, 1, HAL_MAX_DELAY);
+    UART_QueueTx((const uint8_t*)&c, 1);
+}
+
+/**
+ * @brief Wait until all queued bytes have left the shifter
+ */
+void UART_Flush(void)
+{
+    fflush(stdout);
+    
+    UART_WaitTxFree(TX_BUFFER_SIZE - 1);
+    
+    while (!(huart.Instance->ISR & USART_ISR_TC))
+    {
+    }
+}
+
+/**
+ * @brief Get bytes waiting in the TX ring
+ */
+uint32_t UART_GetTxPending(void)
+{
+    return (tx_head + TX_BUFFER_SIZE - tx_tail) % TX_BUFFER_SIZE;
 }
 
 /* ============================= */
 /* RECEPTION                     */
 /* ============================= */
 
+/**
+ * @brief Take one byte from the RX ring
+ * @return -1 if the ring is empty
+ */
+static int UART_PopByte(void)
+{
+    uint32_t start = rx_start;
+    
+    if (start == rx_index)
+        return -1;
+    
+    uint8_t byte = rx_buffer[start];
+    rx_start = (start + 1) % RX_BUFFER_SIZE;
+    return (int)byte;
+}
+
 /**
  * @brief Receive single byte (blocking)
  */
 uint8_t UART_ReceiveByte(void)
 {
-    uint8_t byte;
-    HAL_UART_Receive(&huart, &byte, 1, HAL_MAX_DELAY);
-    return byte;
+    int byte;
+    
+    while ((byte = UART_PopByte()) < 0)
+    {
+        __WFI();
+    }
+    return (uint8_t)byte;
 }
 
 /**
- * @brief Receive buffer
+ * @brief Receive buffer (blocking)
  */
 size_t UART_ReceiveBuffer(uint8_t* buffer, size_t max_length)
 {
     if (buffer && max_length > 0)
     {
-        HAL_UART_Receive(&huart, buffer, max_length, HAL_MAX_DELAY);
+        for (size_t i = 0; i < max_length; i++)
+            buffer[i] = UART_ReceiveByte();
         return max_length;
     }
     return 0;
 }
 
 /**
- * @brief Receive null-terminated string
+ * @brief Take whatever has arrived, up to max_length bytes (non-blocking)
+ */
+size_t UART_ReceiveAvailable(uint8_t* buffer, size_t max_length)
+{
+    size_t count = 0;
+    int byte;
+    
+    while (count < max_length && (byte = UART_PopByte()) >= 0)
+        buffer[count++] = (uint8_t)byte;
+    return count;
+}
+
+/**
+ * @brief Suspend line handling for a binary transfer
+ * While raw, line terminators in the data neither wake the line callback
+ * nor take a timestamp slot.
+ */
+void UART_SetRawMode(bool raw)
+{
+    rx_line_open = false;
+    rx_raw = raw;
+}
+
+/**
+ * @brief Receive null-terminated string (non-blocking)
+ * @return Complete line, or NULL if no full line has arrived yet
  */
 char* UART_ReceiveString(void)
 {
-    static char string_buffer[256];
-    uint32_t index = 0;
+    int byte;
     
-    while (index < sizeof(string_buffer) - 1)
+    while ((byte = UART_PopByte()) >= 0)
     {
-        uint8_t byte = UART_ReceiveByte();
-        
         /* Check for line endings */
         if (byte == '\n' || byte == '\r')
         {
-            string_buffer[index] = '\0';
-            return (index > 0) ? string_buffer : NULL;
+            if (line_length == 0)
+                continue;
+            
+            line_buffer[line_length] = '\0';
+            line_length = 0;
+            
+            if (rx_line_tail != rx_line_head)
+            {
+                line_timestamp_us = rx_line_us[rx_line_tail % RX_LINE_SLOTS];
+                rx_line_tail++;
+            }
+            return line_buffer;
         }
         
         /* Skip whitespace at start */
-        if (index == 0 && (byte == ' ' || byte == '\t'))
+        if (line_length == 0 && (byte == ' ' || byte == '\t'))
             continue;
         
-        /* Add character to buffer */
-        string_buffer[index++] = (char)byte;
+        /* Add character to buffer (overlong lines are truncated) */
+        if (line_length < sizeof(line_buffer) - 1)
+            line_buffer[line_length++] = (char)byte;
     }
     
-    string_buffer[index] = '\0';
-    return string_buffer;
+    return NULL;
+}
+
+/**
+ * @brief Get the device time at which the last returned line was terminated
+ */
+uint32_t UART_GetLineTimestamp(void)
+{
+    return line_timestamp_us;
+}
+
+/**
+ * @brief Register line-received callback (runs in ISR context)
+ */
+void UART_SetLineCallback(UART_LineCallback_t callback)
+{
+    line_callback = callback;
 }
 
 /**
@@ -156,10 +474,7 @@ char* UART_ReceiveString(void)
  */
 int UART_GetChar(void)
 {
-    uint8_t byte;
-    if (HAL_UART_Receive(&huart, &byte, 1, HAL_MAX_DELAY) == HAL_OK)
-        return (int)byte;
-    return -1;
+    return (int)UART_ReceiveByte();
 }
 
 /* ============================= */
@@ -167,54 +482,45 @@ int UART_GetChar(void)
 /* ============================= */
 
 /**
- * @brief Get RX buffer size
+ * @brief Get the actual baud rate (kernel clock / USARTDIV)
+ * With oversampling by 8, BRR holds USARTDIV with bits [3:0] shifted right
+ * one place, and the rate is twice the kernel clock / USARTDIV.
  */
-uint32_t UART_GetRxSize(void)
+uint32_t UART_GetBaudRate(void)
 {
-    return rx_index - rx_start;
+    uint32_t brr = huart.Instance->BRR;
+    
+    if (huart.Instance->CR1 & USART_CR1_OVER8)
+    {
+        uint32_t usartdiv = (brr & 0xFFF0) | ((brr & 0x7) << 1);
+        return (usartdiv != 0) ? (2 * CLOCK_KERNEL_HZ / usartdiv) : 0;
+    }
+    
+    return (brr != 0) ? (CLOCK_KERNEL_HZ / brr) : 0;
 }
 
 /**
- * @brief Check if data available
+ * @brief Get count of RX overrun/framing/noise errors and ring overflows
  */
-bool UART_IsDataAvailable(void)
+uint32_t UART_GetRxErrors(void)
 {
-    return rx_index > rx_start;
+    return rx_overruns;
 }
 
-/* ============================= */
-/* HAL CALLBACKS                 */
-/* ============================= */
-
 /**
- * @brief UART RX Complete Callback
+ * @brief Get RX buffer size
  */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart_inst)
+uint32_t UART_GetRxSize(void)
 {
-    if (huart_inst->Instance == USART3)
-    {
-        rx_index++;
-        if (rx_index >= RX_BUFFER_SIZE)
-        {
-            rx_index = 0;
-        }
-        
-        /* Re-enable interrupt */
-        __HAL_UART_ENABLE_IT(&huart, UART_IT_RXNE);
-    }
+    return (rx_index + RX_BUFFER_SIZE - rx_start) % RX_BUFFER_SIZE;
 }
 
 /**
- * @brief UART Error Callback
+ * @brief Check if data available
  */
-void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart_inst)
+bool UART_IsDataAvailable(void)
 {
-    if (huart_inst->Instance == USART3)
-    {
-        /* Clear error flags */
-        __HAL_UART_CLEAR_OREFLAG(&huart);
-        __HAL_UART_ENABLE_IT(&huart, UART_IT_RXNE);
-    }
+    return rx_index != rx_start;
 }
 
 /* ============================= */
@@ -227,10 +533,8 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart_inst)
 #ifdef __GNUC__
 int _write(int file, char *ptr, int len)
 {
-    for (int i = 0; i < len; i++)
-    {
-        UART_PutChar(ptr[i]);
-    }
+    if (len > 0)
+        UART_QueueTx((const uint8_t*)ptr, (size_t)len);
     return len;
 }
 #endif
@@ -304,8 +608,78 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* huart_msp)
 
 /**
  * @brief UART3 Interrupt Handler
+ * RX and TX handled at register level through the rings.
  */
 void USART3_IRQHandler(void)
 {
-    HAL_UART_IRQHandler(&huart);
+    USART_TypeDef* uart = huart.Instance;
+    uint32_t isr = uart->ISR;
+    
+    if (isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE))
+    {
+        uart->ICR = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF;
+        rx_overruns++;
+    }
+    
+    if (isr & USART_ISR_RXNE_RXFNE)
+    {
+        uint8_t byte = (uint8_t)uart->RDR;
+        uint32_t next = (rx_index + 1) % RX_BUFFER_SIZE;
+        
+        if (next != rx_start)
+        {
+            rx_buffer[rx_index] = byte;
+            rx_index = next;
+        }
+        else
+        {
+            rx_overruns++;
+        }
+        
+        /* A line is non-empty once it has something besides blanks,
+         * matching what UART_ReceiveString hands out. Raw transfers are
+         * framed by their reader; leaving raw mode closes the line. */
+        if ((byte == '\n' || byte == '\r') && !rx_raw)
+        {
+            if (rx_line_open)
+            {
+                rx_line_open = false;
+                
+                if (rx_line_head - rx_line_tail < RX_LINE_SLOTS)
+                {
+                    rx_line_us[rx_line_head % RX_LINE_SLOTS] = Timer_GetMicros();
+                    rx_line_head++;
+                }
+                
+                if (line_callback != NULL)
+                    line_callback();
+            }
+        }
+        else if (byte != ' ' && byte != '\t')
+        {
+            rx_line_open = true;
+        }
+    }
+    
+    if ((isr & USART_ISR_TXE_TXFNF) && (uart->CR1 & USART_CR1_TXEIE_TXFNFIE))
+    {
+        if (tx_tail != tx_head)
+        {
+            uart->TDR = tx_buffer[tx_tail];
+            tx_tail = (tx_tail + 1) % TX_BUFFER_SIZE;
+        }
+        else
+        {
+            uart->CR1 &= ~USART_CR1_TXEIE_TXFNFIE;
+        }
+        
+        if (tx_waiter != NULL && UART_GetTxFree() >= tx_wait_free)
+        {
+            BaseType_t higher_priority_woken = pdFALSE;
+            
+            vTaskNotifyGiveIndexedFromISR(tx_waiter, TX_NOTIFY_INDEX, &higher_priority_woken);
+            tx_waiter = NULL;
+            portYIELD_FROM_ISR(higher_priority_woken);
+        }
+    }
 }
\ No newline at end of file
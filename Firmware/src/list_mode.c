@@ -0,0 +1,414 @@
+/**
+ * List Mode for STM32H743
+ * Pre-solved point list stepped by the TIM5 update interrupt
+ */
+
+#include "list_mode.h"
+#include "attenuator.h"
+#include "calibration.h"
+#include "crc.h"
+#include "hal_timer.h"
+#include "main.h"
+#include "max2871.h"
+#include "pulse.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+#include <string.h>
+
+/* TIM5 count rate - dwell is programmed directly in microseconds */
+#define LIST_TIMER_HZ 1000000UL
+
+/* The list does not fit the DTCM; it has its own AXI SRAM section */
+#define LIST_BUFFER __attribute__((section(".list_buffer"), aligned(8)))
+
+typedef struct {
+    MAX2871_Registers_t image;      /* frequency holds the uploaded point */
+    uint32_t dwell_us;
+    int8_t power_dbm;
+    Attenuator_Setting_t power;     /* Solved from power_dbm */
+} ListMode_Entry_t;
+
+static ListMode_Entry_t list_entries[LIST_MAX_POINTS] LIST_BUFFER;
+static uint32_t list_points = 0;
+
+/* Upload - points are assembled from however the bytes arrive */
+static uint32_t list_expected = 0;
+static uint8_t list_partial[LIST_POINT_BYTES];
+static uint32_t list_partial_length = 0;
+static uint16_t list_crc = 0;
+
+/* Frequency plan the images were solved under */
+static uint32_t list_generation = 0;
+static uint32_t list_solve_us = 0;
+
+/* Run state - written from the TIM5 ISR */
+static volatile ListMode_State_t list_state = LIST_STATE_EMPTY;
+static volatile uint32_t list_index = 0;
+static volatile uint32_t list_loop = 0;
+static volatile uint32_t list_steps = 0;
+static uint32_t list_loops = 0;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Enable TIM5 and its interrupt; stepping starts with ListMode_Run()
+ */
+void ListMode_Init(void)
+{
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    
+    TIM5->CR1 = 0;
+    TIM5->DIER = 0;
+    
+    /* Same level as the TIM2 commit alarm, above the RTOS - no RTOS calls.
+     * Neither ISR can preempt the other's SPI words, and a run is never
+     * started with a commit armed (nor one armed during a run) */
+    HAL_NVIC_SetPriority(TIM5_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+}
+
+/**
+ * @brief Reload the TIM5 prescaler after a bus clock change
+ * The prescaler is buffered, so a running list picks it up at the next
+ * point instead of restarting the current dwell.
+ */
+void ListMode_Retime(void)
+{
+    TIM5->PSC = (Timer_GetClockHz() / LIST_TIMER_HZ) - 1;
+}
+
+/**
+ * @brief Dwell of the point after index (wrapping for loops)
+ */
+static uint32_t ListMode_NextDwell(uint32_t index)
+{
+    return list_entries[(index + 1 < list_points) ? index + 1 : 0].dwell_us;
+}
+
+/**
+ * @brief Start TIM5 on the dwell of point 0
+ * ARR is preloaded: the value written during a dwell applies to the next
+ * one, so each ISR programs one point ahead.
+ */
+static void ListMode_StartTimer(void)
+{
+    TIM5->CR1 = TIM_CR1_URS | TIM_CR1_ARPE;
+    TIM5->PSC = (Timer_GetClockHz() / LIST_TIMER_HZ) - 1;
+    TIM5->ARR = list_entries[0].dwell_us - 1;
+    TIM5->EGR = TIM_EGR_UG;
+    TIM5->ARR = ListMode_NextDwell(0) - 1;
+    TIM5->SR = 0;
+    TIM5->DIER = TIM_DIER_UIE;
+    TIM5->CR1 = TIM_CR1_URS | TIM_CR1_ARPE | TIM_CR1_CEN;
+}
+
+/**
+ * @brief Stop stepping
+ */
+static void ListMode_StopTimer(void)
+{
+    TIM5->CR1 &= ~TIM_CR1_CEN;
+    TIM5->DIER = 0;
+    TIM5->SR = 0;
+}
+
+/* ============================= */
+/* UPLOAD                        */
+/* ============================= */
+
+/**
+ * @brief Range check one point and solve its register image
+ */
+static bool ListMode_SolvePoint(ListMode_Entry_t* entry)
+{
+    Frequency_t frequency = entry->image.frequency;
+    
+    if (frequency < RF_FREQ_MIN || frequency > RF_FREQ_MAX)
+        return false;
+    
+    if (entry->power_dbm < RF_POWER_MIN || entry->power_dbm > RF_POWER_MAX)
+        return false;
+    
+    if (entry->dwell_us < LIST_DWELL_MIN_US)
+        return false;
+    
+    /* Corrected for the output response at the point's frequency */
+    int16_t level = Attenuator_ClampLevel((int32_t)entry->power_dbm * 2 +
+                                          Calibration_GetLevelCorrection(frequency));
+    if (!Attenuator_Solve(level, &entry->power))
+        return false;
+    
+    return MAX2871_SolveUncached(frequency, &entry->image);
+}
+
+/**
+ * @brief Solve every point under the current frequency plan
+ * @return Index of the first bad point, or list_points if all are good
+ */
+static uint32_t ListMode_SolveAll(void)
+{
+    uint32_t start = Timer_GetMicros();
+    uint32_t i;
+    
+    for (i = 0; i < list_points; i++)
+    {
+        if (!ListMode_SolvePoint(&list_entries[i]))
+            break;
+    }
+    
+    list_generation = MAX2871_GetPlanGeneration();
+    list_solve_us = Timer_GetMicros() - start;
+    return i;
+}
+
+/**
+ * @brief Discard the current list and expect a new one
+ * @return false while running or if the count is out of range
+ */
+bool ListMode_BeginUpload(uint32_t points)
+{
+    if (list_state == LIST_STATE_RUNNING)
+        return false;
+    
+    if (points == 0 || points > LIST_MAX_POINTS)
+        return false;
+    
+    list_state = LIST_STATE_LOADING;
+    list_points = 0;
+    list_expected = points;
+    list_partial_length = 0;
+    list_crc = 0xFFFF;
+    return true;
+}
+
+/**
+ * @brief Take the next piece of the upload (any length)
+ * Bytes past the announced count are ignored.
+ */
+void ListMode_Receive(const uint8_t* data, size_t length)
+{
+    if (list_state != LIST_STATE_LOADING)
+        return;
+    
+    for (size_t i = 0; i < length && list_points < list_expected; i++)
+    {
+        list_partial[list_partial_length++] = data[i];
+        if (list_partial_length < LIST_POINT_BYTES)
+            continue;
+        
+        ListMode_Point_t point;
+        memcpy(&point, list_partial, sizeof(point));
+        list_crc = CRC16_Update(list_crc, list_partial, LIST_POINT_BYTES);
+        list_partial_length = 0;
+        
+        ListMode_Entry_t* entry = &list_entries[list_points++];
+        entry->image.frequency = point.frequency;
+        entry->dwell_us = point.dwell_us;
+        entry->power_dbm = point.power_dbm;
+    }
+}
+
+/**
+ * @brief Check the upload and solve every point
+ * @param crc CRC-16/CCITT over the uploaded bytes, from the host
+ * @param bad_point First point out of range (LIST_LOAD_RANGE)
+ * @return LIST_LOAD_OK if the list is ready to run; otherwise it is empty
+ */
+ListMode_LoadResult_t ListMode_EndUpload(uint16_t crc, uint32_t* bad_point)
+{
+    ListMode_LoadResult_t result = LIST_LOAD_OK;
+    
+    if (list_state != LIST_STATE_LOADING || list_points != list_expected)
+    {
+        result = LIST_LOAD_INCOMPLETE;
+    }
+    else if (list_crc != crc)
+    {
+        result = LIST_LOAD_CRC;
+    }
+    else
+    {
+        *bad_point = ListMode_SolveAll();
+        if (*bad_point != list_points)
+            result = LIST_LOAD_RANGE;
+    }
+    
+    if (result != LIST_LOAD_OK)
+    {
+        list_points = 0;
+        list_state = LIST_STATE_EMPTY;
+        return result;
+    }
+    
+    list_state = LIST_STATE_READY;
+    return LIST_LOAD_OK;
+}
+
+/* ============================= */
+/* EXECUTION                     */
+/* ============================= */
+
+/**
+ * @brief Write one point: output power mode rides along with the image,
+ * the attenuator is a single GPIO write
+ * As in Attenuator_SetLevel, the attenuator goes first when it attenuates
+ * more, so a step never overshoots the higher of the two levels.
+ */
+static void ListMode_Output(const ListMode_Entry_t* entry)
+{
+    bool attenuate_first = entry->power.code > Attenuator_GetCode();
+    
+    if (attenuate_first)
+        Attenuator_WriteCode(entry->power.code);
+    
+    MAX2871_SelectPowerMode(entry->power.power_mode);
+    MAX2871_Commit(&entry->image);
+    
+    if (!attenuate_first)
+        Attenuator_WriteCode(entry->power.code);
+}
+
+/**
+ * @brief Output point 0 and start stepping
+ * Images solved before a VCO band table change are solved again first.
+ * @param loops Passes through the list, 0 = until ListMode_Stop()
+ * @return false if no list is loaded, one is already running or a
+ * scheduled commit is armed
+ */
+bool ListMode_Run(uint32_t loops)
+{
+    if (list_state != LIST_STATE_READY && list_state != LIST_STATE_DONE)
+        return false;
+    
+    /* The TIM2 alarm would write SPI1 under the dwell ISR's feet */
+    if (MAX2871_IsCommitPending())
+        return false;
+    
+    if (list_generation != MAX2871_GetPlanGeneration() &&
+        ListMode_SolveAll() != list_points)
+    {
+        return false;
+    }
+    
+    list_index = 0;
+    list_loop = 0;
+    list_loops = loops;
+    list_steps = 1;
+    
+    ListMode_Output(&list_entries[0]);
+    Pulse_SyncPoint();
+    
+    list_state = LIST_STATE_RUNNING;
+    ListMode_StartTimer();
+    return true;
+}
+
+/**
+ * @brief Stop a run; the output stays at the current point
+ */
+void ListMode_Stop(void)
+{
+    HAL_NVIC_DisableIRQ(TIM5_IRQn);
+    if (list_state == LIST_STATE_RUNNING)
+    {
+        ListMode_StopTimer();
+        HAL_NVIC_ClearPendingIRQ(TIM5_IRQn);
+        list_state = LIST_STATE_DONE;
+    }
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+}
+
+/**
+ * @brief Check whether TIM5 owns the synthesizer
+ */
+bool ListMode_IsRunning(void)
+{
+    return list_state == LIST_STATE_RUNNING;
+}
+
+/**
+ * @brief Dwell of the current point has expired - output the next one
+ */
+static void ListMode_Step(void)
+{
+    uint32_t next = list_index + 1;
+    
+    if (next == list_points)
+    {
+        list_loop++;
+        if (list_loops != 0 && list_loop >= list_loops)
+        {
+            ListMode_StopTimer();
+            list_state = LIST_STATE_DONE;
+            return;
+        }
+        next = 0;
+    }
+    
+    ListMode_Output(&list_entries[next]);
+    Pulse_SyncPoint();
+    
+    list_index = next;
+    list_steps++;
+    TIM5->ARR = ListMode_NextDwell(next) - 1;
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get list and run status
+ */
+ListMode_Status_t ListMode_GetStatus(void)
+{
+    ListMode_Status_t status;
+    
+    HAL_NVIC_DisableIRQ(TIM5_IRQn);
+    status.state = list_state;
+    status.index = list_index;
+    status.loop = list_loop;
+    status.steps = list_steps;
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+    
+    status.points = list_points;
+    status.loops = list_loops;
+    status.solve_us = list_solve_us;
+    status.frequency = 0;
+    status.power_dbm = 0;
+    
+    if (status.state == LIST_STATE_RUNNING || status.state == LIST_STATE_DONE)
+    {
+        status.frequency = list_entries[status.index].image.frequency;
+        status.power_dbm = list_entries[status.index].power_dbm;
+    }
+    return status;
+}
+
+/**
+ * @brief Get state name for status reports
+ */
+const char* ListMode_GetStateName(ListMode_State_t state)
+{
+    static const char* const names[] = { "EMPTY", "LOADING", "READY", "RUNNING", "DONE" };
+    
+    return (state <= LIST_STATE_DONE) ? names[state] : "UNKNOWN";
+}
+
+/* ============================= */
+/* INTERRUPT HANDLER             */
+/* ============================= */
+
+/**
+ * @brief TIM5 Interrupt Handler
+ */
+void TIM5_IRQHandler(void)
+{
+    if (TIM5->SR & TIM_SR_UIF)
+    {
+        TIM5->SR = ~TIM_SR_UIF;
+        ListMode_Step();
+    }
+}
@@ -0,0 +1,312 @@
+/**
+ * Deferred Binary Logger
+ * Lock-free for the consumer, interrupt-masked reservation for producers
+ */
+
+#include "logger.h"
+#include "fmt.h"
+#include "hal_timer.h"
+#include "hal_uart.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Record ring - power of two */
+#define LOG_RING_SIZE 128
+
+/* Longest decoded line in text mode */
+#define LOG_LINE_SIZE 160
+
+static Log_Record_t log_ring[LOG_RING_SIZE];
+static volatile uint32_t log_head = 0;     /* Next slot to write */
+static volatile uint32_t log_tail = 0;     /* Next slot to read */
+static volatile uint32_t log_dropped = 0;
+static Log_Mode_t log_mode = LOG_MODE_TEXT;
+
+volatile uint8_t log_level = LOG_LEVEL_INFO;
+
+/* Format string table bounds (linker script) */
+extern const char __logstr_start__[];
+extern const char __logstr_end__[];
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Initialize logger
+ */
+void Log_Init(void)
+{
+    log_head = 0;
+    log_tail = 0;
+    log_dropped = 0;
+}
+
+/* ============================= */
+/* PRODUCER                      */
+/* ============================= */
+
+/**
+ * @brief Store a log record (no formatting)
+ * @param level Record level
+ * @param fmt Format string located in .logstr
+ * @param args Raw argument words
+ * @param nargs Number of arguments (truncated to LOG_MAX_ARGS)
+ */
+void Log_Write(uint8_t level, const char* fmt, const uint32_t* args, uint8_t nargs)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (log_head - log_tail >= LOG_RING_SIZE)
+    {
+        log_dropped++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    
+    Log_Record_t* record = &log_ring[log_head & (LOG_RING_SIZE - 1)];
+    
+    if (nargs > LOG_MAX_ARGS)
+        nargs = LOG_MAX_ARGS;
+    
+    record->timestamp_us = Timer_GetMicros();
+    record->id = (uint16_t)(fmt - __logstr_start__);
+    record->level = level;
+    record->nargs = nargs;
+    for (uint8_t i = 0; i < nargs; i++)
+        record->args[i] = args[i];
+    
+    __DMB();
+    log_head++;
+    
+    __set_PRIMASK(primask);
+}
+
+/* ============================= */
+/* CONSUMER                      */
+/* ============================= */
+
+/**
+ * @brief Pop the oldest record (single consumer)
+ * @return false if the ring is empty
+ */
+bool Log_Read(Log_Record_t* record)
+{
+    if (log_tail == log_head)
+        return false;
+    
+    *record = log_ring[log_tail & (LOG_RING_SIZE - 1)];
+    
+    __DMB();
+    log_tail++;
+    return true;
+}
+
+/**
+ * @brief Resolve a format string ID
+ */
+const char* Log_GetFormat(uint16_t id)
+{
+    if (__logstr_start__ + id >= __logstr_end__)
+        return "<bad log id>";
+    
+    return __logstr_start__ + id;
+}
+
+/**
+ * @brief Format one record into a line buffer
+ *
+ * Each conversion is re-issued to snprintf with the stored word cast to
+ * the matching type; length modifiers are dropped since all arguments
+ * are 32-bit. Floats go through the fmt module in fixed notation (the
+ * precision is kept, width and flags are not), so printf carries no
+ * floating-point support.
+ */
+static void Log_Format(const Log_Record_t* record, char* line, size_t size)
+{
+    const char* fmt = Log_GetFormat(record->id);
+    size_t pos = 0;
+    uint8_t arg = 0;
+    
+    while (*fmt != '\0' && pos < size - 1)
+    {
+        if (*fmt != '%')
+        {
+            line[pos++] = *fmt++;
+            continue;
+        }
+        
+        /* Collect "%[flags][width][.prec]" and the conversion character */
+        char spec[16];
+        size_t len = 0;
+        spec[len++] = *fmt++;
+        
+        while (*fmt != '\0' && strchr("-+ #0123456789.lhz", *fmt) != NULL)
+        {
+            if (*fmt != 'l' && *fmt != 'h' && *fmt != 'z' && len < sizeof(spec) - 2)
+                spec[len++] = *fmt;
+            fmt++;
+        }
+        
+        char conv = *fmt;
+        if (conv == '\0')
+            break;
+        fmt++;
+        
+        spec[len++] = conv;
+        spec[len] = '\0';
+        
+        if (conv == '%')
+        {
+            line[pos++] = '%';
+            continue;
+        }
+        
+        uint32_t word = (arg < record->nargs) ? record->args[arg] : 0;
+        arg++;
+        
+        int n;
+        switch (conv)
+        {
+            case 'd':
+            case 'i':
+            case 'c':
+                n = snprintf(&line[pos], size - pos, spec, (int)(int32_t)word);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            {
+                const char* dot = strchr(spec, '.');
+                uint8_t decimals = (dot != NULL) ? (uint8_t)atoi(dot + 1) : 6;
+                Fmt_Buffer_t out;
+                float value;
+                
+                memcpy(&value, &word, sizeof(value));
+                Fmt_Init(&out, &line[pos], size - pos - 1);
+                Fmt_Double(&out, value, decimals);
+                n = (int)out.length;
+                break;
+            }
+            case 's':
+                n = snprintf(&line[pos], size - pos, spec, (const char*)(uintptr_t)word);
+                break;
+            default:
+                n = snprintf(&line[pos], size - pos, spec, (unsigned int)word);
+                break;
+        }
+        
+        if (n < 0)
+            break;
+        pos += ((size_t)n < size - pos) ? (size_t)n : size - pos - 1;
+    }
+    
+    line[pos] = '\0';
+}
+
+/**
+ * @brief Send the oldest record to the UART
+ * @return false if the ring was empty
+ */
+bool Log_ProcessOne(void)
+{
+    Log_Record_t record;
+    
+    if (!Log_Read(&record))
+        return false;
+    
+    if (log_mode == LOG_MODE_BINARY)
+    {
+        uint8_t sync = LOG_FRAME_SYNC;
+        size_t length = sizeof(record) - sizeof(record.args) +
+                        record.nargs * sizeof(record.args[0]);
+        
+        UART_SendBuffer(&sync, 1);
+        UART_SendBuffer((const uint8_t*)&record, length);
+    }
+    else
+    {
+        char line[LOG_LINE_SIZE];
+        
+        Log_Format(&record, line, sizeof(line));
+        printf("%s", line);
+        fflush(stdout);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Drain the ring to the UART
+ */
+void Log_Process(void)
+{
+    while (Log_ProcessOne())
+    {
+    }
+}
+
+/* ============================= */
+/* CONFIGURATION                 */
+/* ============================= */
+
+/**
+ * @brief Set runtime log level
+ */
+void Log_SetLevel(uint8_t level)
+{
+    if (level > LOG_LEVEL_DEBUG)
+        level = LOG_LEVEL_DEBUG;
+    
+    log_level = level;
+}
+
+/**
+ * @brief Get runtime log level
+ */
+uint8_t Log_GetLevel(void)
+{
+    return log_level;
+}
+
+/**
+ * @brief Select on-device (text) or host (binary) decoding
+ */
+void Log_SetMode(Log_Mode_t mode)
+{
+    log_mode = mode;
+}
+
+/**
+ * @brief Get output mode
+ */
+Log_Mode_t Log_GetMode(void)
+{
+    return log_mode;
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get number of records waiting to be output
+ */
+uint32_t Log_GetPending(void)
+{
+    return log_head - log_tail;
+}
+
+/**
+ * @brief Get number of records dropped because the ring was full
+ */
+uint32_t Log_GetDropped(void)
+{
+    return log_dropped;
+}
@@ -12,29 +12,197 @@
  */
 
 #include "main.h"
+#include "hal_adc.h"
+#include "hal_gpio.h"
+#include "hal_timer.h"
+#include "hal_uart.h"
+#include "attenuator.h"
+#include "bench.h"
+#include "boot_profile.h"
+#include "calibration.h"
+#include "clock.h"
+#include "fmt.h"
+#include "fsk.h"
+#include "list_mode.h"
+#include "logger.h"
+#include "max2871.h"
+#include "power.h"
+#include "pulse.h"
+#include "recorder.h"
+#include "state_journal.h"
+#include "system_state.h"
+#include "vco_cal.h"
+#include <math.h>
 
 /* FreeRTOS Includes */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
 #include "semphr.h"
+#include "timers.h"
+#include "rtos_config.h"
 
 /* ============================= */
 /* GLOBAL STATE VARIABLES       */
 /* ============================= */
-static uint32_t current_frequency = 2400000000UL;
-static int8_t current_power = 0;
-static bool rf_enabled = false;
 
-static double system_temperature = 25.0;
-static double system_voltage = 5.0;
-static double system_current = 0.0;
+/* RF settings and monitor readings live in the shared state block
+ * (system_state.h); these are the power-on values */
+static const SystemState_t default_state = {
+    .frequency = FREQUENCY_HZ(2400000000UL),
+    .power_dbm = 0,
+    .rf_enabled = false,
+    .temperature = 25.0,
+    .voltage = 5.0,
+    .current = 0.0,
+};
 
 /* FreeRTOS handles */
 static TaskHandle_t monitor_task_handle = NULL;
 static TaskHandle_t rf_control_task_handle = NULL;
 static TaskHandle_t command_task_handle = NULL;
+static TaskHandle_t log_task_handle = NULL;
 static SemaphoreHandle_t uart_semaphore = NULL;
+static TimerHandle_t journal_timer = NULL;
+
+/* Statically allocated RTOS objects (sizes from rtos_config.h) */
+static StackType_t monitor_task_stack[TASK_MONITOR_STACK_WORDS];
+static StaticTask_t monitor_task_tcb;
+static StackType_t rf_control_task_stack[TASK_RFCONTROL_STACK_WORDS];
+static StaticTask_t rf_control_task_tcb;
+static StackType_t command_task_stack[TASK_COMMAND_STACK_WORDS];
+static StaticTask_t command_task_tcb;
+static StackType_t log_task_stack[TASK_LOG_STACK_WORDS];
+static StaticTask_t log_task_tcb;
+static StackType_t idle_task_stack[TASK_IDLE_STACK_WORDS];
+static StaticTask_t idle_task_tcb;
+static StackType_t timer_task_stack[TASK_TIMER_STACK_WORDS];
+static StaticTask_t timer_task_tcb;
+static StaticSemaphore_t uart_semaphore_buffer;
+static StaticTimer_t journal_timer_buffer;
+
+/* State journal writes are coalesced over this quiet period */
+#define JOURNAL_COALESCE_MS 20
+
+/* A failed journal write (FRAM busy or faulty) is retried this often */
+#define JOURNAL_RETRY_MS 1000
+
+/* Monitor cadence: fast with RF on, slow when parked and thermally stable */
+#define MONITOR_PERIOD_FAST_MS 250
+#define MONITOR_PERIOD_NORMAL_MS 1000
+#define MONITOR_PERIOD_SLOW_MS 5000
+#define MONITOR_STABLE_DELTA_C 0.5
+
+/* Log drain period while records are arriving / while quiet */
+#define LOG_PERIOD_BUSY_MS 20
+#define LOG_PERIOD_IDLE_MS 250
+
+/* LogTask notification: the journal quiet period ended, write FRAM */
+#define LOG_EVENT_JOURNAL 0x01
+
+/* Host must send the SYS:BAUD:PING probe at the new rate within this */
+#define BAUD_VERIFY_TIMEOUT_MS 1000
+
+/* LIST:DATA gives up if the host goes quiet for this long mid-block */
+#define LIST_RX_TIMEOUT_MS 1000
+
+/* RFControlTask checks a running list or power sweep this often (TIM5
+ * cannot notify; TIM4 does not need to) */
+#define RF_LIST_POLL_MS 10
+
+/* FSK:DATA waits at most this long for buffer room, then replies busy and
+ * the host retries - CommandTask must stay free to take FSK:STOP */
+#define FSK_SPACE_WAIT_MS 100
+
+/* Longest reply built with the fmt module (SYS:LAT?) */
+#define REPLY_BUFFER_SIZE 160
+
+/* *OPC? gives up if the RF mailbox has not drained by then */
+#define OPC_TIMEOUT_MS 1000
+
+/* RFControlTask notification bits */
+#define RF_EVENT_REQUEST    0x01    /* RF mailbox has work */
+#define RF_EVENT_LOCK       0x02    /* Lock detect changed */
+#define RF_EVENT_ALL        0x03
+
+/* RF mailbox - fields pending and their latest values */
+#define RF_REQ_FREQUENCY    0x01
+#define RF_REQ_POWER        0x02
+#define RF_REQ_OUTPUT       0x04
+#define RF_REQ_SCHEDULE     0x08    /* Timed retune, committed by the TIM2 alarm */
+#define RF_REQ_VCOCAL       0x10    /* Learn the VCO band table */
+#define RF_REQ_LIST         0x20    /* Run the loaded point list */
+#define RF_REQ_FSK          0x40    /* Start FSK modulation */
+#define RF_REQ_PSWEEP       0x80    /* Start a power sweep */
+#define RF_REQ_CANCEL       0x100   /* Cancel the scheduled retune */
+#define RF_REQ_FSK_STOP     0x200   /* Stop the FSK stream */
+#define RF_REQ_LIST_STOP    0x400   /* Stop the list run */
+#define RF_REQ_PSWEEP_STOP  0x800   /* Stop the power sweep */
+
+/* Everything but the output switch while a list, FSK or an armed commit
+ * owns the synthesizer (and with it SPI1) */
+#define RF_REQ_SYNTH_OWNED  (RF_REQ_FREQUENCY | RF_REQ_POWER | RF_REQ_SCHEDULE | \
+                             RF_REQ_VCOCAL | RF_REQ_LIST | RF_REQ_FSK | RF_REQ_PSWEEP)
+
+/* Held while a power sweep owns the attenuator and the power mode */
+#define RF_REQ_ATTEN_OWNED  (RF_REQ_POWER | RF_REQ_LIST | RF_REQ_FSK | RF_REQ_PSWEEP)
+
+typedef struct {
+    uint16_t fields;
+    MAX2871_Registers_t image;      /* Pre-solved on the posting side */
+    int8_t power_dbm;
+    bool enable;
+    MAX2871_Registers_t scheduled;  /* RF_REQ_SCHEDULE image and commit time */
+    uint32_t at_us;
+    uint32_t list_loops;            /* RF_REQ_LIST passes, 0 = until stopped */
+    Attenuator_SweepConfig_t sweep; /* RF_REQ_PSWEEP levels and dwell */
+} RF_Request_t;
+
+typedef struct {
+    uint32_t posted;
+    uint32_t applied;
+    uint32_t coalesced;             /* Requests superseded before being applied */
+    uint32_t last_apply_us;
+} RF_QueueStats_t;
+
+static RF_Request_t rf_pending;
+static RF_QueueStats_t rf_queue_stats;
+
+/* Scheduled commit handed to the driver, and its commit count at arming */
+static bool rf_commit_armed = false;
+static uint32_t rf_commit_base = 0;
+
+/* List run started by RFControlTask; TIM5 owns the synthesizer meanwhile */
+static bool rf_list_running = false;
+
+/* FSK stream started by RFControlTask; the TIM3 DMA owns SPI1 meanwhile */
+static bool rf_fsk_running = false;
+
+/* Power sweep started by RFControlTask; the TIM4 DMA owns the attenuator */
+static bool rf_sweep_running = false;
+
+/* Clock profile switch held back while one of the runs above is active */
+static bool rf_profile_deferred = false;
+
+/* Command latency, line terminator received to reply queued for TX */
+typedef struct {
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t max_us;
+} Command_Latency_t;
+
+static Command_Latency_t query_latency;
+static Command_Latency_t set_latency;
+
+/* Reply being built - only CommandTask replies, under the console lock */
+static char reply_data[REPLY_BUFFER_SIZE];
+static Fmt_Buffer_t reply;
+
+/* Boot instrumentation (device microseconds since Timer_Init) */
+static uint32_t boot_rf_ready_us = 0;
+
+/* Current monitor period, reported by SYS:POWER? */
+static volatile uint32_t monitor_period_ms = MONITOR_PERIOD_NORMAL_MS;
 
 /* ============================= */
 /* FORWARD DECLARATIONS          */
@@ -42,7 +210,41 @@ static SemaphoreHandle_t uart_semaphore = NULL;
 static void MonitorTask(void *pvParameters);
 static void RFControlTask(void *pvParameters);
 static void CommandTask(void *pvParameters);
+static void LogTask(void *pvParameters);
 static void ProcessCommand(const char* command);
+static void SystemInitDeferred(void);
+static void RF_LockCallback(bool locked);
+static void CommandLineCallback(void);
+static void Command_NegotiateBaud(uint32_t baud);
+static void Command_RecorderArm(const char* args);
+static void Command_RecorderData(uint32_t first);
+static void Command_WaitComplete(void);
+static void Command_CachePreload(const char* list);
+static void Command_ListData(const char* args);
+static size_t Command_ReadRaw(uint8_t* data, size_t length);
+static bool Command_IsQuery(const char* command);
+static Fmt_Buffer_t* Command_BeginReply(void);
+static void Command_SendReply(void);
+static void Console_Lock(void);
+static void Console_Unlock(void);
+static void RF_Post(const RF_Request_t* request);
+static void RF_ApplyPower(int8_t power_dbm, Frequency_t frequency);
+static void RF_RefreshPower(void);
+static void RF_ApplyPending(void);
+static void RF_SettleClockProfile(bool output_on);
+static bool RF_CheckCommit(void);
+static bool RF_CheckList(void);
+static bool RF_IsListBusy(void);
+static bool RF_CheckFsk(void);
+static bool RF_IsFskBusy(void);
+static bool RF_CheckSweep(void);
+static bool RF_IsSweepBusy(void);
+static bool Command_ReadBlockHeader(uint32_t* length);
+static void Command_FskData(const char* args);
+static void Command_PowerSweep(const char* args);
+static TickType_t RF_CommitWait(void);
+static void RF_JournalState(void);
+static void JournalTimerCallback(TimerHandle_t xTimer);
 
 /* ============================= */
 /* SYSTEM INITIALIZATION         */
@@ -50,49 +252,135 @@ static void ProcessCommand(const char* command);
 
 /**
  * @brief Initialize entire system
+ *
+ * Only what is needed to get RF back is done here. Independent stages
+ * overlap: the journal FRAM read runs by DMA and the ADC calibrates in
+ * hardware while the synthesizer is brought up. Console output and the
+ * calibration table are deferred until the scheduler is running.
  */
 void SystemInit(void)
 {
-    /* Initialize hardware in correct order */
+    StateJournal_State_t restored;
+    SystemState_t state = default_state;
+    
+    /* 0. Timebase first (reset HSI clocks), so the RCC/PLL timeouts in the
+     * clock setup count; then the clock tree (full speed for boot), which
+     * re-times the timebase to it */
+    HAL_Init();
+    Timer_Init();
+    Clock_Init(CLOCK_PROFILE_PERFORMANCE);
+    Power_Init();
+    Log_Init();
+    BootProfile_Mark(BOOT_STAGE_TIMEBASE);
+    
+    /* 1. GPIO initialization - RF output held off, full attenuation */
+    GPIO_Init();
+    Attenuator_Init();
+    BootProfile_Mark(BOOT_STAGE_GPIO);
     
-    /* 1. UART first (for debugging/commands) */
+    /* 2. I2C + FRAM, start reading the state journal in the background */
+    I2C_Init();
+    FRAM_Init();
+    StateJournal_Init();
+    bool journal_reading = StateJournal_RestoreStart();
+    BootProfile_Mark(BOOT_STAGE_FRAM);
+    
+    /* 3. ADC configuration, self-calibration runs in the background */
+    ADC_Init();
+    
+    /* 4. RF synthesizer SPI + lock detect */
+    MAX2871_Init();
+    MAX2871_SetLockCallback(RF_LockCallback);
+    BootProfile_Mark(BOOT_STAGE_SYNTH);
+    
+    /* 5. Protection armed before RF can be enabled */
+    ADC_StartConversion();
+    BootProfile_Mark(BOOT_STAGE_ADC);
+    
+    /* 6. Restore last RF state from the FRAM journal */
+    if (journal_reading && StateJournal_RestoreFinish(&restored) &&
+        restored.frequency >= RF_FREQ_MIN && restored.frequency <= RF_FREQ_MAX &&
+        restored.power_dbm >= RF_POWER_MIN && restored.power_dbm <= RF_POWER_MAX)
+    {
+        state.frequency = restored.frequency;
+        state.power_dbm = restored.power_dbm;
+        state.rf_enabled = restored.rf_enabled;
+        LOG_INFO("RF state restored from journal\n");
+    }
+    SystemState_Init(&state);
+    BootProfile_Mark(BOOT_STAGE_JOURNAL);
+    
+    /* 7. Back on frequency, output power mode selected before the first write */
+    Attenuator_SetPower(state.power_dbm);
+    MAX2871_SetFrequency(state.frequency);
+    if (state.rf_enabled)
+    {
+        GPIO_SetRFOutput(true);
+        GPIO_SetStatusLED(true);
+    }
+    boot_rf_ready_us = Timer_GetMicros();
+    BootProfile_Mark(BOOT_STAGE_RF_READY);
+    
+    /* 8. UART for commands (banner is printed once the scheduler runs) */
     UART_Init();
+    
+    /* 9. Create UART semaphore - held while a task prints a reply or log line */
+    uart_semaphore = xSemaphoreCreateMutexStatic(&uart_semaphore_buffer);
+    
+    /* 10. Coalescing timer for state journal writes */
+    journal_timer = xTimerCreateStatic("Journal",
+                                       pdMS_TO_TICKS(JOURNAL_COALESCE_MS),
+                                       pdFALSE,
+                                       NULL,
+                                       JournalTimerCallback,
+                                       &journal_timer_buffer);
+}
+
+/**
+ * @brief Non-critical initialization, run once the scheduler has started
+ */
+static void SystemInitDeferred(void)
+{
+    SystemState_t state;
+    
+    /* Calibration table is not needed to restore RF; the restored power
+     * is corrected once it is loaded */
+    Calibration_Init();
+    Calibration_LoadFromFRAM();
+    RF_RefreshPower();
+    VcoCal_Init();
+    Recorder_Init();
+    ListMode_Init();
+    Pulse_Init();
+    Fsk_Init();
+    
+    Console_Lock();
     printf("\n");
     printf("====================================\n");
     printf("Frequency Generator Control System\n");
     printf("STM32H743 + MAX2871\n");
     printf("v1.0.0\n");
     printf("====================================\n\n");
-    
-    /* 2. GPIO initialization */
-    GPIO_Init();
     printf("[OK] GPIO initialized\n");
-    
-    /* 3. ADC initialization */
-    ADC_Init();
-    printf("[OK] ADC initialized\n");
-    
-    /* 4. I2C initialization */
-    I2C_Init();
     printf("[OK] I2C initialized\n");
-    
-    /* 5. Calibration initialization */
-    Calibration_Init();
-    printf("[OK] Calibration initialized\n");
-    
-    /* 6. Load calibration from FRAM */
-    Calibration_LoadFromFRAM();
+    printf("[OK] ADC initialized%s\n", ADC_IsCalibrated() ? "" : " (uncalibrated)");
+    printf("[OK] MAX2871 RF Synthesizer initialized\n");
     printf("[OK] Calibration loaded from FRAM\n");
+    printf("[OK] VCO band %s\n", VcoCal_GetStatus().enabled ? "table loaded" : "autoselect");
+    printf("[OK] RF ready at %lu us\n", boot_rf_ready_us);
+    Console_Unlock();
     
-    /* 7. RF subsystem initialization */
-    MAX2871_Init();
-    printf("[OK] MAX2871 RF Synthesizer initialized\n");
+    /* Parked at boot - drop to the low-power clock profile */
+    SystemState_Read(&state);
+    if (!state.rf_enabled)
+        Clock_SetProfile(CLOCK_PROFILE_LOW_POWER);
     
-    /* 8. Create UART semaphore for thread-safe printf */
-    uart_semaphore = xSemaphoreCreateMutex();
+    BootProfile_Mark(BOOT_STAGE_DEFERRED);
     
+    Console_Lock();
     printf("\nSystem initialization complete!\n");
     printf("Ready for commands...\n\n");
+    Console_Unlock();
 }
 
 /**
@@ -107,8 +395,15 @@ void SystemDeInit(void)
     printf("[OK] RF output disabled\n");
     
     /* Save calibration to FRAM */
-    Calibration_SaveToFRAM();
-    printf("[OK] Calibration saved to FRAM\n");
+    if (Calibration_SaveToFRAM())
+        printf("[OK] Calibration saved to FRAM\n");
+    else
+        printf("[ERROR] Calibration save failed\n");
+    
+    /* The journal write LogTask would do, done here before it goes */
+    if (journal_timer != NULL)
+        xTimerStop(journal_timer, 0);
+    StateJournal_Flush();
     
     /* Delete FreeRTOS tasks */
     if (monitor_task_handle != NULL)
@@ -117,6 +412,11 @@ void SystemDeInit(void)
         vTaskDelete(rf_control_task_handle);
     if (command_task_handle != NULL)
         vTaskDelete(command_task_handle);
+    if (log_task_handle != NULL)
+    {
+        vTaskDelete(log_task_handle);
+        log_task_handle = NULL;
+    }
     
     printf("System shutdown complete\n");
 }
@@ -127,61 +427,144 @@ void SystemDeInit(void)
 
 /**
  * @brief Monitor task - reads sensors every 1 second
+ *
+ * Over-temperature and over-current shutdown are handled by the ADC
+ * analog watchdogs in interrupt context; this task only reports.
  */
 static void MonitorTask(void *pvParameters)
 {
     TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(1000);
+    uint8_t reported_faults = ADC_FAULT_NONE;
+    bool temp_warning = false;
+    SystemState_t state;
     
-    printf("[MonitorTask] Started\n");
+    SystemState_Read(&state);
+    double last_temperature = state.temperature;
     
-    /* Start ADC conversion */
-    ADC_StartConversion();
+    LOG_INFO("[MonitorTask] Started\n");
     
     while (1)
     {
         /* Update sensor readings */
         Monitor_Update();
+        SystemState_Read(&state);
+        
+        /* Report protection trips (RF already cut by the watchdog ISR) */
+        ADC_FaultStatus_t fault = ADC_GetFaultStatus();
+        if (fault.latched != reported_faults)
+        {
+            if (fault.latched & ~reported_faults)
+            {
+                /* Hand the shutdown to the RF owner (LED, clocks, journal) */
+                RF_Request_t request;
+                request.fields = RF_REQ_OUTPUT;
+                request.enable = false;
+                RF_Post(&request);
+                state.rf_enabled = false;
+                LOG_ERROR("[ERROR] PROTECTION SHUTDOWN! Fault=0x%02X Temp=%.1f°C Curr=%.2fA\n",
+                          fault.latched, LOG_F(state.temperature), LOG_F(state.current));
+            }
+            reported_faults = fault.latched;
+        }
         
-        /* Check thermal shutdown */
-        if (system_temperature > TEMP_SHUTDOWN)
+        /* Temperature warning - report transitions only */
+        if (!temp_warning && state.temperature > TEMP_WARNING)
         {
-            RF_Enable(false);
-            printf("[ERROR] THERMAL SHUTDOWN! Temp=%.1f°C\n", system_temperature);
+            temp_warning = true;
+            LOG_WARN("[WARNING] High temperature: %.1f°C\n", LOG_F(state.temperature));
         }
-        /* Check temperature warning */
-        else if (system_temperature > TEMP_WARNING)
+        else if (temp_warning && state.temperature < TEMP_WARNING - 5)
         {
-            printf("[WARNING] High temperature: %.1f°C\n", system_temperature);
+            temp_warning = false;
         }
         
+        Power_SampleCurrent(state.current, !state.rf_enabled);
+        
+        /* Adaptive cadence - protection itself is in the ADC watchdog ISR */
+        uint32_t period_ms;
+        if (state.rf_enabled)
+            period_ms = MONITOR_PERIOD_FAST_MS;
+        else if (fabs(state.temperature - last_temperature) < MONITOR_STABLE_DELTA_C)
+            period_ms = MONITOR_PERIOD_SLOW_MS;
+        else
+            period_ms = MONITOR_PERIOD_NORMAL_MS;
+        last_temperature = state.temperature;
+        monitor_period_ms = period_ms;
+        
         /* Periodic wait */
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(period_ms));
     }
 }
 
 /**
- * @brief RF control task - maintains RF output
+ * @brief RF control task - sole owner of the synthesizer, attenuator and
+ * RF output after boot
+ *
+ * Applies requests from the RF mailbox and reports PLL lock state
+ * changes. Blocks on task notification bits; there is no periodic wakeup.
  */
 static void RFControlTask(void *pvParameters)
 {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(500);
+    bool was_locked = MAX2871_IsPLLLocked();
+    uint32_t events;
     
-    printf("[RFControlTask] Started\n");
+    LOG_INFO("[RFControlTask] Started\n");
     
     while (1)
     {
-        /* Check PLL lock if RF is enabled */
-        if (rf_enabled)
+        /* The commit and list ISRs cannot notify (they run above the
+         * RTOS), so their completion is picked up by timeout */
+        events = 0;
+        xTaskNotifyWait(0, RF_EVENT_ALL, &events, RF_CommitWait());
+        
+        bool settled = RF_CheckCommit();
+        settled |= RF_CheckList();
+        settled |= RF_CheckFsk();
+        settled |= RF_CheckSweep();
+        
+        if (settled || (events & RF_EVENT_REQUEST))
+            RF_ApplyPending();
+        
+        /* A profile switch held back by a run catches up once it ends */
+        if (rf_profile_deferred)
+            RF_SettleClockProfile(GPIO_GetRFOutput());
+        
+        if ((events & RF_EVENT_LOCK) == 0)
+            continue;
+        
+        MAX2871_LockStats_t stats = MAX2871_GetLockStats();
+        SystemState_t state;
+        SystemState_Read(&state);
+        
+        if (was_locked && !stats.locked && state.rf_enabled)
         {
-            if (!MAX2871_IsPLLLocked())
-            {
-                printf("[WARNING] PLL not locked at %.0f Hz\n", (double)current_frequency);
-            }
+            LOG_WARN("[WARNING] PLL lock lost at %lu kHz (events=%lu)\n",
+                     Frequency_ToKHz(state.frequency), stats.unlock_events);
+        }
+        else if (!was_locked && stats.locked && state.rf_enabled)
+        {
+            LOG_INFO("[RFControlTask] PLL locked\n");
         }
         
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        was_locked = stats.locked;
+    }
+}
+
+/**
+ * @brief MAX2871 lock detect callback (ISR context)
+ */
+static void RF_LockCallback(bool locked)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    
+    if (!locked)
+        Recorder_Trigger(REC_TRIGGER_LOCK);
+    
+    if (rf_control_task_handle != NULL)
+    {
+        xTaskNotifyFromISR(rf_control_task_handle, RF_EVENT_LOCK, eSetBits,
+                           &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
 }
 
@@ -190,114 +573,1331 @@ static void RFControlTask(void *pvParameters)
  */
 static void CommandTask(void *pvParameters)
 {
-    printf("[CommandTask] Started - waiting for commands...\n");
+    SystemInitDeferred();
+    
+    LOG_INFO("[CommandTask] Started - waiting for commands...\n");
+    
+    /* Woken by the UART RX interrupt at each line terminator */
+    UART_SetLineCallback(CommandLineCallback);
     
     while (1)
     {
-        /* Wait for incoming command */
-        char* command = UART_ReceiveString();
+        char* command;
         
-        if (command != NULL && strlen(command) > 0)
+        while ((command = UART_ReceiveString()) != NULL)
         {
+            uint32_t received_us = UART_GetLineTimestamp();
+            Command_Latency_t* latency = Command_IsQuery(command) ?
+                                         &query_latency : &set_latency;
+            
+            Console_Lock();
             ProcessCommand(command);
+            Console_Unlock();
+            
+            uint32_t elapsed_us = Timer_GetMicros() - received_us;
+            latency->count++;
+            latency->last_us = elapsed_us;
+            if (elapsed_us > latency->max_us)
+                latency->max_us = elapsed_us;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(10));
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
 }
 
-/* ============================= */
-/* RF CONTROL IMPLEMENTATION     */
-/* ============================= */
+/**
+ * @brief Check whether a command is a query answered from a snapshot
+ * The keyword ends in '?'. *OPC? is left out - it waits on purpose.
+ */
+static bool Command_IsQuery(const char* command)
+{
+    size_t length = strcspn(command, " ");
+    
+    if (strcmp(command, "*OPC?") == 0)
+        return false;
+    
+    return length > 0 && command[length - 1] == '?';
+}
 
 /**
- * @brief Initialize RF subsystem
+ * @brief Start a reply in the reply buffer
  */
-void RF_Init(void)
+static Fmt_Buffer_t* Command_BeginReply(void)
 {
-    MAX2871_Init();
-    printf("[OK] RF subsystem initialized\n");
+    Fmt_Init(&reply, reply_data, sizeof(reply_data));
+    return &reply;
+}
+
+/**
+ * @brief Queue the reply for TX in one piece, after any buffered output
+ */
+static void Command_SendReply(void)
+{
+    fflush(stdout);
+    UART_SendBuffer((const uint8_t*)reply.data, reply.length);
+}
+
+/**
+ * @brief Take the console for one reply or log record
+ * Replies and log lines are queued for TX whole, never interleaved.
+ */
+static void Console_Lock(void)
+{
+    xSemaphoreTake(uart_semaphore, portMAX_DELAY);
+}
+
+/**
+ * @brief Push out the buffered line and release the console
+ */
+static void Console_Unlock(void)
+{
+    fflush(stdout);
+    xSemaphoreGive(uart_semaphore);
+}
+
+/**
+ * @brief Command line received (UART RX ISR context)
+ */
+static void CommandLineCallback(void)
+{
+    BaseType_t higher_priority_woken = pdFALSE;
+    
+    if (command_task_handle != NULL)
+        vTaskNotifyGiveFromISR(command_task_handle, &higher_priority_woken);
+    
+    portYIELD_FROM_ISR(higher_priority_woken);
+}
+
+/**
+ * @brief Switch the link baud rate and wait for the host to confirm it
+ *
+ * The acknowledge goes out at the old rate, then the UART switches. The
+ * host has BAUD_VERIFY_TIMEOUT_MS to send SYS:BAUD:PING at the new rate;
+ * anything else (including noise from the switch) is ignored. Without a
+ * probe the old rate is restored.
+ */
+static void Command_NegotiateBaud(uint32_t baud)
+{
+    uint32_t old_baud = UART_GetConfiguredBaud();
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(BAUD_VERIFY_TIMEOUT_MS);
+    bool verified = false;
+    
+    if (!UART_IsBaudSupported(baud))
+    {
+        printf("ERROR: Unsupported baud rate\n");
+        return;
+    }
+    
+    printf("OK\n");
+    UART_SetBaudRate(baud);
+    
+    while (!verified && (xTaskGetTickCount() - start) < timeout)
+    {
+        char* line;
+        
+        ulTaskNotifyTake(pdTRUE, timeout - (xTaskGetTickCount() - start));
+        
+        while ((line = UART_ReceiveString()) != NULL)
+        {
+            if (strcmp(line, "SYS:BAUD:PING") == 0)
+            {
+                verified = true;
+                break;
+            }
+        }
+    }
+    
+    if (verified)
+    {
+        printf("BAUD:%lu\n", baud);
+        LOG_INFO("Link switched to %lu baud\n", baud);
+    }
+    else
+    {
+        UART_SetBaudRate(old_baud);
+        LOG_WARN("Baud switch to %lu not verified - back to %lu\n", baud, old_baud);
+    }
+}
+
+/**
+ * @brief Warm the solve cache from a comma-separated frequency list
+ * Frequencies before an invalid one stay loaded.
+ */
+static void Command_CachePreload(const char* list)
+{
+    const char* next = list;
+    
+    while (*next != '\0')
+    {
+        char* end;
+        Frequency_t freq;
+        
+        if (!Frequency_Parse(next, &end, &freq) || freq < RF_FREQ_MIN || freq > RF_FREQ_MAX ||
+            !MAX2871_CachePreload(freq))
+        {
+            printf("ERROR: Frequency out of range\n");
+            return;
+        }
+        
+        next = (*end == ',') ? end + 1 : end;
+    }
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief *OPC? - reply once every RF request accepted so far is applied
+ * Called with the console locked; it is released while waiting.
+ */
+static void Command_WaitComplete(void)
+{
+    TickType_t start = xTaskGetTickCount();
+    SystemState_t state;
+    bool done = true;
+    
+    /* The console is only needed for the reply - other tasks log meanwhile */
+    Console_Unlock();
+    
+    SystemState_Read(&state);
+    while (state.rf_busy)
+    {
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(OPC_TIMEOUT_MS))
+        {
+            done = false;
+            break;
+        }
+        
+        vTaskDelay(1);
+        SystemState_Read(&state);
+    }
+    
+    Console_Lock();
+    printf(done ? "1\n" : "ERROR: Operation timeout\n");
+}
+
+/**
+ * @brief Arm a triggered recorder capture - "<source>,<pre>,<post>"
+ */
+static void Command_RecorderArm(const char* args)
+{
+    for (uint32_t source = REC_TRIGGER_LOCK; source <= REC_TRIGGER_MANUAL; source++)
+    {
+        const char* name = Recorder_GetTriggerName((Recorder_Trigger_t)source);
+        size_t length = strlen(name);
+        
+        if (strncmp(args, name, length) != 0 || args[length] != ',')
+            continue;
+        
+        char* next;
+        uint32_t pre = strtoul(&args[length + 1], &next, 10);
+        uint32_t post = (*next == ',') ? strtoul(next + 1, NULL, 10) : 0;
+        
+        if (Recorder_Start((Recorder_Trigger_t)source, pre, post))
+            printf("OK\n");
+        else
+            printf("ERROR: Capture exceeds ring (%lu samples max)\n", Recorder_GetCapacity());
+        return;
+    }
+    
+    printf("ERROR: Invalid trigger\n");
+}
+
+/**
+ * @brief Send one chunk of recorder blocks as an IEEE 488.2 definite-length block
+ *
+ * "#<digits><length>" precedes the binary data and a newline follows it.
+ * Each block is its header followed by header.length payload bytes.
+ */
+static void Command_RecorderData(uint32_t first)
+{
+    const Recorder_BlockHeader_t* block;
+    Recorder_State_t state = Recorder_GetStatus().state;
+    uint32_t length = 0;
+    uint32_t count = 0;
+    char size[12];
+    
+    if (state != REC_STATE_IDLE && state != REC_STATE_DONE)
+    {
+        printf("ERROR: Recorder running\n");
+        return;
+    }
+    
+    while (count < REC_CHUNK_BLOCKS && (block = Recorder_GetBlock(first + count)) != NULL)
+    {
+        length += sizeof(*block) + block->length;
+        count++;
+    }
+    
+    int digits = snprintf(size, sizeof(size), "%lu", length);
+    printf("#%d%s", digits, size);
+    fflush(stdout);
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        block = Recorder_GetBlock(first + i);
+        UART_SendBuffer((const uint8_t*)block, sizeof(*block) + block->length);
+    }
+    
+    printf("\n");
+}
+
+/**
+ * @brief Read raw bytes from the RX ring, yielding while it is empty
+ * @return Bytes read; short if the host went quiet for LIST_RX_TIMEOUT_MS
+ */
+static size_t Command_ReadRaw(uint8_t* data, size_t length)
+{
+    TickType_t last = xTaskGetTickCount();
+    size_t count = 0;
+    
+    while (count < length)
+    {
+        size_t received = UART_ReceiveAvailable(&data[count], length - count);
+        
+        if (received > 0)
+        {
+            count += received;
+            last = xTaskGetTickCount();
+        }
+        else if ((xTaskGetTickCount() - last) >= pdMS_TO_TICKS(LIST_RX_TIMEOUT_MS))
+        {
+            break;
+        }
+        else
+        {
+            /* One tick is 200 bytes at 2 Mbaud - well inside the RX ring */
+            vTaskDelay(1);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Switch to raw mode and read an IEEE 488.2 block header
+ * Skips the rest of the command line terminator, then "#<digits><length>".
+ * The caller reads the data and turns raw mode off.
+ * @return false if the header is malformed or the host went quiet
+ */
+static bool Command_ReadBlockHeader(uint32_t* length)
+{
+    uint8_t byte;
+    char digits[10];
+    
+    UART_SetRawMode(true);
+    
+    do
+    {
+        if (Command_ReadRaw(&byte, 1) != 1)
+            byte = 0;
+    } while (byte == '\r' || byte == '\n');
+    
+    *length = 0;
+    bool framed = (byte == '#') && Command_ReadRaw(&byte, 1) == 1 &&
+                  byte > '0' && byte <= '9';
+    if (framed)
+    {
+        size_t count = byte - '0';
+        
+        framed = Command_ReadRaw((uint8_t*)digits, count) == count;
+        for (size_t i = 0; framed && i < count; i++)
+            *length = *length * 10 + (uint32_t)(digits[i] - '0');
+    }
+    return framed;
+}
+
+/**
+ * @brief Upload a point list - "<points>,<crc>"
+ *
+ * After READY the host sends the points as one IEEE 488.2 definite-length
+ * block (#<digits><length><data>), the same framing REC:DATA? replies
+ * with. The block is consumed from the RX ring as it arrives, so its size
+ * is not limited by the ring; the reply follows once every point has been
+ * checked and solved.
+ */
+static void Command_ListData(const char* args)
+{
+    char* end;
+    uint32_t points = strtoul(args, &end, 10);
+    uint16_t crc = (uint16_t)strtoul((*end == ',') ? end + 1 : end, NULL, 0);
+    uint8_t chunk[64];
+    uint32_t length;
+    
+    if (RF_IsListBusy())
+    {
+        printf("ERROR: List running\n");
+        return;
+    }
+    
+    if (*end != ',' || !ListMode_BeginUpload(points))
+    {
+        printf("ERROR: Invalid point count\n");
+        return;
+    }
+    
+    printf("READY\n");
+    fflush(stdout);
+    
+    bool framed = Command_ReadBlockHeader(&length);
+    
+    if (framed && length == points * LIST_POINT_BYTES)
+    {
+        while (length > 0)
+        {
+            size_t wanted = (length < sizeof(chunk)) ? length : sizeof(chunk);
+            size_t received = Command_ReadRaw(chunk, wanted);
+            
+            ListMode_Receive(chunk, received);
+            length -= received;
+            if (received < wanted)
+                break;
+        }
+    }
+    
+    UART_SetRawMode(false);
+    
+    uint32_t bad_point = 0;
+    switch (ListMode_EndUpload(crc, &bad_point))
+    {
+        case LIST_LOAD_OK:
+            printf("OK\n");
+            break;
+        case LIST_LOAD_CRC:
+            printf("ERROR: CRC mismatch\n");
+            break;
+        case LIST_LOAD_RANGE:
+            printf("ERROR: Point %lu out of range\n", bad_point);
+            break;
+        default:
+            printf("ERROR: Upload incomplete\n");
+            break;
+    }
+}
+
+/**
+ * @brief Queue FSK symbols - "<bytes>"
+ *
+ * READY is sent once the symbol FIFO has room for the whole block, which
+ * paces the host to the symbol rate (busy if it has none within
+ * FSK_SPACE_WAIT_MS); the symbols follow as an IEEE 488.2
+ * definite-length block, two 4-bit symbols per byte.
+ */
+static void Command_FskData(const char* args)
+{
+    uint32_t bytes = strtoul(args, NULL, 10);
+    uint8_t chunk[64];
+    uint32_t length;
+    
+    if (bytes == 0 || bytes * 2 > FSK_FIFO_SYMBOLS)
+    {
+        printf("ERROR: Invalid symbol count\n");
+        return;
+    }
+    
+    /* Wait a little for the stream to drain far enough; at low symbol
+     * rates that takes minutes, so the host is told to retry instead */
+    TickType_t start = xTaskGetTickCount();
+    
+    while (Fsk_GetFree() < bytes * 2)
+    {
+        if (!Fsk_IsRunning() ||
+            (xTaskGetTickCount() - start) >= pdMS_TO_TICKS(FSK_SPACE_WAIT_MS))
+        {
+            printf("ERROR: Symbol buffer full\n");
+            return;
+        }
+        vTaskDelay(1);
+    }
+    
+    printf("READY\n");
+    fflush(stdout);
+    
+    bool framed = Command_ReadBlockHeader(&length) && length == bytes;
+    
+    while (framed && length > 0)
+    {
+        size_t wanted = (length < sizeof(chunk)) ? length : sizeof(chunk);
+        size_t received = Command_ReadRaw(chunk, wanted);
+        
+        Fsk_Write(chunk, received);
+        length -= received;
+        if (received < wanted)
+            break;
+    }
+    
+    UART_SetRawMode(false);
+    printf((framed && length == 0) ? "OK\n" : "ERROR: Upload incomplete\n");
+}
+
+/**
+ * @brief Parse a level in dB, rounded to the 0.5 dB attenuator step
+ */
+static bool Command_ParseHalfDb(const char* text, char** end, int32_t* level)
+{
+    double db = strtod(text, end);
+    
+    if (*end == text || db < RF_POWER_MIN - RF_POWER_MAX || db > RF_POWER_MAX - RF_POWER_MIN)
+        return false;
+    
+    *level = (int32_t)lround(db * 2.0);
+    return true;
+}
+
+/**
+ * @brief Start a power sweep - "<start>,<stop>,<step>,<dwell_us>[,REPEAT]"
+ * Levels and step in dB, 0.5 dB resolution.
+ */
+static void Command_PowerSweep(const char* args)
+{
+    Attenuator_SweepConfig_t config;
+    int32_t start, stop, step;
+    char* next;
+    
+    bool valid = Command_ParseHalfDb(args, &next, &start) && *next == ',' &&
+                 Command_ParseHalfDb(next + 1, &next, &stop) && *next == ',' &&
+                 Command_ParseHalfDb(next + 1, &next, &step) && *next == ',' && step > 0;
+    
+    if (!valid)
+    {
+        printf("ERROR: Invalid sweep\n");
+        return;
+    }
+    
+    config.start = (int16_t)start;
+    config.stop = (int16_t)stop;
+    config.step = (uint16_t)step;
+    config.dwell_us = strtoul(next + 1, &next, 10);
+    config.repeat = (strcmp(next, ",REPEAT") == 0);
+    
+    if (*next != '\0' && !config.repeat)
+    {
+        printf("ERROR: Invalid sweep\n");
+        return;
+    }
+    
+    RF_StartPowerSweep(&config);
+}
+
+/**
+ * @brief Log task - formats deferred log records off the hot paths
+ */
+static void LogTask(void *pvParameters)
+{
+    uint32_t events;
+    
+    while (1)
+    {
+        bool busy = Log_GetPending() > 0;
+        bool more;
+        
+        /* One record per console hold, so a reply waits for one line at most */
+        do
+        {
+            Console_Lock();
+            more = Log_ProcessOne();
+            Console_Unlock();
+        } while (more);
+        
+        events = 0;
+        xTaskNotifyWait(0, LOG_EVENT_JOURNAL, &events,
+                        pdMS_TO_TICKS(busy ? LOG_PERIOD_BUSY_MS : LOG_PERIOD_IDLE_MS));
+        
+        /* The journal write runs here, at the lowest priority: it may wait
+         * for the FRAM behind a CAL:SAVE, which must not hold up the timer
+         * service task */
+        if ((events & LOG_EVENT_JOURNAL) && !StateJournal_Flush())
+        {
+            /* The state stays pending - try again later */
+            LOG_ERROR("[ERROR] State journal write failed, retrying\n");
+            xTimerChangePeriod(journal_timer, pdMS_TO_TICKS(JOURNAL_RETRY_MS), 0);
+        }
+    }
+}
+
+/* ============================= */
+/* RF CONTROL IMPLEMENTATION     */
+/* ============================= */
+
+/**
+ * @brief Initialize RF subsystem
+ */
+void RF_Init(void)
+{
+    SystemState_t state;
+    
+    SystemState_Read(&state);
+    MAX2871_Init();
+    MAX2871_SetFrequency(state.frequency);
+    LOG_INFO("[OK] RF subsystem initialized\n");
+}
+
+/**
+ * @brief Merge a request into the RF mailbox and wake RFControlTask
+ *
+ * Only the latest value of each setting is kept, so a burst of commands
+ * costs one retune, not one per command. The shared state shows the
+ * requested settings immediately, with rf_busy set until applied.
+ */
+static void RF_Post(const RF_Request_t* request)
+{
+    taskENTER_CRITICAL();
+    
+    if (rf_pending.fields & request->fields)
+        rf_queue_stats.coalesced++;
+    rf_queue_stats.posted++;
+    
+    if (request->fields & RF_REQ_FREQUENCY)
+        rf_pending.image = request->image;
+    if (request->fields & RF_REQ_POWER)
+        rf_pending.power_dbm = request->power_dbm;
+    if (request->fields & RF_REQ_OUTPUT)
+        rf_pending.enable = request->enable;
+    if (request->fields & RF_REQ_SCHEDULE)
+    {
+        rf_pending.scheduled = request->scheduled;
+        rf_pending.at_us = request->at_us;
+    }
+    if (request->fields & RF_REQ_LIST)
+        rf_pending.list_loops = request->list_loops;
+    if (request->fields & RF_REQ_PSWEEP)
+        rf_pending.sweep = request->sweep;
+    /* A cancel or stop drops a start still waiting here; one RFControlTask
+     * has already taken is started before the cancel or stop is applied */
+    if (request->fields & RF_REQ_CANCEL)
+        rf_pending.fields &= ~RF_REQ_SCHEDULE;
+    if (request->fields & RF_REQ_FSK_STOP)
+        rf_pending.fields &= ~RF_REQ_FSK;
+    if (request->fields & RF_REQ_LIST_STOP)
+        rf_pending.fields &= ~RF_REQ_LIST;
+    if (request->fields & RF_REQ_PSWEEP_STOP)
+        rf_pending.fields &= ~RF_REQ_PSWEEP;
+    rf_pending.fields |= request->fields;
+    
+    SystemState_t* state = SystemState_BeginWrite();
+    if (request->fields & RF_REQ_FREQUENCY)
+        state->frequency = request->image.frequency;
+    if (request->fields & RF_REQ_POWER)
+        state->power_dbm = request->power_dbm;
+    if (request->fields & RF_REQ_OUTPUT)
+        state->rf_enabled = request->enable;
+    state->rf_busy = true;
+    SystemState_EndWrite();
+    
+    taskEXIT_CRITICAL();
+    
+    if (rf_control_task_handle != NULL)
+        xTaskNotify(rf_control_task_handle, RF_EVENT_REQUEST, eSetBits);
+}
+
+/**
+ * @brief Set the output level for a power at a frequency, with the
+ * calibration correction for that frequency (RFControlTask)
+ */
+static void RF_ApplyPower(int8_t power_dbm, Frequency_t frequency)
+{
+    int32_t level = (int32_t)power_dbm * 2 + Calibration_GetLevelCorrection(frequency);
+    
+    Attenuator_SetLevel(Attenuator_ClampLevel(level));
+}
+
+/**
+ * @brief Have RFControlTask re-apply the set power after the calibration
+ * table changed; a list, FSK stream or power sweep keeps its own levels
+ */
+static void RF_RefreshPower(void)
+{
+    RF_Request_t request;
+    SystemState_t state;
+    
+    if (RF_IsListBusy() || RF_IsFskBusy() || RF_IsSweepBusy())
+        return;
+    
+    SystemState_Read(&state);
+    request.fields = RF_REQ_POWER;
+    request.power_dbm = state.power_dbm;
+    RF_Post(&request);
+}
+
+/**
+ * @brief Bring the clock profile in line with the RF output (RFControlTask)
+ * Full clocks while RF is active, low-power profile when parked. A switch
+ * re-clocks TIM2 through TIM15, so it waits while a scheduled commit, list
+ * run, FSK stream, power sweep or pulse modulation is active.
+ */
+static void RF_SettleClockProfile(bool output_on)
+{
+    rf_profile_deferred = rf_commit_armed || rf_list_running || rf_fsk_running ||
+                          rf_sweep_running || Pulse_GetStatus().enabled;
+    if (rf_profile_deferred)
+        return;
+    
+    Clock_SetProfile(output_on ? CLOCK_PROFILE_PERFORMANCE : CLOCK_PROFILE_LOW_POWER);
+}
+
+/**
+ * @brief Switch the RF output and the clock profile that goes with it
+ */
+static void RF_ApplyOutput(bool enable)
+{
+    if (enable)
+        RF_SettleClockProfile(true);
+    
+    GPIO_SetRFOutput(enable);
+    GPIO_SetStatusLED(enable);
+    
+    if (!enable)
+        RF_SettleClockProfile(false);
+}
+
+/**
+ * @brief Apply everything in the RF mailbox (RFControlTask)
+ * Output off goes first and output on last, so a combined request never
+ * radiates at the old frequency or power.
+ */
+static void RF_ApplyPending(void)
+{
+    RF_Request_t request;
+    uint32_t start = Timer_GetMicros();
+    uint16_t stops;
+    
+    /* Cancels and stops go first, so what the armed commit or stream held
+     * back can follow in the same pass and a start posted after them runs
+     * afresh */
+    taskENTER_CRITICAL();
+    stops = rf_pending.fields & (RF_REQ_CANCEL | RF_REQ_FSK_STOP |
+                                 RF_REQ_LIST_STOP | RF_REQ_PSWEEP_STOP);
+    rf_pending.fields &= ~stops;
+    taskEXIT_CRITICAL();
+    
+    if (stops & RF_REQ_CANCEL)
+    {
+        MAX2871_CancelSchedule();
+        RF_CheckCommit();
+    }
+    
+    if (stops & RF_REQ_FSK_STOP)
+    {
+        Fsk_Stop();
+        RF_CheckFsk();
+    }
+    
+    if (stops & RF_REQ_LIST_STOP)
+    {
+        ListMode_Stop();
+        RF_CheckList();
+    }
+    
+    if (stops & RF_REQ_PSWEEP_STOP)
+    {
+        Attenuator_StopSweep();
+        RF_CheckSweep();
+    }
+    
+    /* The commit ISR writes SPI1, so everything but the output switch
+     * waits until an armed commit is written, and likewise for a list run
+     * or FSK stream to end. A list run or FSK stream posted together with
+     * a schedule starts after its commit, and FSK after a list posted with
+     * it. A power sweep holds back whatever writes the power. */
+    uint16_t held = 0;
+    if (rf_commit_armed || rf_list_running || rf_fsk_running)
+        held = RF_REQ_SYNTH_OWNED;
+    if (rf_sweep_running)
+        held |= RF_REQ_ATTEN_OWNED;
+    
+    taskENTER_CRITICAL();
+    request = rf_pending;
+    if ((request.fields & ~held) & RF_REQ_SCHEDULE)
+        held |= RF_REQ_LIST | RF_REQ_FSK;
+    if ((request.fields & ~held) & RF_REQ_LIST)
+        held |= RF_REQ_FSK;
+    rf_pending.fields &= held;
+    request.fields &= ~held;
+    taskEXIT_CRITICAL();
+    
+    /* A lone cancel or stop still settles the busy flag below */
+    if (request.fields == 0 && stops == 0)
+        return;
+    
+    if ((request.fields & RF_REQ_OUTPUT) && !request.enable)
+        RF_ApplyOutput(false);
+    
+    /* The sweep would be radiated - only with the output off */
+    if (request.fields & RF_REQ_VCOCAL)
+    {
+        SystemState_t state;
+        SystemState_Read(&state);
+        
+        if (state.rf_enabled)
+            LOG_WARN("[RFControlTask] VCO calibration skipped - RF output on\n");
+        else if (!VcoCal_Run())
+            LOG_WARN("[RFControlTask] VCO calibration incomplete\n");
+    }
+    
+    /* The correction follows the frequency, so a retune sets the level
+     * too, unless a power sweep owns the attenuator */
+    if ((request.fields & RF_REQ_POWER) ||
+        ((request.fields & RF_REQ_FREQUENCY) && !rf_sweep_running))
+    {
+        SystemState_t state;
+        SystemState_Read(&state);
+        
+        RF_ApplyPower((request.fields & RF_REQ_POWER) ? request.power_dbm : state.power_dbm,
+                      (request.fields & RF_REQ_FREQUENCY) ? request.image.frequency :
+                                                             MAX2871_GetFrequency());
+    }
+    
+    if ((request.fields & RF_REQ_FREQUENCY) && !MAX2871_Apply(&request.image))
+        LOG_WARN("[RFControlTask] No lock at %lu kHz\n", Frequency_ToKHz(request.image.frequency));
+    
+    if ((request.fields & RF_REQ_OUTPUT) && request.enable)
+    {
+        /* Protection may have tripped since the command was accepted */
+        if (ADC_GetFaultStatus().latched == ADC_FAULT_NONE)
+        {
+            RF_ApplyOutput(true);
+        }
+        else
+        {
+            SystemState_BeginWrite()->rf_enabled = false;
+            SystemState_EndWrite();
+        }
+    }
+    
+    /* Armed last: the retune above has already settled the shadow */
+    if (request.fields & RF_REQ_SCHEDULE)
+    {
+        rf_commit_base = MAX2871_GetCommitStats().commits;
+        rf_commit_armed = MAX2871_Schedule(&request.scheduled, request.at_us);
+    }
+    
+    if (request.fields & RF_REQ_LIST)
+    {
+        rf_list_running = ListMode_Run(request.list_loops);
+        if (!rf_list_running)
+            LOG_WARN("[RFControlTask] List run refused\n");
+    }
+    
+    if (request.fields & RF_REQ_FSK)
+    {
+        rf_fsk_running = Fsk_Start();
+        if (!rf_fsk_running)
+            LOG_WARN("[RFControlTask] FSK start refused - no lock on the first tone\n");
+    }
+    
+    if (request.fields & RF_REQ_PSWEEP)
+    {
+        /* Shifted by the correction at the current frequency; a sweep the
+         * shift would take out of range runs uncorrected */
+        int16_t correction = Calibration_GetLevelCorrection(MAX2871_GetFrequency());
+        Attenuator_SweepConfig_t sweep = request.sweep;
+        
+        sweep.start += correction;
+        sweep.stop += correction;
+        if (!Attenuator_CheckSweep(&sweep))
+            sweep = request.sweep;
+        
+        rf_sweep_running = Attenuator_StartSweep(&sweep);
+        if (!rf_sweep_running)
+            LOG_WARN("[RFControlTask] Power sweep refused\n");
+    }
+    
+    /* Idle only if nothing new arrived while applying */
+    taskENTER_CRITICAL();
+    rf_queue_stats.applied++;
+    rf_queue_stats.last_apply_us = Timer_GetMicros() - start;
+    if (rf_pending.fields == 0 && !rf_commit_armed)
+    {
+        SystemState_BeginWrite()->rf_busy = false;
+        SystemState_EndWrite();
+    }
+    taskEXIT_CRITICAL();
+    
+    RF_JournalState();
+}
+
+/**
+ * @brief Finish a scheduled commit once the alarm ISR has written it
+ * @return true if the commit completed or was cancelled
+ */
+static bool RF_CheckCommit(void)
+{
+    if (!rf_commit_armed || MAX2871_IsCommitPending())
+        return false;
+    
+    rf_commit_armed = false;
+    
+    MAX2871_CommitStats_t stats = MAX2871_GetCommitStats();
+    bool committed = (stats.commits != rf_commit_base);
+    
+    taskENTER_CRITICAL();
+    SystemState_t* state = SystemState_BeginWrite();
+    if (committed && (rf_pending.fields & RF_REQ_FREQUENCY) == 0)
+        state->frequency = stats.frequency;
+    if (rf_pending.fields == 0)
+        state->rf_busy = false;
+    SystemState_EndWrite();
+    taskEXIT_CRITICAL();
+    
+    if (committed)
+    {
+        /* Level for the new frequency, once the commit has freed SPI1 */
+        if (!rf_sweep_running && (rf_pending.fields & RF_REQ_POWER) == 0)
+        {
+            SystemState_t current;
+            SystemState_Read(&current);
+            RF_ApplyPower(current.power_dbm, stats.frequency);
+        }
+        
+        LOG_DEBUG("[RFControlTask] Scheduled commit at %lu, error %ld us\n",
+                  stats.at_us, stats.last_error_us);
+        RF_JournalState();
+    }
+    return true;
+}
+
+/**
+ * @brief Hand the synthesizer back once a list run has ended
+ * @return true if the run finished or was stopped
+ */
+static bool RF_CheckList(void)
+{
+    if (!rf_list_running || ListMode_IsRunning())
+        return false;
+    
+    rf_list_running = false;
+    
+    ListMode_Status_t list = ListMode_GetStatus();
+    
+    taskENTER_CRITICAL();
+    SystemState_t* state = SystemState_BeginWrite();
+    if ((rf_pending.fields & RF_REQ_FREQUENCY) == 0)
+        state->frequency = list.frequency;
+    if ((rf_pending.fields & RF_REQ_POWER) == 0)
+        state->power_dbm = list.power_dbm;
+    if (rf_pending.fields == 0 && !rf_commit_armed)
+        state->rf_busy = false;
+    SystemState_EndWrite();
+    taskEXIT_CRITICAL();
+    
+    LOG_INFO("[RFControlTask] List run ended after %lu points\n", list.steps);
+    RF_JournalState();
+    return true;
+}
+
+/**
+ * @brief Take SPI1 back from the FSK stream once it has been stopped
+ * @return true if the stream was stopped
+ */
+static bool RF_CheckFsk(void)
+{
+    if (!rf_fsk_running || Fsk_IsRunning())
+        return false;
+    
+    rf_fsk_running = false;
+    Fsk_Release();
+    
+    Fsk_Status_t fsk = Fsk_GetStatus();
+    
+    taskENTER_CRITICAL();
+    SystemState_t* state = SystemState_BeginWrite();
+    if ((rf_pending.fields & RF_REQ_FREQUENCY) == 0)
+        state->frequency = fsk.frequency;
+    if (rf_pending.fields == 0 && !rf_commit_armed)
+        state->rf_busy = false;
+    SystemState_EndWrite();
+    taskEXIT_CRITICAL();
+    
+    LOG_INFO("[RFControlTask] FSK stopped after %lu symbols, %lu underruns\n",
+             fsk.symbols, fsk.underruns);
+    RF_JournalState();
+    return true;
+}
+
+/**
+ * @brief Give the attenuator back to RF:POWER once a sweep has ended
+ * @return true if the sweep finished or was stopped
+ */
+static bool RF_CheckSweep(void)
+{
+    if (!rf_sweep_running || Attenuator_IsSweeping())
+        return false;
+    
+    rf_sweep_running = false;
+    
+    Attenuator_SweepStatus_t sweep = Attenuator_GetSweepStatus();
+    SystemState_t state;
+    
+    /* A pending RF:POWER is applied next anyway */
+    SystemState_Read(&state);
+    if ((rf_pending.fields & RF_REQ_POWER) == 0)
+        RF_ApplyPower(state.power_dbm, MAX2871_GetFrequency());
+    
+    taskENTER_CRITICAL();
+    if (rf_pending.fields == 0 && !rf_commit_armed)
+    {
+        SystemState_BeginWrite()->rf_busy = false;
+        SystemState_EndWrite();
+    }
+    taskEXIT_CRITICAL();
+    
+    LOG_INFO("[RFControlTask] Power sweep ended at point %lu of %lu\n",
+             sweep.index, sweep.points);
+    return true;
+}
+
+/**
+ * @brief Notification timeout - just past the armed commit, a poll while
+ * a list or power sweep runs, else forever
+ */
+static TickType_t RF_CommitWait(void)
+{
+    if (rf_list_running || rf_sweep_running)
+        return pdMS_TO_TICKS(RF_LIST_POLL_MS);
+    
+    if (!rf_commit_armed)
+        return portMAX_DELAY;
+    
+    int32_t remaining_us = (int32_t)(MAX2871_GetCommitStats().at_us - Timer_GetMicros());
+    
+    if (remaining_us <= 0)
+        return 1;
+    return pdMS_TO_TICKS(remaining_us / 1000) + 1;
+}
+
+/**
+ * @brief Set RF frequency
+ * Solved and validated here; RFControlTask applies it.
+ */
+void RF_SetFrequency(Frequency_t frequency)
+{
+    RF_Request_t request;
+    
+    if (frequency < RF_FREQ_MIN || frequency > RF_FREQ_MAX ||
+        !MAX2871_Solve(frequency, &request.image))
+    {
+        printf("ERROR: Frequency out of range\n");
+        printf("Valid range: 23.4375 MHz - 6 GHz\n");
+        return;
+    }
+    
+    request.fields = RF_REQ_FREQUENCY;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Schedule a retune for a device time
+ * The image is solved now and committed by the TIM2 alarm; RF:FREQ?
+ * shows the new frequency once it has been written. One schedule may be
+ * outstanding at a time.
+ */
+void RF_ScheduleFrequency(Frequency_t frequency, uint32_t at_us)
+{
+    RF_Request_t request;
+    uint32_t lead_us = at_us - Timer_GetMicros();
+    
+    if (frequency < RF_FREQ_MIN || frequency > RF_FREQ_MAX ||
+        !MAX2871_Solve(frequency, &request.scheduled))
+    {
+        printf("ERROR: Frequency out of range\n");
+        return;
+    }
+    
+    if (lead_us < RF_SCHEDULE_MIN_LEAD_US || lead_us > RF_SCHEDULE_MAX_LEAD_US)
+    {
+        printf("ERROR: Schedule time out of range\n");
+        return;
+    }
+    
+    /* One armed commit that a queued cancel will drop does not count */
+    if ((rf_pending.fields & RF_REQ_SCHEDULE) ||
+        (MAX2871_IsCommitPending() && (rf_pending.fields & RF_REQ_CANCEL) == 0))
+    {
+        printf("ERROR: Schedule already pending\n");
+        return;
+    }
+    
+    request.fields = RF_REQ_SCHEDULE;
+    request.at_us = at_us;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Cancel a scheduled retune that has not been committed yet
+ * (cancelled by RFControlTask, which is the only task that arms one, so a
+ * schedule it has already taken cannot be armed after the cancel)
+ */
+void RF_CancelSchedule(void)
+{
+    RF_Request_t request;
+    
+    request.fields = RF_REQ_CANCEL;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Check whether a list run is requested, running or not yet settled
+ */
+static bool RF_IsListBusy(void)
+{
+    return ListMode_IsRunning() || rf_list_running || (rf_pending.fields & RF_REQ_LIST);
+}
+
+/**
+ * @brief Start the loaded point list (started by RFControlTask)
+ * @param loops Passes through the list, 0 = until LIST:STOP
+ */
+void RF_RunList(uint32_t loops)
+{
+    RF_Request_t request;
+    ListMode_State_t state = ListMode_GetStatus().state;
+    
+    if (state != LIST_STATE_READY && state != LIST_STATE_DONE)
+    {
+        printf("ERROR: No list loaded\n");
+        return;
+    }
+    
+    if (RF_IsListBusy())
+    {
+        printf("ERROR: List running\n");
+        return;
+    }
+    
+    if (RF_IsFskBusy())
+    {
+        printf("ERROR: FSK running\n");
+        return;
+    }
+    
+    if (RF_IsSweepBusy())
+    {
+        printf("ERROR: Power sweep running\n");
+        return;
+    }
+    
+    request.fields = RF_REQ_LIST;
+    request.list_loops = loops;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Stop a list run; the output stays at the current point
+ * (stopped by RFControlTask, which is the only task that starts a run, so
+ * a start it has already taken cannot run after the stop)
+ */
+void RF_StopList(void)
+{
+    RF_Request_t request;
+    
+    request.fields = RF_REQ_LIST_STOP;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Check whether an FSK stream is requested, running or not yet released
+ */
+static bool RF_IsFskBusy(void)
+{
+    return Fsk_IsRunning() || rf_fsk_running || (rf_pending.fields & RF_REQ_FSK);
+}
+
+/**
+ * @brief Start FSK modulation on the configured tones (started by
+ * RFControlTask); queued symbols play first
+ */
+void RF_StartFsk(void)
+{
+    RF_Request_t request;
+    
+    if (Fsk_GetStatus().tones == 0)
+    {
+        printf("ERROR: No tones set\n");
+        return;
+    }
+    
+    if (RF_IsFskBusy())
+    {
+        printf("ERROR: FSK running\n");
+        return;
+    }
+    
+    if (RF_IsListBusy())
+    {
+        printf("ERROR: List running\n");
+        return;
+    }
+    
+    if (RF_IsSweepBusy())
+    {
+        printf("ERROR: Power sweep running\n");
+        return;
+    }
+    
+    request.fields = RF_REQ_FSK;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Stop FSK modulation; the output stays on the last tone
+ * (stopped by RFControlTask, which is the only task that starts a stream,
+ * so a start it has already taken cannot run after the stop)
+ */
+void RF_StopFsk(void)
+{
+    RF_Request_t request;
+    
+    request.fields = RF_REQ_FSK_STOP;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Set RF power level (applied by RFControlTask)
+ */
+void RF_SetPower(int8_t power_dbm)
+{
+    RF_Request_t request;
+    
+    if (power_dbm < RF_POWER_MIN || power_dbm > RF_POWER_MAX)
+    {
+        printf("ERROR: Power out of range\n");
+        printf("Valid range: -20 to +15 dBm\n");
+        return;
+    }
+    
+    request.fields = RF_REQ_POWER;
+    request.power_dbm = power_dbm;
+    RF_Post(&request);
+    
+    printf("OK\n");
+}
+
+/**
+ * @brief Check whether a power sweep is requested, running or not yet settled
+ */
+static bool RF_IsSweepBusy(void)
+{
+    return Attenuator_IsSweeping() || rf_sweep_running || (rf_pending.fields & RF_REQ_PSWEEP);
+}
+
+/**
+ * @brief Start a power sweep (started by RFControlTask)
+ * RF:POWER requests wait until the sweep ends, then the output returns to
+ * the set power.
+ */
+void RF_StartPowerSweep(const Attenuator_SweepConfig_t* config)
+{
+    RF_Request_t request;
+    
+    if (!Attenuator_CheckSweep(config))
+    {
+        printf("ERROR: Invalid sweep\n");
+        return;
+    }
+    
+    if (RF_IsSweepBusy())
+    {
+        printf("ERROR: Power sweep running\n");
+        return;
+    }
+    
+    if (RF_IsListBusy())
+    {
+        printf("ERROR: List running\n");
+        return;
+    }
+    
+    if (RF_IsFskBusy())
+    {
+        printf("ERROR: FSK running\n");
+        return;
+    }
+    
+    request.fields = RF_REQ_PSWEEP;
+    request.sweep = *config;
+    RF_Post(&request);
+    
+    printf("OK\n");
 }
 
 /**
- * @brief Set RF frequency
+ * @brief Stop a power sweep at the current point (stopped by
+ * RFControlTask, which then restores the set power)
  */
-void RF_SetFrequency(uint32_t frequency_hz)
+void RF_StopPowerSweep(void)
 {
-    if (frequency_hz < RF_FREQ_MIN || frequency_hz > RF_FREQ_MAX)
-    {
-        printf("ERROR: Frequency out of range\n");
-        printf("Valid range: 10 MHz - 6 GHz\n");
-        return;
-    }
+    RF_Request_t request;
     
-    current_frequency = frequency_hz;
-    MAX2871_SetFrequency(frequency_hz);
+    request.fields = RF_REQ_PSWEEP_STOP;
+    RF_Post(&request);
     
     printf("OK\n");
 }
 
 /**
- * @brief Set RF power level
+ * @brief Enable/disable RF output (applied by RFControlTask)
  */
-void RF_SetPower(int8_t power_dbm)
+void RF_Enable(bool enable)
 {
-    if (power_dbm < RF_POWER_MIN || power_dbm > RF_POWER_MAX)
+    RF_Request_t request;
+    
+    if (enable && ADC_GetFaultStatus().latched != ADC_FAULT_NONE)
     {
-        printf("ERROR: Power out of range\n");
-        printf("Valid range: -20 to +15 dBm\n");
+        printf("ERROR: Protection fault latched\n");
         return;
     }
     
-    current_power = power_dbm;
-    Attenuator_SetPower(power_dbm);
+    request.fields = RF_REQ_OUTPUT;
+    request.enable = enable;
+    RF_Post(&request);
     
     printf("OK\n");
 }
 
 /**
- * @brief Control attenuator for power adjustment
+ * @brief Queue current RF state for the FRAM journal
+ * The write happens once changes have been quiet for JOURNAL_COALESCE_MS.
  */
-void Attenuator_SetPower(int8_t power_dbm)
+static void RF_JournalState(void)
 {
-    /**
-     * PE4314 Digital Attenuator Control
-     * Maps -20 to +15 dBm to 0-31 control value
-     * Each step = 0.5 dB
-     */
-    
-    uint8_t atten_value;
+    StateJournal_State_t state;
+    SystemState_t current;
     
-    /* Convert power to attenuation value */
-    /* Formula: atten = (15 - power) / 0.5 */
-    atten_value = (uint8_t)((15 - power_dbm) * 2);
+    SystemState_Read(&current);
+    state.frequency = current.frequency;
+    state.power_dbm = current.power_dbm;
+    state.rf_enabled = current.rf_enabled;
+    state.program_id = 0;
+    StateJournal_Update(&state);
     
-    if (atten_value > 63)
-        atten_value = 63;
-    
-    /* TODO: Write to PE4314 via GPIO or SPI */
-    /* For now, just track the value */
-    (void)atten_value;
+    /* Restarts the quiet period, also after a retry period was set */
+    if (journal_timer != NULL)
+        xTimerChangePeriod(journal_timer, pdMS_TO_TICKS(JOURNAL_COALESCE_MS), 0);
 }
 
 /**
- * @brief Enable/disable RF output
+ * @brief Journal coalescing timer expired - hand the FRAM write to LogTask
+ * (timer task)
  */
-void RF_Enable(bool enable)
+static void JournalTimerCallback(TimerHandle_t xTimer)
 {
-    rf_enabled = enable;
-    GPIO_SetRFOutput(enable);
+    (void)xTimer;
     
-    if (enable)
-    {
-        GPIO_SetStatusLED(true);
-        printf("OK\n");
-    }
-    else
-    {
-        GPIO_SetStatusLED(false);
-        printf("OK\n");
-    }
+    if (log_task_handle != NULL)
+        xTaskNotify(log_task_handle, LOG_EVENT_JOURNAL, eSetBits);
 }
 
 /* ============================= */
@@ -317,9 +1917,15 @@ void Monitor_Init(void)
  */
 void Monitor_Update(void)
 {
-    system_temperature = ADC_GetTemperature();
-    system_voltage = ADC_GetVoltage();
-    system_current = ADC_GetCurrent();
+    ADC_Readings_t readings = ADC_GetReadings();
+    uint32_t now = Timer_GetMicros();
+    
+    SystemState_t* state = SystemState_BeginWrite();
+    state->temperature = readings.temperature;
+    state->voltage = readings.voltage;
+    state->current = readings.current;
+    state->monitor_us = now;
+    SystemState_EndWrite();
 }
 
 /**
@@ -327,7 +1933,10 @@ void Monitor_Update(void)
  */
 double Monitor_GetTemperature(void)
 {
-    return system_temperature;
+    SystemState_t state;
+    
+    SystemState_Read(&state);
+    return state.temperature;
 }
 
 /**
@@ -335,7 +1944,10 @@ double Monitor_GetTemperature(void)
  */
 double Monitor_GetVoltage(void)
 {
-    return system_voltage;
+    SystemState_t state;
+    
+    SystemState_Read(&state);
+    return state.voltage;
 }
 
 /**
@@ -343,7 +1955,10 @@ double Monitor_GetVoltage(void)
  */
 double Monitor_GetCurrent(void)
 {
-    return system_current;
+    SystemState_t state;
+    
+    SystemState_Read(&state);
+    return state.current;
 }
 
 /* ============================= */
@@ -358,34 +1973,253 @@ static void ProcessCommand(const char* command)
     if (command == NULL || strlen(command) == 0)
         return;
     
+    /* Common commands */
+    if (strcmp(command, "*OPC?") == 0)
+    {
+        Command_WaitComplete();
+    }
+    
     /* System commands */
-    if (strncmp(command, "SYS:IDN?", 8) == 0)
+    else if (strncmp(command, "SYS:IDN?", 8) == 0)
     {
         printf("FrequencyGenerator,FG-STM32H743,SN123456,1.0.0\n");
     }
     else if (strncmp(command, "SYS:RESET", 9) == 0)
     {
         printf("OK\n");
+        UART_Flush();
         NVIC_SystemReset();
     }
     else if (strncmp(command, "SYS:STAT?", 9) == 0)
     {
-        printf("TEMP:%.1f,VOLT:%.2f,CURR:%.2f\n", 
-               system_temperature, system_voltage, system_current);
+        SystemState_t state;
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        SystemState_Read(&state);
+        Fmt_Str(out, "TEMP:");
+        Fmt_Double(out, state.temperature, 1);
+        Fmt_Str(out, ",VOLT:");
+        Fmt_Double(out, state.voltage, 2);
+        Fmt_Str(out, ",CURR:");
+        Fmt_Double(out, state.current, 2);
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strncmp(command, "SYS:FAULT?", 10) == 0)
+    {
+        ADC_FaultStatus_t fault = ADC_GetFaultStatus();
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        Fmt_Str(out, (fault.latched & ADC_FAULT_OVERTEMP) ? "OTP:1" : "OTP:0");
+        Fmt_Str(out, (fault.latched & ADC_FAULT_OVERCURRENT) ? ",OCP:1" : ",OCP:0");
+        Fmt_Str(out, (fault.active != ADC_FAULT_NONE) ? ",ACTIVE:1,TRIPS:" : ",ACTIVE:0,TRIPS:");
+        Fmt_U32(out, fault.trip_count);
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strncmp(command, "SYS:FAULT:CLR", 13) == 0)
+    {
+        if (ADC_ClearFault())
+            printf("OK\n");
+        else
+            printf("ERROR: Fault condition still active\n");
+    }
+    
+    else if (strncmp(command, "SYS:BOOT?", 9) == 0)
+    {
+        printf("CLK:%lu", SystemCoreClock);
+        for (uint32_t stage = 0; stage < BOOT_STAGE_COUNT; stage++)
+        {
+            printf(",%s:%lu", BootProfile_GetName((BootStage_t)stage),
+                   BootProfile_GetCycles((BootStage_t)stage));
+        }
+        printf("\n");
+    }
+    else if (strncmp(command, "SYS:BENCH?", 10) == 0)
+    {
+        Bench_Result_t bench = Bench_RunCache();
+        printf("DISPATCH_OFF:%lu,DISPATCH_ON:%lu,MATH_OFF:%lu,MATH_ON:%lu\n",
+               bench.dispatch_off, bench.dispatch_on,
+               bench.math_off, bench.math_on);
+    }
+    else if (strncmp(command, "SYS:CLK?", 8) == 0)
+    {
+        Clock_Status_t clk = Clock_GetStatus();
+        printf("PROFILE:%s,SYSCLK:%lu,HCLK:%lu,PCLK1:%lu,CORE_MEAS:%lu,SPI:%lu,UART:%lu\n",
+               clk.profile == CLOCK_PROFILE_PERFORMANCE ? "PERF" : "LOW",
+               clk.sysclk_hz, clk.hclk_hz, clk.pclk1_hz,
+               clk.core_measured_hz, clk.spi_sck_hz, clk.uart_baud);
+    }
+    else if (strncmp(command, "SYS:CLK ", 8) == 0)
+    {
+        const char* arg = command + 8;
+        bool ok;
+        
+        /* Re-clocking would disturb TIM2 through TIM15 mid-run */
+        if (MAX2871_IsCommitPending() || RF_IsListBusy() || RF_IsFskBusy() ||
+            RF_IsSweepBusy() || Pulse_GetStatus().enabled)
+        {
+            printf("ERROR: RF timers busy\n");
+            return;
+        }
+        
+        if (strncmp(arg, "PERF", 4) == 0)
+            ok = Clock_SetProfile(CLOCK_PROFILE_PERFORMANCE);
+        else if (strncmp(arg, "LOW", 3) == 0)
+            ok = Clock_SetProfile(CLOCK_PROFILE_LOW_POWER);
+        else
+        {
+            printf("ERROR: Invalid clock profile\n");
+            return;
+        }
+        
+        printf(ok ? "OK\n" : "ERROR: Clock switch failed\n");
+    }
+    else if (strncmp(command, "SYS:POWER?", 10) == 0)
+    {
+        Power_Status_t power = Power_GetStatus();
+        uint32_t sleep_permille = (power.uptime_us > 0) ?
+            (uint32_t)((power.asleep_us * 1000ULL) / power.uptime_us) : 0;
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        Fmt_Str(out, Clock_GetProfile() == CLOCK_PROFILE_PERFORMANCE ? "PROFILE:PERF" : "PROFILE:LOW");
+        Fmt_Str(out, ",SLEEP:");
+        Fmt_Fixed(out, (int32_t)sleep_permille, 1);
+        Fmt_Str(out, "%,SLEEPS:");
+        Fmt_U32(out, power.sleeps);
+        Fmt_Str(out, ",MONITOR_MS:");
+        Fmt_U32(out, monitor_period_ms);
+        Fmt_Str(out, ",IDLE_CURRENT:");
+        if (power.idle_current_valid)
+            Fmt_Double(out, power.idle_current_a, 3);
+        else
+            Fmt_Str(out, "NONE");
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strncmp(command, "SYS:BAUD?", 9) == 0)
+    {
+        uint32_t count;
+        const uint32_t* rates = UART_GetSupportedBauds(&count);
+        
+        printf("BAUD:%lu,SUPPORTED:", UART_GetConfiguredBaud());
+        for (uint32_t i = 0; i < count; i++)
+            printf(i ? ",%lu" : "%lu", rates[i]);
+        printf("\n");
+    }
+    else if (strncmp(command, "SYS:BAUD:PING", 13) == 0)
+    {
+        printf("BAUD:%lu\n", UART_GetConfiguredBaud());
+    }
+    else if (strncmp(command, "SYS:BAUD ", 9) == 0)
+    {
+        Command_NegotiateBaud(strtoul(command + 9, NULL, 10));
+    }
+    else if (strncmp(command, "SYS:TIME?", 9) == 0)
+    {
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        Fmt_Str(out, "TIME_US:");
+        Fmt_U32(out, Timer_GetMicros());
+        Fmt_Str(out, ",RX_US:");
+        Fmt_U32(out, UART_GetLineTimestamp());
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strncmp(command, "SYS:LAT?", 8) == 0)
+    {
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        Fmt_Str(out, "QUERIES:");
+        Fmt_U32(out, query_latency.count);
+        Fmt_Str(out, ",QUERY_US:");
+        Fmt_U32(out, query_latency.last_us);
+        Fmt_Str(out, ",QUERY_MAX_US:");
+        Fmt_U32(out, query_latency.max_us);
+        Fmt_Str(out, ",SETS:");
+        Fmt_U32(out, set_latency.count);
+        Fmt_Str(out, ",SET_US:");
+        Fmt_U32(out, set_latency.last_us);
+        Fmt_Str(out, ",SET_MAX_US:");
+        Fmt_U32(out, set_latency.max_us);
+        Fmt_Str(out, ",TX_PENDING:");
+        Fmt_U32(out, UART_GetTxPending());
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strncmp(command, "SYS:LAT:CLR", 11) == 0)
+    {
+        memset(&query_latency, 0, sizeof(query_latency));
+        memset(&set_latency, 0, sizeof(set_latency));
+        printf("OK\n");
+    }
+    else if (strncmp(command, "SYS:RESTORE?", 12) == 0)
+    {
+        StateJournal_Status_t journal = StateJournal_GetStatus();
+        printf("RESTORED:%d,SEQ:%lu,RESTORE_US:%lu,RFREADY_US:%lu\n",
+               journal.restored ? 1 : 0, journal.sequence,
+               journal.restore_us, boot_rf_ready_us);
     }
     
     /* RF Frequency commands */
     else if (strncmp(command, "RF:FREQ ", 8) == 0)
     {
-        uint32_t freq = strtoul(&command[8], NULL, 10);
-        RF_SetFrequency(freq);
+        char* next;
+        Frequency_t freq;
+        bool valid = Frequency_Parse(&command[8], &next, &freq);
+        
+        while (*next == ' ')
+            next++;
+        
+        if (!valid)
+            printf("ERROR: Invalid frequency\n");
+        else if (*next == '@')
+            RF_ScheduleFrequency(freq, strtoul(next + 1, NULL, 10));
+        else
+            RF_SetFrequency(freq);
     }
     else if (strncmp(command, "RF:FREQ?", 8) == 0)
     {
-        printf("%lu\n", current_frequency);
+        SystemState_t state;
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        SystemState_Read(&state);
+        Frequency_Format(out, state.frequency);
+        Fmt_Char(out, '\n');
+        Command_SendReply();
     }
     
     /* RF Power commands */
+    else if (strncmp(command, "RF:POWER:SWEEP?", 15) == 0)
+    {
+        Attenuator_SweepStatus_t sweep = Attenuator_GetSweepStatus();
+        int32_t level = ATTEN_LEVEL_MAX - (ATTEN_MODE_MAX - sweep.power_mode) * ATTEN_MODE_STEP -
+                        sweep.code;
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        Fmt_Str(out, "STATE:");
+        Fmt_Str(out, Attenuator_GetSweepStateName(sweep.state));
+        Fmt_Str(out, ",POINTS:");
+        Fmt_U32(out, sweep.points);
+        Fmt_Str(out, ",INDEX:");
+        Fmt_U32(out, sweep.index);
+        Fmt_Str(out, ",APWR:");
+        Fmt_U32(out, sweep.power_mode);
+        Fmt_Str(out, ",CODE:");
+        Fmt_U32(out, sweep.code);
+        Fmt_Str(out, ",LEVEL:");
+        Fmt_Fixed(out, level * 5, 1);
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strncmp(command, "RF:POWER:SWEEP:STOP", 19) == 0)
+    {
+        RF_StopPowerSweep();
+    }
+    else if (strncmp(command, "RF:POWER:SWEEP ", 15) == 0)
+    {
+        Command_PowerSweep(&command[15]);
+    }
     else if (strncmp(command, "RF:POWER ", 9) == 0)
     {
         int8_t power = (int8_t)strtol(&command[9], NULL, 10);
@@ -393,7 +2227,13 @@ static void ProcessCommand(const char* command)
     }
     else if (strncmp(command, "RF:POWER?", 9) == 0)
     {
-        printf("%d\n", current_power);
+        SystemState_t state;
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        SystemState_Read(&state);
+        Fmt_I32(out, state.power_dbm);
+        Fmt_Char(out, '\n');
+        Command_SendReply();
     }
     
     /* RF Output commands */
@@ -407,7 +2247,339 @@ static void ProcessCommand(const char* command)
     }
     else if (strncmp(command, "RF:OUTPUT?", 10) == 0)
     {
-        printf("%s\n", rf_enabled ? "ON" : "OFF");
+        SystemState_t state;
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        SystemState_Read(&state);
+        Fmt_Str(out, state.rf_enabled ? "ON\n" : "OFF\n");
+        Command_SendReply();
+    }
+    else if (strncmp(command, "RF:SCHED?", 9) == 0)
+    {
+        MAX2871_CommitStats_t commit = MAX2871_GetCommitStats();
+        char freq[FREQUENCY_TEXT_SIZE];
+        
+        printf("PENDING:%d,FREQ:%s,AT_US:%lu,COMMITS:%lu,LATE:%lu,ERR_US:%ld,ERR_MIN_US:%ld,ERR_MAX_US:%ld,JITTER_US:%ld\n",
+               (commit.pending || (rf_pending.fields & RF_REQ_SCHEDULE)) ? 1 : 0,
+               Frequency_ToText(commit.frequency, freq), commit.at_us, commit.commits, commit.late,
+               commit.last_error_us, commit.min_error_us, commit.max_error_us,
+               commit.max_error_us - commit.min_error_us);
+    }
+    else if (strncmp(command, "RF:SCHED:CANCEL", 15) == 0)
+    {
+        RF_CancelSchedule();
+    }
+    else if (strncmp(command, "RF:SCHED:CLR", 12) == 0)
+    {
+        MAX2871_ClearCommitStats();
+        printf("OK\n");
+    }
+    else if (strncmp(command, "RF:VCOCAL", 9) == 0)
+    {
+        SystemState_t state;
+        RF_Request_t request;
+        
+        SystemState_Read(&state);
+        if (state.rf_enabled)
+        {
+            printf("ERROR: RF output on\n");
+        }
+        else
+        {
+            request.fields = RF_REQ_VCOCAL;
+            RF_Post(&request);
+            printf("OK\n");
+        }
+    }
+    else if (strncmp(command, "RF:VCO?", 7) == 0)
+    {
+        VcoCal_Status_t vco = VcoCal_GetStatus();
+        MAX2871_Status_t synth = MAX2871_GetStatus();
+        
+        printf("TABLE:%s,POINTS:%lu,COMPLETE:%d,CAL_US:%lu,FALLBACKS:%lu,LOCK_AUTO_US:%lu,LOCKS_AUTO:%lu,LOCK_DIRECT_US:%lu,LOCKS_DIRECT:%lu\n",
+               vco.enabled ? "ON" : (vco.valid ? "OFF" : "NONE"),
+               vco.points, vco.complete ? 1 : 0, vco.cal_us, synth.vco_fallbacks,
+               synth.relock_auto_us, synth.relocks_auto,
+               synth.relock_direct_us, synth.relocks_direct);
+    }
+    else if (strcmp(command, "RF:VCO ON") == 0)
+    {
+        VcoCal_SetEnabled(true);
+        printf(VcoCal_GetStatus().enabled ? "OK\n" : "ERROR: No VCO band table\n");
+    }
+    else if (strcmp(command, "RF:VCO OFF") == 0)
+    {
+        VcoCal_SetEnabled(false);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "RF:CACHE?", 9) == 0)
+    {
+        MAX2871_CacheStats_t cache = MAX2871_GetCacheStats();
+        
+        printf("ENTRIES:%lu,SIZE:%lu,HITS:%lu,MISSES:%lu,EVICTIONS:%lu,HIT_CYCLES:%lu,MISS_CYCLES:%lu\n",
+               cache.entries, cache.capacity, cache.hits, cache.misses,
+               cache.evictions, cache.hit_cycles, cache.miss_cycles);
+    }
+    else if (strncmp(command, "RF:CACHE:LOAD ", 14) == 0)
+    {
+        Command_CachePreload(&command[14]);
+    }
+    else if (strncmp(command, "RF:CACHE:CLR", 12) == 0)
+    {
+        MAX2871_CacheClear();
+        printf("OK\n");
+    }
+    else if (strncmp(command, "RF:QUEUE?", 9) == 0)
+    {
+        SystemState_t state;
+        RF_QueueStats_t stats;
+        
+        SystemState_Read(&state);
+        taskENTER_CRITICAL();
+        stats = rf_queue_stats;
+        taskEXIT_CRITICAL();
+        
+        printf("BUSY:%d,POSTED:%lu,APPLIED:%lu,COALESCED:%lu,APPLY_US:%lu\n",
+               state.rf_busy ? 1 : 0, stats.posted, stats.applied,
+               stats.coalesced, stats.last_apply_us);
+    }
+    
+    /* PLL lock commands */
+    else if (strncmp(command, "RF:LOCK?", 8) == 0)
+    {
+        MAX2871_LockStats_t stats = MAX2871_GetLockStats();
+        Fmt_Buffer_t* out = Command_BeginReply();
+        
+        Fmt_Str(out, stats.locked ? "LOCKED:1,UNLOCKS:" : "LOCKED:0,UNLOCKS:");
+        Fmt_U32(out, stats.unlock_events);
+        Fmt_Str(out, ",UNLOCKED_US:");
+        Fmt_U32(out, stats.total_unlocked_us);
+        Fmt_Str(out, ",LONGEST_US:");
+        Fmt_U32(out, stats.longest_unlocked_us);
+        Fmt_Str(out, ",RELOCK_US:");
+        Fmt_U32(out, stats.last_relock_us);
+        Fmt_Char(out, '\n');
+        Command_SendReply();
+    }
+    else if (strcmp(command, "RF:BLANK ON") == 0)
+    {
+        MAX2871_SetUnlockBlanking(true);
+        printf("OK\n");
+    }
+    else if (strcmp(command, "RF:BLANK OFF") == 0)
+    {
+        MAX2871_SetUnlockBlanking(false);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "RF:BLANK?", 9) == 0)
+    {
+        printf("%s\n", MAX2871_GetUnlockBlanking() ? "ON" : "OFF");
+    }
+    
+    /* Log commands */
+    else if (strncmp(command, "LOG:LEVEL ", 10) == 0)
+    {
+        Log_SetLevel((uint8_t)strtoul(&command[10], NULL, 10));
+        printf("OK\n");
+    }
+    else if (strncmp(command, "LOG:LEVEL?", 10) == 0)
+    {
+        printf("%u\n", Log_GetLevel());
+    }
+    else if (strcmp(command, "LOG:MODE TEXT") == 0)
+    {
+        Log_SetMode(LOG_MODE_TEXT);
+        printf("OK\n");
+    }
+    else if (strcmp(command, "LOG:MODE BIN") == 0)
+    {
+        Log_SetMode(LOG_MODE_BINARY);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "LOG:STAT?", 9) == 0)
+    {
+        printf("PENDING:%lu,DROPPED:%lu\n", Log_GetPending(), Log_GetDropped());
+    }
+    
+    /* Recorder commands */
+    else if (strncmp(command, "REC:CONF?", 9) == 0)
+    {
+        Recorder_Status_t rec = Recorder_GetStatus();
+        printf("CHAN:%u,RATE:%lu\n", rec.channels, rec.rate_hz);
+    }
+    else if (strncmp(command, "REC:CONF ", 9) == 0)
+    {
+        char* next;
+        uint32_t channels = strtoul(&command[9], &next, 0);
+        uint32_t rate = (*next == ',') ? strtoul(next + 1, NULL, 10) : 0;
+        
+        if (channels <= 0xFF && Recorder_Configure((uint8_t)channels, rate))
+            printf("OK\n");
+        else
+            printf("ERROR: Invalid recorder configuration or recorder running\n");
+    }
+    else if (strncmp(command, "REC:START", 9) == 0)
+    {
+        Recorder_Start(REC_TRIGGER_NONE, 0, 0);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "REC:ARM ", 8) == 0)
+    {
+        Command_RecorderArm(&command[8]);
+    }
+    else if (strncmp(command, "REC:FORCE", 9) == 0)
+    {
+        Recorder_Trigger(REC_TRIGGER_MANUAL);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "REC:STOP", 8) == 0)
+    {
+        Recorder_Stop();
+        printf("OK\n");
+    }
+    else if (strncmp(command, "REC:STAT?", 9) == 0)
+    {
+        Recorder_Status_t rec = Recorder_GetStatus();
+        printf("STATE:%s,TRIG:%s,SAMPLES:%lu,TRIG_SAMPLE:%lu,FIRST:%lu,BLOCKS:%lu,BYTES:%lu\n",
+               Recorder_GetStateName(rec.state), Recorder_GetTriggerName(rec.trigger),
+               rec.samples, rec.trigger_sample, rec.first_sample, rec.blocks, rec.bytes);
+    }
+    else if (strncmp(command, "REC:DATA?", 9) == 0)
+    {
+        Command_RecorderData(strtoul(&command[9], NULL, 10));
+    }
+    
+    /* List commands */
+    else if (strncmp(command, "LIST:DATA ", 10) == 0)
+    {
+        Command_ListData(&command[10]);
+    }
+    else if (strncmp(command, "LIST:RUN", 8) == 0)
+    {
+        char* end;
+        uint32_t loops = strtoul(&command[8], &end, 10);
+        
+        /* One pass unless a count is given; 0 loops until LIST:STOP */
+        RF_RunList((end == &command[8]) ? 1 : loops);
+    }
+    else if (strncmp(command, "LIST:STOP", 9) == 0)
+    {
+        RF_StopList();
+    }
+    else if (strncmp(command, "LIST:STAT?", 10) == 0)
+    {
+        ListMode_Status_t list = ListMode_GetStatus();
+        char freq[FREQUENCY_TEXT_SIZE];
+        
+        printf("STATE:%s,POINTS:%lu,INDEX:%lu,LOOP:%lu,LOOPS:%lu,STEPS:%lu,FREQ:%s,POWER:%d,SOLVE_US:%lu\n",
+               ListMode_GetStateName(list.state), list.points, list.index, list.loop,
+               list.loops, list.steps, Frequency_ToText(list.frequency, freq), list.power_dbm,
+               list.solve_us);
+    }
+    
+    /* FSK commands */
+    else if (strncmp(command, "FSK:TONES ", 10) == 0)
+    {
+        Frequency_t tones[FSK_TONES_MAX];
+        uint32_t count = 0;
+        char* next;
+        bool valid = Frequency_Parse(&command[10], &next, &tones[count++]);
+        
+        while (valid && *next == ',' && count < FSK_TONES_MAX)
+            valid = Frequency_Parse(next + 1, &next, &tones[count++]);
+        
+        if (valid && *next == '\0' && !RF_IsFskBusy() && Fsk_SetTones(tones, count))
+            printf("OK\n");
+        else
+            printf("ERROR: Invalid tones or FSK running\n");
+    }
+    else if (strncmp(command, "FSK:RATE?", 9) == 0)
+    {
+        Fsk_Status_t fsk = Fsk_GetStatus();
+        printf("RATE:%lu,MAX:%lu,LINK:%lu\n", fsk.rate_hz, fsk.max_rate_hz, fsk.link_rate_hz);
+    }
+    else if (strncmp(command, "FSK:RATE ", 9) == 0)
+    {
+        if (Fsk_SetRate(strtoul(&command[9], NULL, 10)))
+            printf("OK\n");
+        else
+            printf("ERROR: Symbol rate out of range\n");
+    }
+    else if (strncmp(command, "FSK:DATA ", 9) == 0)
+    {
+        Command_FskData(&command[9]);
+    }
+    else if (strncmp(command, "FSK:START", 9) == 0)
+    {
+        RF_StartFsk();
+    }
+    else if (strncmp(command, "FSK:STOP", 8) == 0)
+    {
+        RF_StopFsk();
+    }
+    else if (strncmp(command, "FSK:STAT?", 9) == 0)
+    {
+        Fsk_Status_t fsk = Fsk_GetStatus();
+        char freq[FREQUENCY_TEXT_SIZE];
+        
+        printf("STATE:%s,TONES:%lu,ERROR_HZ:%lu,RATE:%lu,BUFFERED:%lu,SYMBOLS:%lu,UNDERRUNS:%lu,FREQ:%s,REFILL_CYCLES:%lu,CPU_PERMILLE:%lu\n",
+               fsk.running ? "RUNNING" : "IDLE", fsk.tones, fsk.max_error_hz, fsk.rate_hz,
+               fsk.buffered, fsk.symbols, fsk.underruns, Frequency_ToText(fsk.frequency, freq),
+               fsk.refill_cycles, fsk.cpu_permille);
+    }
+    
+    /* Pulse commands */
+    else if (strncmp(command, "PULSE:CONF?", 11) == 0)
+    {
+        Pulse_Status_t pulse = Pulse_GetStatus();
+        printf("PERIOD:%lu,WIDTH:%lu,COUNT:%lu,RES_PS:%lu\n",
+               pulse.period_ns, pulse.width_ns, pulse.count, pulse.resolution_ps);
+    }
+    else if (strncmp(command, "PULSE:CONF ", 11) == 0)
+    {
+        char* next;
+        uint32_t period = strtoul(&command[11], &next, 10);
+        uint32_t width = (*next == ',') ? strtoul(next + 1, &next, 10) : 0;
+        uint32_t count = (*next == ',') ? strtoul(next + 1, NULL, 10) : 0;
+        
+        if (Pulse_Configure(period, width, count))
+            printf("OK\n");
+        else
+            printf("ERROR: Invalid pulse configuration\n");
+    }
+    else if (strcmp(command, "PULSE ON") == 0)
+    {
+        Pulse_Enable(true);
+        printf("OK\n");
+    }
+    else if (strcmp(command, "PULSE OFF") == 0)
+    {
+        Pulse_Enable(false);
+        
+        /* RFControlTask settles a clock profile switch it held back */
+        if (rf_control_task_handle != NULL)
+            xTaskNotify(rf_control_task_handle, RF_EVENT_REQUEST, eSetBits);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "PULSE:TRIG", 10) == 0)
+    {
+        printf(Pulse_Trigger() ? "OK\n" : "ERROR: Pulse bursts not enabled\n");
+    }
+    else if (strcmp(command, "PULSE:SYNC ON") == 0)
+    {
+        Pulse_SetSync(true);
+        printf("OK\n");
+    }
+    else if (strcmp(command, "PULSE:SYNC OFF") == 0)
+    {
+        Pulse_SetSync(false);
+        printf("OK\n");
+    }
+    else if (strncmp(command, "PULSE:STAT?", 11) == 0)
+    {
+        Pulse_Status_t pulse = Pulse_GetStatus();
+        printf("STATE:%s,SYNC:%s,BURSTS:%lu\n", pulse.enabled ? "ON" : "OFF",
+               pulse.sync ? "ON" : "OFF", pulse.bursts);
     }
     
     /* Program commands */
@@ -423,11 +2595,53 @@ static void ProcessCommand(const char* command)
     /* Calibration commands */
     else if (strncmp(command, "CAL:START", 9) == 0)
     {
+        Calibration_Clear();
+        RF_RefreshPower();
         printf("OK\n");
     }
+    else if (strncmp(command, "CAL:POINT ", 10) == 0)
+    {
+        char* next;
+        Frequency_t freq = 0;
+        bool valid = Frequency_Parse(&command[10], &next, &freq);
+        long correction = (*next == ',') ? strtol(next + 1, NULL, 10) : INT8_MAX + 1;
+        
+        if (!valid || freq < RF_FREQ_MIN || freq > RF_FREQ_MAX)
+            printf("ERROR: Frequency out of range\n");
+        else if (correction < INT8_MIN || correction > INT8_MAX)
+            printf("ERROR: Correction out of range\n");
+        else if (!Calibration_AddPoint(freq, (int8_t)correction, 0.0))
+            printf("ERROR: Calibration table full\n");
+        else
+        {
+            RF_RefreshPower();
+            printf("OK\n");
+        }
+    }
+    else if (strncmp(command, "CAL:CORR? ", 10) == 0)
+    {
+        Frequency_t freq;
+        
+        if (Frequency_Parse(&command[10], NULL, &freq))
+            printf("%d\n", Calibration_GetPowerCorrection(freq));
+        else
+            printf("ERROR: Invalid frequency\n");
+    }
+    else if (strncmp(command, "CAL:COUNT?", 10) == 0)
+    {
+        printf("%lu\n", Calibration_GetData()->count);
+    }
     else if (strncmp(command, "CAL:SAVE", 8) == 0)
     {
-        Calibration_SaveToFRAM();
+        if (Calibration_SaveToFRAM())
+            printf("OK\n");
+        else
+            printf("ERROR: FRAM write failed\n");
+    }
+    else if (strncmp(command, "CAL:LOAD", 8) == 0)
+    {
+        Calibration_LoadFromFRAM();
+        RF_RefreshPower();
         printf("OK\n");
     }
     
@@ -451,30 +2665,40 @@ int main(void)
     SystemInit();
     
     /* Create FreeRTOS tasks */
-    xTaskCreate(MonitorTask, 
-                "Monitor", 
-                512, 
-                NULL, 
-                2, 
-                &monitor_task_handle);
-    
-    xTaskCreate(RFControlTask, 
-                "RFControl", 
-                256, 
-                NULL, 
-                1, 
-                &rf_control_task_handle);
-    
-    xTaskCreate(CommandTask, 
-                "Command", 
-                512, 
-                NULL, 
-                3, 
-                &command_task_handle);
-    
-    printf("Starting FreeRTOS scheduler...\n\n");
+    monitor_task_handle = xTaskCreateStatic(MonitorTask,
+                                            "Monitor",
+                                            TASK_MONITOR_STACK_WORDS,
+                                            NULL,
+                                            TASK_MONITOR_PRIORITY,
+                                            monitor_task_stack,
+                                            &monitor_task_tcb);
+    
+    rf_control_task_handle = xTaskCreateStatic(RFControlTask,
+                                               "RFControl",
+                                               TASK_RFCONTROL_STACK_WORDS,
+                                               NULL,
+                                               TASK_RFCONTROL_PRIORITY,
+                                               rf_control_task_stack,
+                                               &rf_control_task_tcb);
+    
+    command_task_handle = xTaskCreateStatic(CommandTask,
+                                            "Command",
+                                            TASK_COMMAND_STACK_WORDS,
+                                            NULL,
+                                            TASK_COMMAND_PRIORITY,
+                                            command_task_stack,
+                                            &command_task_tcb);
+    
+    log_task_handle = xTaskCreateStatic(LogTask,
+                                        "Log",
+                                        TASK_LOG_STACK_WORDS,
+                                        NULL,
+                                        TASK_LOG_PRIORITY,
+                                        log_task_stack,
+                                        &log_task_tcb);
     
     /* Start FreeRTOS scheduler */
+    BootProfile_Mark(BOOT_STAGE_SCHEDULER);
     vTaskStartScheduler();
     
     /* Should never reach here */
@@ -502,15 +2726,27 @@ void vApplicationStackOverflowHook(xTaskHandle xTask, signed char *pcTaskName)
 }
 
 /**
- * @brief Memory allocation failed handler
+ * @brief Idle task memory (static allocation)
  */
-void vApplicationMallocFailedHook(void)
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
 {
-    printf("\n!!! MALLOC FAILED !!!\n");
-    
-    GPIO_SetErrorLED(true);
-    
-    while (1);
+    *ppxIdleTaskTCBBuffer = &idle_task_tcb;
+    *ppxIdleTaskStackBuffer = idle_task_stack;
+    *pulIdleTaskStackSize = TASK_IDLE_STACK_WORDS;
+}
+
+/**
+ * @brief Timer service task memory (static allocation)
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &timer_task_tcb;
+    *ppxTimerTaskStackBuffer = timer_task_stack;
+    *pulTimerTaskStackSize = TASK_TIMER_STACK_WORDS;
 }
 
 /**
@@ -528,11 +2764,3 @@ void vApplicationTickHook(void)
 {
     /* Optional: periodic tasks here */
 }
-
-/**
- * @brief Get free heap size
- */
-size_t xPortGetFreeHeapSize(void)
-{
-    return xGetFreeHeapSize();
-}
\ No newline at end of file
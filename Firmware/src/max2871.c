@@ -1,20 +1,174 @@
 /**
  * MAX2871 RF Synthesizer Driver
- * Frequency Range: 10 MHz - 6 GHz
+ * Frequency Range: 23.4375 MHz - 6 GHz
  * Communication: SPI
  */
 
 #include "max2871.h"
+#include "hal_gpio.h"
+#include "hal_timer.h"
+#include "logger.h"
 #include "stm32h743xx.h"
 #include "stm32h7xx_hal.h"
-#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS */
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
 
 /* SPI Handle */
 static SPI_HandleTypeDef hspi;
 
+/* Lock detect input: MAX2871 LD pin on PA3 (EXTI3) */
+#define MAX2871_LD_PORT GPIOA
+#define MAX2871_LD_PIN GPIO_PIN_3
+#define MAX2871_LD_IRQn EXTI3_IRQn
+
+/* Register fields (bit positions in the full 32-bit word) */
+#define MAX2871_R0_INT          (1UL << 31)     /* Integer-N mode */
+#define MAX2871_R0_N_Pos        15
+#define MAX2871_R0_FRAC_Pos     3
+#define MAX2871_R1_CPL_FRAC     (1UL << 29)     /* Charge pump linearity for frac-N */
+#define MAX2871_R1_P_Pos        15
+#define MAX2871_R1_M_Pos        3
+#define MAX2871_R2_R_Pos        14
+#define MAX2871_R2_REG4DB       (1UL << 13)     /* R4 double buffered, latched by R0 */
+#define MAX2871_R2_CP_Pos       9
+#define MAX2871_R2_LDF_INT      (1UL << 8)      /* Lock detect function for int-N */
+#define MAX2871_R2_PDP          (1UL << 6)      /* Positive phase detector polarity */
+#define MAX2871_R2_MUX_Pos      26              /* MUXOUT select bits [2:0] */
+#define MAX2871_R3_VCO_Pos      26              /* VCO band when autoselect is off */
+#define MAX2871_R3_VCO_Msk      (0x3FUL << MAX2871_R3_VCO_Pos)
+#define MAX2871_R3_VAS_SHDN     (1UL << 25)     /* VCO autoselect disabled */
+#define MAX2871_R3_CDIV_Pos     3
+#define MAX2871_R4_RESERVED     (0x3UL << 29)
+#define MAX2871_R4_BS_MSB_Pos   24
+#define MAX2871_R4_FB           (1UL << 23)     /* Feedback from the VCO (fundamental) */
+#define MAX2871_R4_DIVA_Pos     20
+#define MAX2871_R4_BS_LSB_Pos   12
+#define MAX2871_R4_RFA_EN       (1UL << 5)
+#define MAX2871_R4_APWR_Pos     3
+#define MAX2871_R4_APWR_Msk     (0x3UL << MAX2871_R4_APWR_Pos)
+#define MAX2871_R5_F01          (1UL << 24)     /* Int-N automatically when F = 0 */
+#define MAX2871_R5_LD_DIGITAL   (0x1UL << 22)   /* LD pin = digital lock detect */
+#define MAX2871_R5_MUX_MSB      (1UL << 18)     /* MUXOUT select bit 3 */
+#define MAX2871_R6_VCO_Pos      3               /* Read back: VCO band in use */
+#define MAX2871_R6_VCO_Msk      (0x3FUL << MAX2871_R6_VCO_Pos)
+
+/* MUXOUT = serial data out (MUX 1100) for register read back */
+#define MAX2871_MUX_READBACK_R2 (0x4UL << MAX2871_R2_MUX_Pos)
+#define MAX2871_MUX_READBACK_R5 MAX2871_R5_MUX_MSB
+
+/* Frequency plan (Frequency_t, millihertz) */
+#define MAX2871_PFD             FREQUENCY_HZ(MAX2871_REF_HZ)
+#define MAX2871_VCO_MIN         FREQUENCY_HZ(3000000000ULL)
+#define MAX2871_VCO_MAX         FREQUENCY_HZ(6000000000ULL)
+#define MAX2871_VCO_TABLE_STEP  FREQUENCY_HZ(MAX2871_VCO_TABLE_STEP_HZ)
+#define MAX2871_DIVA_MAX        7               /* Output divider 2^7 = 128 */
+#define MAX2871_MOD_MAX         4095            /* 12-bit modulus */
+#define MAX2871_FRACTION_SHIFT  3               /* PFD in 8 mHz units fits 32 bits */
+#define MAX2871_CP_CURRENT      7
+#define MAX2871_BS_CLOCK_HZ     50000UL         /* VCO band select clock <= 50 kHz */
+#define MAX2871_BS_DIV          (MAX2871_REF_HZ / MAX2871_BS_CLOCK_HZ)
+
+/* Solve cache: linear probing over at most this many slots from home */
+#define MAX2871_CACHE_PROBES    8
+#define MAX2871_CACHE_MASK      (MAX2871_CACHE_SIZE - 1)
+
+/* Lock wait after a retune. With autoselect the band search takes about
+ * 10 band select clock periods (200 us at 50 kHz) before the loop settles;
+ * with a learned band only the loop settles (tens of us), so a missed band
+ * falls back to autoselect quickly. Both are a few times the typical time. */
+#define MAX2871_LOCK_TIMEOUT_US         1000UL
+#define MAX2871_DIRECT_LOCK_TIMEOUT_US  250UL
+
+/* Digital LD drops within a few PFD periods of an R0 write; a pin still
+ * high this long after the write means the step kept the loop locked */
+#define MAX2871_LD_RESPONSE_US  5
+
+/* CS setup/hold around a register write (datasheet minimum is ns) */
+#define MAX2871_CS_DELAY_US 1
+
+/* One register word through MAX2871_WriteWord: a single 32-bit frame
+ * (2 us at 16 MHz SCK), CS setup and hold, and about 1 us of HAL call
+ * overhead. A scheduled commit starts this much early per word so R0
+ * latches on time. */
+#define MAX2871_COMMIT_WORD_US  ((32UL * 1000000UL) / MAX2871_SCK_HZ + 2 * MAX2871_CS_DELAY_US + 1)
+
+/* SCK from the 64 MHz HSI kernel clock, prescaler 4 */
+#define MAX2871_SCK_HZ          16000000UL
+
+/* Streaming: hardware CS pulses high between words to latch each one */
+#define MAX2871_STREAM_MSSI     1       /* SCK periods from CS low to data */
+#define MAX2871_STREAM_MIDI     2       /* SCK periods of CS high between words */
+#define MAX2871_STREAM_WORD_CYCLES (32 + MAX2871_STREAM_MSSI + MAX2871_STREAM_MIDI)
+
 /* Status variables */
-static uint32_t current_frequency = 2400000000UL;
-static bool pll_locked = false;
+static Frequency_t current_frequency = FREQUENCY_HZ(2400000000UL);
+static volatile bool pll_locked = false;
+static uint8_t power_mode = 0;
+
+/* Last image written to the chip; invalid until the first full write */
+static MAX2871_Registers_t shadow;
+static bool shadow_valid = false;
+
+/* Lock detect state - written from the EXTI ISR */
+static volatile MAX2871_LockStats_t lock_stats;
+static volatile bool retune_pending = false;
+static volatile uint32_t retune_start_us = 0;
+static volatile bool blank_on_unlock = false;
+static MAX2871_LockCallback_t lock_callback = NULL;
+
+/* Learned VCO bands (NULL = chip autoselect) and relock time per mode */
+static const uint8_t* volatile vco_table = NULL;
+static volatile bool retune_direct = false;
+static volatile uint32_t relock_sum_us[2];      /* [0] autoselect, [1] direct */
+static volatile uint32_t relock_count[2];
+static uint32_t vco_fallbacks = 0;
+
+/* Scheduled commit - staged by MAX2871_Schedule, sent by the alarm ISR */
+static MAX2871_Registers_t commit_image;
+static uint32_t commit_words[6];
+static uint32_t commit_word_count = 0;
+static volatile bool commit_armed = false;
+static volatile MAX2871_CommitStats_t commit_stats;
+
+/* Solve cache - solved images keyed by frequency (0 = empty slot) */
+typedef struct {
+    Frequency_t frequency;
+    uint32_t reg[6];
+} MAX2871_CacheEntry_t;
+
+static MAX2871_CacheEntry_t solve_cache[MAX2871_CACHE_SIZE];
+static MAX2871_CacheStats_t cache_stats;
+static uint32_t cache_victim = 0;
+
+/* Bumped when the frequency plan changes; the cache is emptied lazily
+ * by the next solve that sees a new generation */
+static volatile uint32_t plan_generation = 0;
+static uint32_t cache_generation = 0;
+
+/* The cache, the band table and the generation change together under this
+ * lock: CommandTask solves ahead while RFControlTask changes the plan */
+static SemaphoreHandle_t cache_mutex = NULL;
+static StaticSemaphore_t cache_mutex_buffer;
+
+/* SPI1 handed to a DMA stream (MAX2871_BeginStream) */
+static bool stream_active = false;
+
+static void MAX2871_InitSPI(bool stream);
+static void MAX2871_CacheLock(void);
+static void MAX2871_CacheUnlock(void);
+static void MAX2871_CacheReset(void);
+static void MAX2871_CacheCheckGeneration(void);
+static void MAX2871_InitLockDetect(void);
+static void MAX2871_CommitISR(void);
+static bool MAX2871_SolvePlan(Frequency_t frequency, MAX2871_Registers_t* image);
+static bool MAX2871_ApplyImage(const MAX2871_Registers_t* image);
+static void MAX2871_BeginRetune(const MAX2871_Registers_t* image);
+static bool MAX2871_ReadBand(uint8_t* band);
+static void MAX2871_WriteWord(uint32_t word);
 
 /* ============================= */
 /* INITIALIZATION                */
@@ -26,26 +180,64 @@ static bool pll_locked = false;
 void MAX2871_Init(void)
 {
     /* Initialize SPI for MAX2871 */
+    MAX2871_InitSPI(false);
+    cache_mutex = xSemaphoreCreateMutexStatic(&cache_mutex_buffer);
+    
+    LOG_DEBUG("MAX2871 SPI initialized\n");
+    
+    /* Route digital lock detect to the LD pin and watch it by interrupt */
+    MAX2871_WriteWord(MAX2871_R5_F01 | MAX2871_R5_LD_DIGITAL | 5);
+    MAX2871_InitLockDetect();
+    shadow_valid = false;
+    
+    /* Output frequency is programmed by the caller (default or restored) */
+    LOG_INFO("MAX2871 initialized\n");
+}
+
+/**
+ * @brief Configure SPI1 for register access or for DMA streaming
+ * Streaming is transmit only with hardware CS (PA4 as SPI1_NSS), pulsed
+ * high between frames, so each word written to TXDR is latched on its own.
+ */
+static void MAX2871_InitSPI(bool stream)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    
     hspi.Instance = SPI1;
     hspi.Init.Mode = SPI_MODE_MASTER;
-    hspi.Init.Direction = SPI_DIRECTION_2LINES;
+    hspi.Init.Direction = stream ? SPI_DIRECTION_2LINES_TXONLY : SPI_DIRECTION_2LINES;
     hspi.Init.DataSize = SPI_DATASIZE_32BIT;
     hspi.Init.CLKPolarity = SPI_POLARITY_HIGH;
     hspi.Init.CLKPhase = SPI_PHASE_2EDGE;
-    hspi.Init.NSS = SPI_NSS_SOFT;
-    hspi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4;
+    hspi.Init.NSS = stream ? SPI_NSS_HARD_OUTPUT : SPI_NSS_SOFT;
+    hspi.Init.NSSPMode = stream ? SPI_NSS_PULSE_ENABLE : SPI_NSS_PULSE_DISABLE;
+    hspi.Init.NSSPolarity = SPI_NSS_POLARITY_LOW;
+    hspi.Init.MasterSSIdleness = SPI_MASTER_SS_IDLENESS_01CYCLE;
+    hspi.Init.MasterInterDataIdleness = SPI_MASTER_INTERDATA_IDLENESS_02CYCLE;
+    hspi.Init.MasterKeepIOState = SPI_MASTER_KEEP_IO_STATE_ENABLE;
+    hspi.Init.FifoThreshold = SPI_FIFO_THRESHOLD_01DATA;
+    hspi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4;   /* 64 MHz HSI kernel -> 16 MHz SCK */
     hspi.Init.FirstBit = SPI_FIRSTBIT_MSB;
     hspi.Init.TIMode = SPI_TIMODE_DISABLE;
     hspi.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
     
     HAL_SPI_Init(&hspi);
     
-    printf("MAX2871 SPI initialized\n");
+    if (!stream)
+        return;
     
-    /* Set default frequency (2400 MHz) */
-    MAX2871_SetFrequency(2400000000UL);
+    /* CS to the SPI; it idles high while the SPI is enabled */
+    GPIO_InitStruct.Pin = GPIO_PIN_4;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF5_SPI1;
     
-    printf("MAX2871 initialized - Freq: 2400 MHz\n");
+    /* Endless transfer: a frame goes out whenever TXDR is written */
+    SPI1->CR2 = 0;
+    __HAL_SPI_ENABLE(&hspi);
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    SPI1->CR1 |= SPI_CR1_CSTART;
 }
 
 /**
@@ -61,54 +253,922 @@ void MAX2871_DeInit(void)
 /* ============================= */
 
 /**
- * @brief Set RF frequency
- * @param frequency_hz Frequency in Hz (10 MHz - 6 GHz)
+ * @brief |num/den - h/k| scaled by den * k
+ */
+static uint64_t MAX2871_FractionError(uint32_t num, uint32_t den, uint32_t h, uint32_t k)
+{
+    uint64_t lhs = (uint64_t)num * k;
+    uint64_t rhs = (uint64_t)h * den;
+    
+    return (lhs > rhs) ? lhs - rhs : rhs - lhs;
+}
+
+/**
+ * @brief Best FRAC/MOD approximation of num/den with MOD <= MAX2871_MOD_MAX
+ * Continued-fraction convergents; the last step may be a semiconvergent.
  */
-void MAX2871_SetFrequency(uint32_t frequency_hz)
+static void MAX2871_Fraction(uint32_t num, uint32_t den, uint32_t* frac, uint32_t* mod)
 {
-    if (frequency_hz < 10000000UL || frequency_hz > 6000000000UL)
+    uint32_t h_prev = 0, h = 1;     /* Numerators h(-2), h(-1) */
+    uint32_t k_prev = 1, k = 0;     /* Denominators k(-2), k(-1) */
+    uint32_t n = num;
+    uint32_t d = den;
+    
+    while (d != 0)
+    {
+        uint32_t a = n / d;
+        uint32_t r = n % d;
+        
+        if ((uint64_t)a * k + k_prev > MAX2871_MOD_MAX)
+        {
+            /* Largest semiconvergent that fits - keep it if it beats h/k */
+            uint32_t t = (MAX2871_MOD_MAX - k_prev) / k;
+            uint32_t hs = t * h + h_prev;
+            uint32_t ks = t * k + k_prev;
+            uint64_t err_s = MAX2871_FractionError(num, den, hs, ks);
+            uint64_t err_c = MAX2871_FractionError(num, den, h, k);
+            
+            /* Compare err_s / ks against err_c / k */
+            if (t > 0 && err_s * k < err_c * ks)
+            {
+                h = hs;
+                k = ks;
+            }
+            break;
+        }
+        
+        uint32_t h_next = a * h + h_prev;
+        uint32_t k_next = a * k + k_prev;
+        h_prev = h;
+        h = h_next;
+        k_prev = k;
+        k = k_next;
+        n = d;
+        d = r;
+    }
+    
+    *frac = h;
+    *mod = k;
+}
+
+/**
+ * @brief Compute the register image for a frequency (no cache)
+ * @param frequency Output frequency (MAX2871_FREQ_MIN_HZ - 6 GHz)
+ * @param image Complete R0..R5 image
+ * @return false if the frequency cannot be synthesized
+ */
+static bool MAX2871_SolvePlan(Frequency_t frequency, MAX2871_Registers_t* image)
+{
+    Frequency_t vco = frequency;
+    uint32_t diva = 0;
+    
+    /* Smallest output divider that puts the VCO in range */
+    while (vco < MAX2871_VCO_MIN && diva < MAX2871_DIVA_MAX)
+    {
+        vco <<= 1;
+        diva++;
+    }
+    
+    if (vco < MAX2871_VCO_MIN || vco > MAX2871_VCO_MAX)
+        return false;
+    
+    /* VCO = PFD * (N + FRAC / MOD); the fraction is searched in 8 mHz
+     * units, still far below what a 12-bit modulus can resolve */
+    uint32_t n = (uint32_t)(vco / MAX2871_PFD);
+    uint32_t remainder = (uint32_t)((vco - (uint64_t)n * MAX2871_PFD) >> MAX2871_FRACTION_SHIFT);
+    uint32_t frac = 0;
+    uint32_t mod = MAX2871_MOD_MAX;
+    
+    if (remainder != 0)
+    {
+        MAX2871_Fraction(remainder, (uint32_t)(MAX2871_PFD >> MAX2871_FRACTION_SHIFT), &frac, &mod);
+        
+        /* Rounded up to the next integer */
+        if (frac == mod)
+        {
+            n++;
+            frac = 0;
+            mod = MAX2871_MOD_MAX;
+        }
+    }
+    bool integer_n = (frac == 0);
+    
+    image->reg[0] = (integer_n ? MAX2871_R0_INT : 0) |
+                    (n << MAX2871_R0_N_Pos) |
+                    (frac << MAX2871_R0_FRAC_Pos) | 0;
+    image->reg[1] = (integer_n ? 0 : MAX2871_R1_CPL_FRAC) |
+                    (1UL << MAX2871_R1_P_Pos) |
+                    (mod << MAX2871_R1_M_Pos) | 1;
+    image->reg[2] = (1UL << MAX2871_R2_R_Pos) |
+                    MAX2871_R2_REG4DB |
+                    (MAX2871_CP_CURRENT << MAX2871_R2_CP_Pos) |
+                    (integer_n ? MAX2871_R2_LDF_INT : 0) |
+                    MAX2871_R2_PDP | 2;
+    image->reg[3] = (1UL << MAX2871_R3_CDIV_Pos) | 3;
+    
+    /* Learned band: skip the autoselect search */
+    const uint8_t* bands = vco_table;
+    if (bands != NULL)
+    {
+        uint32_t point = (uint32_t)((vco - MAX2871_VCO_MIN + MAX2871_VCO_TABLE_STEP / 2) /
+                                    MAX2871_VCO_TABLE_STEP);
+        if (point >= MAX2871_VCO_TABLE_POINTS)
+            point = MAX2871_VCO_TABLE_POINTS - 1;
+        
+        image->reg[3] |= MAX2871_R3_VAS_SHDN |
+                         ((uint32_t)(bands[point] & 0x3F) << MAX2871_R3_VCO_Pos);
+    }
+    image->reg[4] = MAX2871_R4_RESERVED |
+                    ((MAX2871_BS_DIV >> 8) << MAX2871_R4_BS_MSB_Pos) |
+                    MAX2871_R4_FB |
+                    (diva << MAX2871_R4_DIVA_Pos) |
+                    ((MAX2871_BS_DIV & 0xFF) << MAX2871_R4_BS_LSB_Pos) |
+                    MAX2871_R4_RFA_EN |
+                    ((uint32_t)power_mode << MAX2871_R4_APWR_Pos) | 4;
+    image->reg[5] = MAX2871_R5_F01 | MAX2871_R5_LD_DIGITAL | 5;
+    image->frequency = frequency;
+    
+    return true;
+}
+
+/* ============================= */
+/* SOLVE CACHE                   */
+/* ============================= */
+
+/**
+ * @brief Take the solve cache (no-op before the scheduler starts)
+ */
+static void MAX2871_CacheLock(void)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+        xSemaphoreTake(cache_mutex, portMAX_DELAY);
+}
+
+/**
+ * @brief Release the solve cache
+ */
+static void MAX2871_CacheUnlock(void)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+        xSemaphoreGive(cache_mutex);
+}
+
+/**
+ * @brief Empty the cache if the plan changed since it was filled (locked)
+ */
+static void MAX2871_CacheCheckGeneration(void)
+{
+    if (cache_generation != plan_generation)
+    {
+        MAX2871_CacheReset();
+        cache_generation = plan_generation;
+    }
+}
+
+/**
+ * @brief Home slot of a frequency (Fibonacci hashing of both halves folded)
+ */
+static uint32_t MAX2871_CacheHome(Frequency_t frequency)
+{
+    uint32_t key = (uint32_t)frequency ^ (uint32_t)(frequency >> 32);
+    
+    return (uint32_t)(key * 2654435769UL) >> (32 - MAX2871_CACHE_BITS);
+}
+
+/**
+ * @brief Look up a solved image; APWR is patched to the current power mode
+ */
+static bool MAX2871_CacheLookup(Frequency_t frequency, MAX2871_Registers_t* image)
+{
+    uint32_t slot = MAX2871_CacheHome(frequency);
+    
+    for (uint32_t probe = 0; probe < MAX2871_CACHE_PROBES; probe++)
+    {
+        const MAX2871_CacheEntry_t* entry = &solve_cache[(slot + probe) & MAX2871_CACHE_MASK];
+        
+        if (entry->frequency == 0)
+            return false;
+        
+        if (entry->frequency == frequency)
+        {
+            for (int reg = 0; reg < 6; reg++)
+                image->reg[reg] = entry->reg[reg];
+            image->reg[4] = (image->reg[4] & ~MAX2871_R4_APWR_Msk) |
+                            ((uint32_t)power_mode << MAX2871_R4_APWR_Pos);
+            image->frequency = frequency;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Store a solved image
+ * Takes the first free slot in the probe window, otherwise evicts one of
+ * them round-robin. Slots are never emptied, so other probe chains stay
+ * intact.
+ */
+static void MAX2871_CacheInsert(const MAX2871_Registers_t* image)
+{
+    uint32_t slot = MAX2871_CacheHome(image->frequency);
+    MAX2871_CacheEntry_t* entry = NULL;
+    
+    for (uint32_t probe = 0; probe < MAX2871_CACHE_PROBES; probe++)
+    {
+        MAX2871_CacheEntry_t* candidate = &solve_cache[(slot + probe) & MAX2871_CACHE_MASK];
+        
+        if (candidate->frequency == image->frequency)
+            return;
+        
+        if (candidate->frequency == 0)
+        {
+            entry = candidate;
+            cache_stats.entries++;
+            break;
+        }
+    }
+    
+    if (entry == NULL)
+    {
+        entry = &solve_cache[(slot + cache_victim) & MAX2871_CACHE_MASK];
+        cache_victim = (cache_victim + 1) % MAX2871_CACHE_PROBES;
+        cache_stats.evictions++;
+    }
+    
+    for (int reg = 0; reg < 6; reg++)
+        entry->reg[reg] = image->reg[reg];
+    entry->frequency = image->frequency;
+}
+
+/**
+ * @brief Solve the register image for a frequency, through the cache
+ * Task context only (the cache is locked).
+ * @param frequency Output frequency (MAX2871_FREQ_MIN_HZ - 6 GHz)
+ * @param image Complete R0..R5 image
+ * @return false if the frequency cannot be synthesized
+ */
+bool MAX2871_Solve(Frequency_t frequency, MAX2871_Registers_t* image)
+{
+    uint32_t start = Timer_GetCycles();
+    bool solved = true;
+    
+    MAX2871_CacheLock();
+    MAX2871_CacheCheckGeneration();
+    
+    if (MAX2871_CacheLookup(frequency, image))
+    {
+        cache_stats.hits++;
+        cache_stats.hit_cycles = Timer_GetCycles() - start;
+    }
+    else if (MAX2871_SolvePlan(frequency, image))
+    {
+        MAX2871_CacheInsert(image);
+        cache_stats.misses++;
+        cache_stats.miss_cycles = Timer_GetCycles() - start;
+    }
+    else
+    {
+        solved = false;
+    }
+    
+    MAX2871_CacheUnlock();
+    return solved;
+}
+
+/**
+ * @brief Solve without the cache, for bulk lists that would flush it
+ * The image depends on the frequency plan; compare
+ * MAX2871_GetPlanGeneration() before reusing it later.
+ */
+bool MAX2871_SolveUncached(Frequency_t frequency, MAX2871_Registers_t* image)
+{
+    return MAX2871_SolvePlan(frequency, image);
+}
+
+/**
+ * @brief Changes whenever previously solved images become stale
+ */
+uint32_t MAX2871_GetPlanGeneration(void)
+{
+    return plan_generation;
+}
+
+/**
+ * @brief Output error of vco with FRAC rounded for a given MOD
+ * @return Error at the VCO in mHz, and the N/FRAC pair through n/frac
+ */
+static uint64_t MAX2871_ModulusError(Frequency_t vco, uint32_t mod, uint32_t* n, uint32_t* frac)
+{
+    *n = (uint32_t)(vco / MAX2871_PFD);
+    
+    uint64_t remainder = vco - (uint64_t)*n * MAX2871_PFD;
+    uint64_t scaled = remainder * mod;
+    
+    *frac = (uint32_t)((scaled + MAX2871_PFD / 2) / MAX2871_PFD);
+    
+    uint64_t actual = (uint64_t)*frac * MAX2871_PFD;
+    uint64_t error = (actual > scaled) ? actual - scaled : scaled - actual;
+    
+    if (*frac == mod)
+    {
+        (*n)++;
+        *frac = 0;
+    }
+    return (error + mod / 2) / mod;
+}
+
+/**
+ * @brief Solve a set of tones that differ only in R0
+ *
+ * All tones share the output divider and one modulus, so switching
+ * between them is a single R0 write. The modulus is picked from the best
+ * approximations of the individual tones to minimise the worst error.
+ * @param frequency Tones; the image is solved for the first
+ * @param image Shared R1..R5 (and R0 of the first tone)
+ * @param words R0 word per tone
+ * @param max_error_hz Worst tone error at the output, rounded to Hz
+ * @return false if a tone cannot be synthesized or needs another divider
+ */
+bool MAX2871_SolveTones(const Frequency_t* frequency, uint32_t count,
+                        MAX2871_Registers_t* image, uint32_t* words, uint32_t* max_error_hz)
+{
+    uint32_t best_mod = MAX2871_MOD_MAX;
+    uint64_t best_error = UINT64_MAX;
+    uint32_t n, frac;
+    
+    if (count == 0 || !MAX2871_SolvePlan(frequency[0], image))
+        return false;
+    
+    uint32_t diva = (image->reg[4] >> MAX2871_R4_DIVA_Pos) & MAX2871_DIVA_MAX;
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Frequency_t vco = frequency[i] << diva;
+        if (vco < MAX2871_VCO_MIN || vco > MAX2871_VCO_MAX)
+            return false;
+    }
+    
+    /* Candidates: each tone's own modulus, and the finest one */
+    for (uint32_t c = 0; c <= count; c++)
+    {
+        uint32_t mod = MAX2871_MOD_MAX;
+        uint64_t worst = 0;
+        
+        if (c < count)
+        {
+            Frequency_t vco = frequency[c] << diva;
+            uint32_t remainder = (uint32_t)((vco % MAX2871_PFD) >> MAX2871_FRACTION_SHIFT);
+            
+            if (remainder != 0)
+                MAX2871_Fraction(remainder, (uint32_t)(MAX2871_PFD >> MAX2871_FRACTION_SHIFT), &frac, &mod);
+            if (mod < 2)
+                continue;
+        }
+        
+        for (uint32_t i = 0; i < count && worst < best_error; i++)
+        {
+            uint64_t error = MAX2871_ModulusError(frequency[i] << diva, mod, &n, &frac);
+            if (error > worst)
+                worst = error;
+        }
+        
+        if (worst < best_error)
+        {
+            best_error = worst;
+            best_mod = mod;
+        }
+    }
+    
+    /* Frac-N throughout: no int-N switch when a tone lands on FRAC = 0 */
+    for (uint32_t i = 0; i < count; i++)
+    {
+        MAX2871_ModulusError(frequency[i] << diva, best_mod, &n, &frac);
+        words[i] = (n << MAX2871_R0_N_Pos) | (frac << MAX2871_R0_FRAC_Pos) | 0;
+    }
+    
+    image->reg[0] = words[0];
+    image->reg[1] = MAX2871_R1_CPL_FRAC | (1UL << MAX2871_R1_P_Pos) |
+                    (best_mod << MAX2871_R1_M_Pos) | 1;
+    image->reg[2] &= ~MAX2871_R2_LDF_INT;
+    image->reg[5] &= ~MAX2871_R5_F01;
+    
+    *max_error_hz = (uint32_t)Frequency_ToHz(((best_error + (1UL << diva) / 2) >> diva) +
+                                             FREQUENCY_UNITS_PER_HZ / 2);
+    return true;
+}
+
+/**
+ * @brief Warm the cache with a frequency (not counted as a miss)
+ * @return false if the frequency cannot be synthesized
+ */
+bool MAX2871_CachePreload(Frequency_t frequency)
+{
+    MAX2871_Registers_t image;
+    bool solved = true;
+    
+    MAX2871_CacheLock();
+    MAX2871_CacheCheckGeneration();
+    
+    if (!MAX2871_CacheLookup(frequency, &image))
+    {
+        solved = MAX2871_SolvePlan(frequency, &image);
+        if (solved)
+            MAX2871_CacheInsert(&image);
+    }
+    
+    MAX2871_CacheUnlock();
+    return solved;
+}
+
+/**
+ * @brief Empty the cache and reset its statistics (locked)
+ */
+static void MAX2871_CacheReset(void)
+{
+    memset(solve_cache, 0, sizeof(solve_cache));
+    memset(&cache_stats, 0, sizeof(cache_stats));
+    cache_victim = 0;
+}
+
+/**
+ * @brief Empty the cache and reset its statistics
+ */
+void MAX2871_CacheClear(void)
+{
+    MAX2871_CacheLock();
+    MAX2871_CacheReset();
+    MAX2871_CacheUnlock();
+}
+
+/**
+ * @brief Get cache statistics
+ */
+MAX2871_CacheStats_t MAX2871_GetCacheStats(void)
+{
+    MAX2871_CacheLock();
+    MAX2871_CacheStats_t stats = cache_stats;
+    MAX2871_CacheUnlock();
+    
+    stats.capacity = MAX2871_CACHE_SIZE;
+    return stats;
+}
+
+/**
+ * @brief Write a solved image and wait for lock
+ * An image with a learned VCO band that does not lock (drift, or a table
+ * from another part) is retried with the chip's autoselect.
+ * @return true if the PLL locked within the lock timeout
+ */
+bool MAX2871_Apply(const MAX2871_Registers_t* image)
+{
+    if (MAX2871_ApplyImage(image))
+        return true;
+    
+    if ((image->reg[3] & MAX2871_R3_VAS_SHDN) == 0)
+        return false;
+    
+    MAX2871_Registers_t retry = *image;
+    retry.reg[3] &= ~(MAX2871_R3_VCO_Msk | MAX2871_R3_VAS_SHDN);
+    vco_fallbacks++;
+    
+    LOG_WARN("MAX2871: Learned VCO band missed at %lu kHz\n", Frequency_ToKHz(image->frequency));
+    return MAX2871_ApplyImage(&retry);
+}
+
+/**
+ * @brief Write an image and wait for the LD interrupt to report lock
+ * The wait is MAX2871_DIRECT_LOCK_TIMEOUT_US with a learned band,
+ * MAX2871_LOCK_TIMEOUT_US with autoselect.
+ */
+static bool MAX2871_ApplyImage(const MAX2871_Registers_t* image)
+{
+    uint32_t timeout_us = ((image->reg[3] & MAX2871_R3_VAS_SHDN) != 0) ?
+                          MAX2871_DIRECT_LOCK_TIMEOUT_US : MAX2871_LOCK_TIMEOUT_US;
+    
+    MAX2871_BeginRetune(image);
+    MAX2871_WriteRegisters(image);
+    current_frequency = image->frequency;
+    
+    /* LD never dropped - a small step that stayed locked, no edge to wait for */
+    uint32_t written_us = Timer_GetMicros();
+    while ((Timer_GetMicros() - written_us) < MAX2871_LD_RESPONSE_US)
+    {
+    }
+    if (!pll_locked && HAL_GPIO_ReadPin(MAX2871_LD_PORT, MAX2871_LD_PIN) == GPIO_PIN_SET)
+    {
+        retune_pending = false;
+        pll_locked = true;
+        return true;
+    }
+    
+    /* Wait for the LD interrupt to report lock (device time - works before SysTick runs) */
+    while (!pll_locked && (Timer_GetMicros() - retune_start_us) < timeout_us)
     {
-        printf("MAX2871: Frequency out of range\n");
-        return;
     }
     
-    current_frequency = frequency_hz;
+    /* No lock edge in time - report the pin level */
+    if (!pll_locked)
+    {
+        retune_pending = false;
+        pll_locked = (HAL_GPIO_ReadPin(MAX2871_LD_PORT, MAX2871_LD_PIN) == GPIO_PIN_SET);
+    }
+    
+    return pll_locked;
+}
+
+/**
+ * @brief Mark a retune for the lock detect ISR
+ * Lock loss during a retune is expected - not counted as an event.
+ */
+static void MAX2871_BeginRetune(const MAX2871_Registers_t* image)
+{
+    retune_start_us = Timer_GetMicros();
+    retune_direct = (image->reg[3] & MAX2871_R3_VAS_SHDN) != 0;
+    retune_pending = true;
+    pll_locked = false;
+}
+
+/**
+ * @brief Write an image without waiting for lock (list mode dwell ISR)
+ * Only the words that differ from the shadow are sent, R0 last, with
+ * APWR patched to the current power mode. The caller must own the chip:
+ * nothing else may write it until the caller is done.
+ */
+void MAX2871_Commit(const MAX2871_Registers_t* image)
+{
+    MAX2871_Registers_t patched = *image;
     
-    /**
-     * MAX2871 Frequency Calculation
-     * R_DIVIDER = 25 MHz (reference)
-     * N_VALUE = frequency / (R_DIVIDER / R)
-     * Simplified: N = frequency / 25MHz
-     */
+    patched.reg[4] = (patched.reg[4] & ~MAX2871_R4_APWR_Msk) |
+                     ((uint32_t)power_mode << MAX2871_R4_APWR_Pos);
     
-    uint32_t n_divider = frequency_hz / 25000000UL;
+    MAX2871_BeginRetune(&patched);
+    MAX2871_WriteRegisters(&patched);
+    current_frequency = patched.frequency;
+}
+
+/**
+ * @brief Set RF frequency
+ * @param frequency Frequency (MAX2871_FREQ_MIN_HZ - 6 GHz)
+ * @return false if out of range or the PLL did not lock
+ */
+bool MAX2871_SetFrequency(Frequency_t frequency)
+{
+    MAX2871_Registers_t image;
     
-    /* Write to MAX2871 register 0 (N value) */
-    MAX2871_WriteRegister(0, n_divider);
+    if (!MAX2871_Solve(frequency, &image))
+    {
+        LOG_WARN("MAX2871: Frequency out of range\n");
+        return false;
+    }
     
-    /* Wait for PLL to lock */
-    HAL_Delay(100);
-    pll_locked = true;
+    bool locked = MAX2871_Apply(&image);
     
-    printf("MAX2871: Frequency set to %lu Hz (N=%lu)\n", frequency_hz, n_divider);
+    LOG_DEBUG("MAX2871: Frequency set to %lu kHz (R0=0x%08lX)\n", Frequency_ToKHz(frequency), image.reg[0]);
+    return locked;
 }
 
 /**
  * @brief Get current frequency
  */
-uint32_t MAX2871_GetFrequency(void)
+Frequency_t MAX2871_GetFrequency(void)
 {
     return current_frequency;
 }
 
 /**
- * @brief Check if PLL is locked
+ * @brief Check if PLL is locked (hardware LD pin state)
  */
 bool MAX2871_IsPLLLocked(void)
 {
     return pll_locked;
 }
 
+/* ============================= */
+/* SCHEDULED COMMIT              */
+/* ============================= */
+
+/**
+ * @brief Stage an image to be written at a device time
+ * The register writes are computed against the shadow now; nothing else
+ * may write the chip until the commit fires or is cancelled.
+ * @return false if a commit is already armed
+ */
+bool MAX2871_Schedule(const MAX2871_Registers_t* image, uint32_t at_us)
+{
+    if (commit_armed)
+        return false;
+    
+    commit_image = *image;
+    commit_word_count = 0;
+    for (int reg = 5; reg >= 1; reg--)
+    {
+        if (!shadow_valid || image->reg[reg] != shadow.reg[reg])
+            commit_words[commit_word_count++] = image->reg[reg];
+    }
+    commit_words[commit_word_count++] = image->reg[0];
+    
+    /* Start early by the burst length so R0 latches at at_us */
+    uint32_t start_us = at_us - commit_word_count * MAX2871_COMMIT_WORD_US;
+    
+    commit_stats.frequency = image->frequency;
+    commit_stats.at_us = at_us;
+    if ((int32_t)(start_us - Timer_GetMicros()) <= 0)
+        commit_stats.late++;
+    
+    commit_armed = true;
+    commit_stats.pending = true;
+    Timer_SetAlarm(start_us, MAX2871_CommitISR);
+    return true;
+}
+
+/**
+ * @brief Cancel an armed commit
+ * @return true if it was cancelled before being written
+ */
+bool MAX2871_CancelSchedule(void)
+{
+    if (!Timer_CancelAlarm())
+        return false;
+    
+    commit_armed = false;
+    commit_stats.pending = false;
+    return true;
+}
+
+/**
+ * @brief Check whether a scheduled commit is still to be written
+ */
+bool MAX2871_IsCommitPending(void)
+{
+    return commit_armed;
+}
+
+/**
+ * @brief Get scheduled commit statistics
+ */
+MAX2871_CommitStats_t MAX2871_GetCommitStats(void)
+{
+    MAX2871_CommitStats_t stats;
+    
+    HAL_NVIC_DisableIRQ(TIM2_IRQn);
+    stats = *(const MAX2871_CommitStats_t*)&commit_stats;
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+    
+    return stats;
+}
+
+/**
+ * @brief Reset commit timing statistics
+ */
+void MAX2871_ClearCommitStats(void)
+{
+    HAL_NVIC_DisableIRQ(TIM2_IRQn);
+    commit_stats.commits = 0;
+    commit_stats.late = 0;
+    commit_stats.last_error_us = 0;
+    commit_stats.min_error_us = 0;
+    commit_stats.max_error_us = 0;
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+/**
+ * @brief Write the staged words (TIM2 alarm, priority 1 - no RTOS calls)
+ */
+static void MAX2871_CommitISR(void)
+{
+    MAX2871_BeginRetune(&commit_image);
+    
+    for (uint32_t i = 0; i < commit_word_count; i++)
+        MAX2871_WriteWord(commit_words[i]);
+    
+    int32_t error_us = (int32_t)(Timer_GetMicros() - commit_stats.at_us);
+    
+    shadow = commit_image;
+    shadow_valid = true;
+    current_frequency = commit_image.frequency;
+    
+    if (commit_stats.commits == 0 || error_us < commit_stats.min_error_us)
+        commit_stats.min_error_us = error_us;
+    if (commit_stats.commits == 0 || error_us > commit_stats.max_error_us)
+        commit_stats.max_error_us = error_us;
+    commit_stats.last_error_us = error_us;
+    commit_stats.commits++;
+    commit_stats.pending = false;
+    commit_armed = false;
+}
+
+/* ============================= */
+/* VCO BAND TABLE                */
+/* ============================= */
+
+/**
+ * @brief Use a learned band table on retune (NULL = chip autoselect)
+ * The table must stay valid while installed. Cached images solved under
+ * the previous plan are dropped by the next MAX2871_Solve; the switch waits
+ * for a solve in progress, so none mixes the two plans.
+ */
+void MAX2871_SetVcoTable(const uint8_t* bands)
+{
+    MAX2871_CacheLock();
+    vco_table = bands;
+    plan_generation++;
+    MAX2871_CacheUnlock();
+}
+
+/**
+ * @brief Check whether retunes program the VCO band directly
+ */
+bool MAX2871_IsVcoTableActive(void)
+{
+    return vco_table != NULL;
+}
+
+/**
+ * @brief Record the band autoselect picks across the VCO range
+ *
+ * Each grid point is tuned with autoselect on and the chosen band read
+ * back from R6. Points are tuned at the VCO frequency itself (DIVA = 1).
+ * The previous image is restored afterwards.
+ * @param bands MAX2871_VCO_TABLE_POINTS entries
+ * @return false if any point failed to lock or read back
+ */
+bool MAX2871_CalibrateVCO(uint8_t* bands)
+{
+    MAX2871_Registers_t restore = shadow;
+    bool restore_valid = shadow_valid;
+    const uint8_t* table = vco_table;
+    bool ok = true;
+    
+    vco_table = NULL;
+    
+    for (uint32_t point = 0; point < MAX2871_VCO_TABLE_POINTS; point++)
+    {
+        Frequency_t vco = MAX2871_VCO_MIN + (uint64_t)point * MAX2871_VCO_TABLE_STEP;
+        MAX2871_Registers_t image;
+        
+        if (!MAX2871_SolvePlan(vco, &image) ||
+            !MAX2871_ApplyImage(&image) ||
+            !MAX2871_ReadBand(&bands[point]))
+        {
+            bands[point] = (point > 0) ? bands[point - 1] : 0;
+            ok = false;
+        }
+    }
+    
+    vco_table = table;
+    if (restore_valid)
+        MAX2871_ApplyImage(&restore);
+    
+    return ok;
+}
+
+/**
+ * @brief Read the band in use back from R6 over MUXOUT
+ */
+static bool MAX2871_ReadBand(uint8_t* band)
+{
+    if (!shadow_valid)
+        return false;
+    
+    MAX2871_WriteWord(shadow.reg[5] | MAX2871_MUX_READBACK_R5);
+    MAX2871_WriteWord(shadow.reg[2] | MAX2871_MUX_READBACK_R2);
+    MAX2871_WriteWord(6);
+    uint32_t r6 = MAX2871_ReadRegister(6);
+    
+    /* MUXOUT back to three-state */
+    MAX2871_WriteWord(shadow.reg[2]);
+    MAX2871_WriteWord(shadow.reg[5]);
+    
+    *band = (uint8_t)((r6 & MAX2871_R6_VCO_Msk) >> MAX2871_R6_VCO_Pos);
+    return true;
+}
+
+/* ============================= */
+/* LOCK DETECT                   */
+/* ============================= */
+
+/**
+ * @brief Configure LD pin as EXTI on both edges
+ */
+static void MAX2871_InitLockDetect(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    
+    GPIO_InitStruct.Pin = MAX2871_LD_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(MAX2871_LD_PORT, &GPIO_InitStruct);
+    
+    pll_locked = (HAL_GPIO_ReadPin(MAX2871_LD_PORT, MAX2871_LD_PIN) == GPIO_PIN_SET);
+    lock_stats.locked = pll_locked;
+    
+    /* Callback may use FreeRTOS FromISR API - keep at syscall priority */
+    HAL_NVIC_SetPriority(MAX2871_LD_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(MAX2871_LD_IRQn);
+}
+
+/**
+ * @brief Get lock detect statistics
+ */
+MAX2871_LockStats_t MAX2871_GetLockStats(void)
+{
+    MAX2871_LockStats_t stats;
+    
+    HAL_NVIC_DisableIRQ(MAX2871_LD_IRQn);
+    stats = *(const MAX2871_LockStats_t*)&lock_stats;
+    HAL_NVIC_EnableIRQ(MAX2871_LD_IRQn);
+    
+    return stats;
+}
+
+/**
+ * @brief Register lock state change callback (runs in ISR context)
+ */
+void MAX2871_SetLockCallback(MAX2871_LockCallback_t callback)
+{
+    lock_callback = callback;
+}
+
+/**
+ * @brief Blank RF output in hardware while the PLL is unlocked
+ */
+void MAX2871_SetUnlockBlanking(bool enable)
+{
+    blank_on_unlock = enable;
+    GPIO_SetRFBlank(enable && !pll_locked);
+}
+
+/**
+ * @brief Get unlock blanking setting
+ */
+bool MAX2871_GetUnlockBlanking(void)
+{
+    return blank_on_unlock;
+}
+
+/**
+ * @brief Handle LD pin edge
+ */
+static void MAX2871_LockDetectISR(void)
+{
+    uint32_t now = Timer_GetMicros();
+    bool locked = (HAL_GPIO_ReadPin(MAX2871_LD_PORT, MAX2871_LD_PIN) == GPIO_PIN_SET);
+    
+    if (locked == lock_stats.locked)
+        return;
+    
+    if (locked)
+    {
+        if (retune_pending)
+        {
+            lock_stats.last_relock_us = now - retune_start_us;
+            relock_sum_us[retune_direct ? 1 : 0] += lock_stats.last_relock_us;
+            relock_count[retune_direct ? 1 : 0]++;
+            retune_pending = false;
+        }
+        else
+        {
+            uint32_t unlocked_us = now - lock_stats.last_unlock_us;
+            lock_stats.total_unlocked_us += unlocked_us;
+            if (unlocked_us > lock_stats.longest_unlocked_us)
+                lock_stats.longest_unlocked_us = unlocked_us;
+        }
+        lock_stats.last_lock_us = now;
+    }
+    else
+    {
+        if (!retune_pending)
+            lock_stats.unlock_events++;
+        lock_stats.last_unlock_us = now;
+    }
+    
+    lock_stats.locked = locked;
+    pll_locked = locked;
+    
+    if (blank_on_unlock)
+        GPIO_SetRFBlank(!locked);
+    
+    if (lock_callback != NULL)
+        lock_callback(locked);
+}
+
+/**
+ * @brief EXTI line 3 Interrupt Handler (MAX2871 LD)
+ * Handled directly - HAL_GPIO_EXTI_Callback is shared by all EXTI lines
+ */
+void EXTI3_IRQHandler(void)
+{
+    if (__HAL_GPIO_EXTI_GET_IT(MAX2871_LD_PIN) != 0)
+    {
+        __HAL_GPIO_EXTI_CLEAR_IT(MAX2871_LD_PIN);
+        MAX2871_LockDetectISR();
+    }
+}
+
 /* ============================= */
 /* POWER CONTROL                 */
 /* ============================= */
@@ -121,10 +1181,28 @@ void MAX2871_SetPowerMode(uint8_t mode)
     if (mode > 3)
         return;
     
-    uint32_t config = (mode & 0x03) << 24;
-    MAX2871_WriteRegister(4, config);
+    power_mode = mode;
     
-    printf("MAX2871: Power mode set to %u\n", mode);
+    /* Only APWR changes - the rest of R4 keeps the current divider */
+    if (shadow_valid)
+    {
+        MAX2871_Registers_t image = shadow;
+        image.reg[4] = (image.reg[4] & ~MAX2871_R4_APWR_Msk) |
+                       ((uint32_t)mode << MAX2871_R4_APWR_Pos);
+        MAX2871_WriteRegisters(&image);
+    }
+    
+    LOG_DEBUG("MAX2871: Power mode set to %u\n", mode);
+}
+
+/**
+ * @brief Set the power mode for the next image written, without writing
+ * (ISR callers that commit an image straight after)
+ */
+void MAX2871_SelectPowerMode(uint8_t mode)
+{
+    if (mode <= 3)
+        power_mode = mode;
 }
 
 /**
@@ -132,8 +1210,7 @@ void MAX2871_SetPowerMode(uint8_t mode)
  */
 uint8_t MAX2871_GetPowerMode(void)
 {
-    /* TODO: Read from register */
-    return 0;
+    return power_mode;
 }
 
 /* ============================= */
@@ -146,32 +1223,144 @@ uint8_t MAX2871_GetPowerMode(void)
 MAX2871_Status_t MAX2871_GetStatus(void)
 {
     MAX2871_Status_t status;
-    status.frequency_hz = current_frequency;
-    status.pll_locked = pll_locked;
-    status.power_mode = 0;
+    status.frequency = current_frequency;
+    status.pll_locked = MAX2871_IsPLLLocked();
+    status.power_mode = power_mode;
+    status.vco_direct = (vco_table != NULL);
+    status.vco_fallbacks = vco_fallbacks;
+    
+    HAL_NVIC_DisableIRQ(MAX2871_LD_IRQn);
+    status.relock_auto_us = relock_count[0] ? relock_sum_us[0] / relock_count[0] : 0;
+    status.relock_direct_us = relock_count[1] ? relock_sum_us[1] / relock_count[1] : 0;
+    status.relocks_auto = relock_count[0];
+    status.relocks_direct = relock_count[1];
+    HAL_NVIC_EnableIRQ(MAX2871_LD_IRQn);
+    
     return status;
 }
 
+/* ============================= */
+/* STREAMING                     */
+/* ============================= */
+
+/**
+ * @brief Lock on an image and hand SPI1 over for DMA writes of R0
+ * The band autoselect picked is frozen (VAS_SHDN), so later R0 writes
+ * retune without a band search. Register calls other than
+ * MAX2871_EndStream() are not allowed until the stream ends.
+ * @param image Typically from MAX2871_SolveTones()
+ * @return false if the PLL did not lock (SPI1 stays with the driver)
+ */
+bool MAX2871_BeginStream(const MAX2871_Registers_t* image)
+{
+    MAX2871_Registers_t frozen;
+    uint8_t band;
+    
+    if (!MAX2871_Apply(image))
+        return false;
+    
+    frozen = shadow;
+    if ((frozen.reg[3] & MAX2871_R3_VAS_SHDN) == 0)
+    {
+        if (!MAX2871_ReadBand(&band))
+            return false;
+        
+        frozen.reg[3] |= MAX2871_R3_VAS_SHDN | ((uint32_t)band << MAX2871_R3_VCO_Pos);
+        MAX2871_WriteRegisters(&frozen);
+    }
+    
+    HAL_SPI_DeInit(&hspi);
+    MAX2871_InitSPI(true);
+    stream_active = true;
+    return true;
+}
+
+/**
+ * @brief Take SPI1 back once the DMA has stopped
+ * @param frequency Tone the stream ended on
+ */
+void MAX2871_EndStream(Frequency_t frequency)
+{
+    uint32_t start = Timer_GetMicros();
+    
+    if (!stream_active)
+        return;
+    
+    /* Let the last frame finish before CS goes back to the GPIO */
+    while ((SPI1->SR & SPI_SR_TXC) == 0 &&
+           (Timer_GetMicros() - start) < MAX2871_COMMIT_WORD_US)
+    {
+    }
+    
+    HAL_SPI_DeInit(&hspi);
+    MAX2871_InitSPI(false);
+    stream_active = false;
+    
+    /* R0 and R3 differ from the shadow - the next image is written in full */
+    shadow_valid = false;
+    current_frequency = frequency;
+}
+
+/**
+ * @brief Data register the DMA writes R0 words to while streaming
+ */
+volatile uint32_t* MAX2871_GetStreamRegister(void)
+{
+    return &SPI1->TXDR;
+}
+
+/**
+ * @brief Wire time of one streamed word, CS pulse included
+ */
+uint32_t MAX2871_GetStreamWordNs(void)
+{
+    return (uint32_t)((MAX2871_STREAM_WORD_CYCLES * 1000000000ULL) / MAX2871_SCK_HZ);
+}
+
 /* ============================= */
 /* SPI COMMUNICATION             */
 /* ============================= */
 
+/**
+ * @brief Write a register image as one burst
+ * Unchanged registers are skipped; R0 always goes last because writing
+ * it starts the VCO band search and latches the double-buffered R4.
+ */
+void MAX2871_WriteRegisters(const MAX2871_Registers_t* image)
+{
+    for (int reg = 5; reg >= 1; reg--)
+    {
+        if (!shadow_valid || image->reg[reg] != shadow.reg[reg])
+            MAX2871_WriteWord(image->reg[reg]);
+    }
+    MAX2871_WriteWord(image->reg[0]);
+    
+    shadow = *image;
+    shadow_valid = true;
+}
+
 /**
  * @brief Write 32-bit register via SPI
  */
 void MAX2871_WriteRegister(uint8_t reg, uint32_t data)
 {
-    uint32_t spi_data = (data << 3) | (reg & 0x07);
-    
+    MAX2871_WriteWord((data << 3) | (reg & 0x07));
+}
+
+/**
+ * @brief Shift out one complete register word (address in bits [2:0])
+ */
+static void MAX2871_WriteWord(uint32_t word)
+{
     /* Pull CS low */
     HAL_GPIO_WritePin(GPIOA, GPIO_PIN_4, GPIO_PIN_RESET);
-    HAL_Delay(1);
+    Timer_DelayMicros(MAX2871_CS_DELAY_US);
     
-    /* Send 32-bit data */
-    HAL_SPI_Transmit(&hspi, (uint8_t*)&spi_data, 4, HAL_MAX_DELAY);
+    /* One 32-bit frame (Size counts frames, not bytes) */
+    HAL_SPI_Transmit(&hspi, (uint8_t*)&word, 1, HAL_MAX_DELAY);
     
     /* Pull CS high */
-    HAL_Delay(1);
+    Timer_DelayMicros(MAX2871_CS_DELAY_US);
     HAL_GPIO_WritePin(GPIOA, GPIO_PIN_4, GPIO_PIN_SET);
 }
 
@@ -184,13 +1373,13 @@ uint32_t MAX2871_ReadRegister(uint8_t reg)
     
     /* Pull CS low */
     HAL_GPIO_WritePin(GPIOA, GPIO_PIN_4, GPIO_PIN_RESET);
-    HAL_Delay(1);
+    Timer_DelayMicros(MAX2871_CS_DELAY_US);
     
-    /* Read 32-bit data */
-    HAL_SPI_Receive(&hspi, (uint8_t*)&spi_data, 4, HAL_MAX_DELAY);
+    /* One 32-bit frame (Size counts frames, not bytes) */
+    HAL_SPI_Receive(&hspi, (uint8_t*)&spi_data, 1, HAL_MAX_DELAY);
     
     /* Pull CS high */
-    HAL_Delay(1);
+    Timer_DelayMicros(MAX2871_CS_DELAY_US);
     HAL_GPIO_WritePin(GPIOA, GPIO_PIN_4, GPIO_PIN_SET);
     
     return spi_data;
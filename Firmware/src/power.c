@@ -0,0 +1,258 @@
+/**
+ * Low-Power Idle for STM32H743
+ * Tickless idle with LPTIM1 as the wake timer
+ */
+
+#include "power.h"
+#include "hal_timer.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+/* FreeRTOS Includes */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* LSI (32 kHz) / 32 -> ~1 kHz LPTIM count */
+#define POWER_LPTIM_PRESCALER (0x5UL << LPTIM_CFGR_PRESC_Pos)
+
+/* 16-bit LPTIM at 1 kHz */
+#define POWER_MAX_IDLE_TICKS 60000UL
+#define POWER_LPTIM_MAX_COUNTS 0xFFFFUL
+
+/* LPTIM count length: nominal, and the LSI datasheet range (29.5 - 34 kHz)
+ * a measurement must fall in */
+#define POWER_COUNT_NOMINAL_NS 1000000UL
+#define POWER_COUNT_MIN_NS 940000UL
+#define POWER_COUNT_MAX_NS 1085000UL
+
+/* Timed wakes shorter than this are too coarse to calibrate from */
+#define POWER_CAL_MIN_COUNTS 50
+
+/* Early-wake margin: LSI drift since the last calibration, as a fraction
+ * of the sleep (1/128 = 0.8%), plus one count of granularity */
+#define POWER_WAKE_MARGIN_SHIFT 7
+
+/* Idle current average: weight of each new sample */
+#define POWER_CURRENT_ALPHA 0.1f
+
+/* Measured LPTIM count length, from TIM2 across timed wakes */
+static uint32_t power_count_ns = POWER_COUNT_NOMINAL_NS;
+
+static volatile uint32_t power_sleeps = 0;
+static volatile uint64_t power_asleep_us = 0;
+static float idle_current = 0.0f;
+static bool idle_current_valid = false;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Start LSI and configure LPTIM1 as a one-shot wake timer
+ */
+void Power_Init(void)
+{
+    RCC->CSR |= RCC_CSR_LSION;
+    while (!(RCC->CSR & RCC_CSR_LSIRDY))
+    {
+    }
+    
+    __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSI);
+    __HAL_RCC_LPTIM1_CLK_ENABLE();
+    
+    /* CFGR and IER are only writable while disabled */
+    LPTIM1->CR = 0;
+    LPTIM1->CFGR = POWER_LPTIM_PRESCALER;
+    LPTIM1->IER = LPTIM_IER_ARRMIE;
+    
+    /* Wake only - no RTOS calls */
+    HAL_NVIC_SetPriority(LPTIM1_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+}
+
+/**
+ * @brief Arm LPTIM1 to fire after a number of ~1 ms counts
+ */
+static void Power_StartWakeTimer(uint32_t counts)
+{
+    LPTIM1->CR = LPTIM_CR_ENABLE;
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF | LPTIM_ICR_ARRMCF;
+    LPTIM1->ARR = counts;
+    while (!(LPTIM1->ISR & LPTIM_ISR_ARROK))
+    {
+    }
+    LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_SNGSTRT;
+}
+
+/* ============================= */
+/* TICKLESS IDLE                 */
+/* ============================= */
+
+/**
+ * @brief LPTIM counts to wake ahead of a sleep of sleep_us
+ * The margin grows with the sleep, so a long sleep on a drifting LSI
+ * still wakes before the RTOS timeout rather than after it.
+ */
+static uint32_t Power_WakeCounts(uint32_t sleep_us)
+{
+    uint64_t counts = ((uint64_t)sleep_us * 1000ULL) / power_count_ns;
+    uint64_t margin = (counts >> POWER_WAKE_MARGIN_SHIFT) + 1;
+    
+    if (counts <= margin + 1)
+        return 1;
+    
+    counts -= margin;
+    return (counts > POWER_LPTIM_MAX_COUNTS) ? POWER_LPTIM_MAX_COUNTS : (uint32_t)counts;
+}
+
+/**
+ * @brief Track the LSI rate from a wake the LPTIM timed
+ * Averaged over eight wakes, so one late wake (interrupt latency) does
+ * not swing the rate.
+ */
+static void Power_CalibrateCount(uint32_t counts, uint32_t measured_us)
+{
+    if (counts < POWER_CAL_MIN_COUNTS)
+        return;
+    
+    uint32_t count_ns = (uint32_t)(((uint64_t)measured_us * 1000ULL) / counts);
+    if (count_ns < POWER_COUNT_MIN_NS || count_ns > POWER_COUNT_MAX_NS)
+        return;
+    
+    power_count_ns = (uint32_t)((int32_t)power_count_ns + ((int32_t)count_ns - (int32_t)power_count_ns) / 8);
+}
+
+/**
+ * @brief Sleep until the next RTOS timeout or any interrupt
+ * Called by the idle task with the scheduler suspended.
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000UL;
+    
+    if (xExpectedIdleTime > POWER_MAX_IDLE_TICKS)
+        xExpectedIdleTime = POWER_MAX_IDLE_TICKS;
+    
+    __disable_irq();
+    __DSB();
+    __ISB();
+    
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        __enable_irq();
+        return;
+    }
+    
+    /* Stop the tick; time already spent in the current tick is kept */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    uint32_t elapsed_us = (SysTick->LOAD - SysTick->VAL) / cycles_per_us;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+        elapsed_us += 1000000UL / configTICK_RATE_HZ;
+    }
+    
+    uint32_t start = Timer_GetMicros();
+    
+    /* Wake early by the LSI error, scaled to the sleep */
+    uint32_t tick_us = 1000000UL / configTICK_RATE_HZ;
+    uint32_t sleep_us = xExpectedIdleTime * tick_us;
+    uint32_t counts = Power_WakeCounts((sleep_us > elapsed_us) ? sleep_us - elapsed_us : 0);
+    Power_StartWakeTimer(counts);
+    uint32_t armed = Timer_GetMicros();
+    
+    __DSB();
+    __WFI();
+    __ISB();
+    
+    uint32_t woken = Timer_GetMicros();
+    
+    /* Still pending with the IRQ masked: this wake was the LPTIM's */
+    if (LPTIM1->ISR & LPTIM_ISR_ARRM)
+        Power_CalibrateCount(counts, woken - armed);
+    
+    LPTIM1->CR = 0;
+    
+    uint32_t slept_us = woken - start;
+    elapsed_us += slept_us;
+    
+    TickType_t ticks = elapsed_us / tick_us;
+    uint32_t remainder_us = elapsed_us % tick_us;
+    if (ticks > xExpectedIdleTime)
+    {
+        ticks = xExpectedIdleTime;
+        remainder_us = 0;
+    }
+    
+    /* Restart the tick so the next one lands on the original grid */
+    SysTick->LOAD = cycles_per_tick - remainder_us * cycles_per_us - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = cycles_per_tick - 1;
+    
+    vTaskStepTick(ticks);
+    
+    power_sleeps++;
+    power_asleep_us += slept_us;
+    
+    __enable_irq();
+}
+
+/* ============================= */
+/* IDLE CURRENT                  */
+/* ============================= */
+
+/**
+ * @brief Feed a supply current sample (monitor task)
+ */
+void Power_SampleCurrent(double current_a, bool parked)
+{
+    if (!parked)
+        return;
+    
+    if (!idle_current_valid)
+    {
+        idle_current = (float)current_a;
+        idle_current_valid = true;
+    }
+    else
+    {
+        idle_current += POWER_CURRENT_ALPHA * ((float)current_a - idle_current);
+    }
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get sleep statistics and idle current
+ */
+Power_Status_t Power_GetStatus(void)
+{
+    Power_Status_t status;
+    
+    taskENTER_CRITICAL();
+    status.sleeps = power_sleeps;
+    status.asleep_us = power_asleep_us;
+    taskEXIT_CRITICAL();
+    
+    status.uptime_us = Timer_GetMicros64();
+    status.idle_current_a = idle_current;
+    status.idle_current_valid = idle_current_valid;
+    return status;
+}
+
+/* ============================= */
+/* LPTIM1 IRQ HANDLER            */
+/* ============================= */
+
+/**
+ * @brief LPTIM1 Interrupt Handler - wake only
+ */
+void LPTIM1_IRQHandler(void)
+{
+    if (LPTIM1->ISR & LPTIM_ISR_ARRM)
+        LPTIM1->ICR = LPTIM_ICR_ARRMCF;
+}
@@ -0,0 +1,270 @@
+/**
+ * Pulse Modulation for STM32H743
+ * TIM15_CH1N on the RF enable pin, PWM mode 2 with repetition counter
+ */
+
+#include "pulse.h"
+#include "hal_gpio.h"
+#include "hal_timer.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+#define PULSE_NS_PER_S      1000000000ULL
+#define PULSE_COUNTER_SPAN  65536UL
+
+/* Requested configuration */
+static uint32_t pulse_period_ns = 1000000;
+static uint32_t pulse_width_ns = 1000;
+static uint32_t pulse_count = 0;
+
+/* Programmed values, in timer ticks */
+static uint32_t pulse_prescaler = 0;
+static uint32_t pulse_period_ticks = 0;
+static uint32_t pulse_width_ticks = 0;
+
+static volatile bool pulse_enabled = false;
+static volatile bool pulse_sync = false;
+static volatile uint32_t pulse_bursts = 0;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Enable TIM15 with its output parked low; PA1 stays a GPIO
+ */
+void Pulse_Init(void)
+{
+    __HAL_RCC_TIM15_CLK_ENABLE();
+    
+    TIM15->CR1 = 0;
+    TIM15->DIER = 0;
+    
+    /* PWM mode 2 with preload: active from CCR1 to the end of the period */
+    TIM15->CCMR1 = TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1PE;
+    
+    /* CH1N alone outputs OC1REF; with MOE clear it idles low (OSSI) */
+    TIM15->CCER = TIM_CCER_CC1NE;
+    TIM15->BDTR = TIM_BDTR_OSSI;
+}
+
+/**
+ * @brief Convert the requested period and width to timer ticks
+ * The prescaler is the smallest that fits the period in 16 bits. Timing
+ * finer than the clock resolves is clamped: a two-tick period, at least
+ * one tick on and one off.
+ * @return false if the period or width had to be clamped
+ */
+static bool Pulse_Solve(uint32_t period_ns, uint32_t width_ns,
+                        uint32_t* prescaler, uint32_t* period, uint32_t* width)
+{
+    uint64_t clock_hz = Timer_GetApb2ClockHz();
+    uint64_t period_ticks = ((uint64_t)period_ns * clock_hz + PULSE_NS_PER_S / 2) / PULSE_NS_PER_S;
+    uint64_t width_ticks = ((uint64_t)width_ns * clock_hz + PULSE_NS_PER_S / 2) / PULSE_NS_PER_S;
+    bool exact = true;
+    
+    if (period_ticks < 2)
+    {
+        period_ticks = 2;
+        exact = false;
+    }
+    
+    /* PULSE_PERIOD_MAX_NS fits the prescaler at either profile's clock */
+    *prescaler = (uint32_t)((period_ticks - 1) / PULSE_COUNTER_SPAN);
+    
+    *period = (uint32_t)((period_ticks + *prescaler / 2) / (*prescaler + 1));
+    *width = (uint32_t)((width_ticks + *prescaler / 2) / (*prescaler + 1));
+    
+    /* At least one tick off at the start so the stopped counter is low */
+    if (*width < 1)
+    {
+        *width = 1;
+        exact = false;
+    }
+    else if (*width >= *period)
+    {
+        *width = *period - 1;
+        exact = false;
+    }
+    
+    return exact;
+}
+
+/**
+ * @brief Load the timing registers (buffered while running)
+ */
+static void Pulse_Program(void)
+{
+    TIM15->PSC = pulse_prescaler;
+    TIM15->ARR = pulse_period_ticks - 1;
+    TIM15->CCR1 = pulse_period_ticks - pulse_width_ticks;
+    TIM15->RCR = (pulse_count > 0) ? pulse_count - 1 : 0;
+    
+    /* A stopped counter loads them now; a running one at its next update */
+    if ((TIM15->CR1 & TIM_CR1_CEN) == 0)
+        TIM15->EGR = TIM_EGR_UG;
+}
+
+/**
+ * @brief Re-solve the timing after a bus clock change
+ * Timing the new clock cannot resolve is clamped rather than left in ticks
+ * of the old clock; PULSE:CONF? reads back what is programmed.
+ * @return false if the timing was clamped
+ */
+bool Pulse_Retime(void)
+{
+    bool exact = Pulse_Solve(pulse_period_ns, pulse_width_ns,
+                             &pulse_prescaler, &pulse_period_ticks, &pulse_width_ticks);
+    
+    Pulse_Program();
+    return exact;
+}
+
+/* ============================= */
+/* CONFIGURATION                 */
+/* ============================= */
+
+/**
+ * @brief Set period, width and burst length
+ * @param count Pulses per burst (1 - PULSE_COUNT_MAX), 0 = continuous
+ * @return false if out of range for the current timer clock
+ */
+bool Pulse_Configure(uint32_t period_ns, uint32_t width_ns, uint32_t count)
+{
+    uint32_t prescaler, period, width;
+    
+    if (period_ns > PULSE_PERIOD_MAX_NS || width_ns >= period_ns || count > PULSE_COUNT_MAX)
+        return false;
+    
+    if (!Pulse_Solve(period_ns, width_ns, &prescaler, &period, &width))
+        return false;
+    
+    /* The TIM5 list ISR may trigger a burst (Pulse_SyncPoint) */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    pulse_period_ns = period_ns;
+    pulse_width_ns = width_ns;
+    pulse_prescaler = prescaler;
+    pulse_period_ticks = period;
+    pulse_width_ticks = width;
+    
+    /* Switching between continuous and bursts needs the counter stopped */
+    if (pulse_enabled && (count == 0) != (pulse_count == 0))
+        TIM15->CR1 &= ~TIM_CR1_CEN;
+    
+    pulse_count = count;
+    if (pulse_enabled)
+    {
+        Pulse_Program();
+        TIM15->CR1 = TIM_CR1_URS | TIM_CR1_ARPE | (count > 0 ? TIM_CR1_OPM : TIM_CR1_CEN) |
+                     (TIM15->CR1 & TIM_CR1_CEN);
+    }
+    
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief Hand the RF enable pin to TIM15, or give it back to the GPIO gate
+ * Continuous pulsing starts at once; bursts wait for Pulse_Trigger().
+ */
+void Pulse_Enable(bool enable)
+{
+    if (enable == pulse_enabled)
+        return;
+    
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (enable)
+    {
+        Pulse_Retime();
+        TIM15->SR = 0;
+        pulse_bursts = 0;
+        pulse_enabled = true;
+        GPIO_SetRFPulsed(true);
+        
+        if (pulse_count == 0)
+            TIM15->CR1 = TIM_CR1_URS | TIM_CR1_ARPE | TIM_CR1_CEN;
+        else
+            TIM15->CR1 = TIM_CR1_URS | TIM_CR1_ARPE | TIM_CR1_OPM;
+    }
+    else
+    {
+        pulse_enabled = false;
+        GPIO_SetRFPulsed(false);
+        TIM15->CR1 = 0;
+        TIM15->CNT = 0;
+    }
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Fire a burst at each list mode point
+ */
+void Pulse_SetSync(bool sync)
+{
+    pulse_sync = sync;
+}
+
+/* ============================= */
+/* BURST START                   */
+/* ============================= */
+
+/**
+ * @brief Start a burst now (restarts one in progress)
+ * @return false unless enabled in burst mode
+ */
+bool Pulse_Trigger(void)
+{
+    if (!pulse_enabled || pulse_count == 0)
+        return false;
+    
+    /* UG reloads the repetition counter and restarts from the off time.
+     * Masked so a list point ISR cannot restart it in the middle */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    TIM15->CR1 &= ~TIM_CR1_CEN;
+    TIM15->EGR = TIM_EGR_UG;
+    TIM15->CR1 |= TIM_CR1_CEN;
+    pulse_bursts++;
+    
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief A list mode point has just been written (TIM5 ISR)
+ * The off time of the first period doubles as the PLL settling delay.
+ */
+void Pulse_SyncPoint(void)
+{
+    if (pulse_sync)
+        Pulse_Trigger();
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get pulse configuration as programmed
+ */
+Pulse_Status_t Pulse_GetStatus(void)
+{
+    Pulse_Status_t status;
+    uint64_t tick_ps = (1000ULL * PULSE_NS_PER_S) / Timer_GetApb2ClockHz();
+    uint64_t scaled_ps = tick_ps * (pulse_prescaler + 1);
+    
+    status.enabled = pulse_enabled;
+    status.sync = pulse_sync;
+    status.count = pulse_count;
+    status.period_ns = (uint32_t)((scaled_ps * pulse_period_ticks + 500) / 1000);
+    status.width_ns = (uint32_t)((scaled_ps * pulse_width_ticks + 500) / 1000);
+    status.resolution_ps = (uint32_t)scaled_ps;
+    status.bursts = pulse_bursts;
+    return status;
+}
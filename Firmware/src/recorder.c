@@ -0,0 +1,456 @@
+/**
+ * Telemetry Recorder for STM32H743
+ * TIM6 update interrupt samples into a ring of compressed blocks
+ */
+
+#include "recorder.h"
+#include "hal_adc.h"
+#include "hal_timer.h"
+#include "max2871.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+#include <string.h>
+
+/* TIM6 count rate */
+#define REC_TIMER_HZ 100000UL
+
+#define REC_PAYLOAD_BYTES (REC_BLOCK_BYTES - sizeof(Recorder_BlockHeader_t))
+
+/* A 12-bit delta zigzags to at most 14 bits: two varint bytes */
+#define REC_SAMPLE_MAX_BYTES (REC_CHANNEL_COUNT * 2)
+#define REC_ADC_DELTA_MAX_BYTES 2
+#define REC_LOCK_DELTA_MAX_BYTES 1
+
+typedef struct {
+    Recorder_BlockHeader_t header;
+    uint8_t payload[REC_PAYLOAD_BYTES];
+} Recorder_Block_t;
+
+static Recorder_Block_t rec_blocks[REC_BLOCK_COUNT];
+
+/* Ring position - oldest block and blocks in use (the newest is open) */
+static uint32_t rec_oldest = 0;
+static uint32_t rec_used = 0;
+static uint16_t rec_last[REC_CHANNEL_COUNT];
+
+/* Configuration */
+static uint8_t rec_channels = REC_CH_ALL;
+static uint32_t rec_period = REC_TIMER_HZ / 1000;
+static Recorder_Trigger_t rec_trigger = REC_TRIGGER_NONE;
+static uint32_t rec_pre = 0;
+static uint32_t rec_post = 0;
+
+/* Capture state - written from the TIM6 ISR */
+static volatile Recorder_State_t rec_state = REC_STATE_IDLE;
+static volatile bool rec_trigger_pending = false;
+static bool rec_triggered = false;
+static uint32_t rec_samples = 0;
+static uint32_t rec_trigger_sample = 0;
+static uint32_t rec_fault_trips = 0;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Enable TIM6 and its interrupt; sampling starts with Recorder_Start()
+ */
+void Recorder_Init(void)
+{
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    
+    TIM6->CR1 = 0;
+    TIM6->DIER = 0;
+    
+    /* Lowest priority in use, makes no RTOS calls */
+    HAL_NVIC_SetPriority(TIM6_DAC_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+}
+
+/**
+ * @brief Reload the TIM6 prescaler after a bus clock change
+ */
+void Recorder_Retime(void)
+{
+    TIM6->PSC = (Timer_GetClockHz() / REC_TIMER_HZ) - 1;
+    
+    if (TIM6->CR1 & TIM_CR1_CEN)
+        TIM6->EGR = TIM_EGR_UG;
+}
+
+/**
+ * @brief Program the sample period and start TIM6
+ */
+static void Recorder_StartTimer(void)
+{
+    TIM6->CR1 = TIM_CR1_URS;
+    TIM6->PSC = (Timer_GetClockHz() / REC_TIMER_HZ) - 1;
+    TIM6->ARR = rec_period - 1;
+    TIM6->EGR = TIM_EGR_UG;
+    TIM6->SR = 0;
+    TIM6->DIER = TIM_DIER_UIE;
+    TIM6->CR1 = TIM_CR1_URS | TIM_CR1_CEN;
+}
+
+/**
+ * @brief Stop sampling
+ */
+static void Recorder_StopTimer(void)
+{
+    TIM6->CR1 &= ~TIM_CR1_CEN;
+    TIM6->DIER = 0;
+    TIM6->SR = 0;
+}
+
+/* ============================= */
+/* CAPTURE CONTROL               */
+/* ============================= */
+
+/**
+ * @brief Check if the ISR is filling the ring
+ */
+static bool Recorder_IsRecording(void)
+{
+    return rec_state == REC_STATE_RUNNING || rec_state == REC_STATE_ARMED ||
+           rec_state == REC_STATE_TRIGGERED;
+}
+
+/**
+ * @brief Select channels and sample rate
+ * @return false while recording or if out of range
+ */
+bool Recorder_Configure(uint8_t channels, uint32_t rate_hz)
+{
+    if (Recorder_IsRecording())
+        return false;
+    
+    if (channels == 0 || (channels & ~REC_CH_ALL) != 0)
+        return false;
+    
+    if (rate_hz < REC_RATE_MIN_HZ || rate_hz > REC_RATE_MAX_HZ)
+        return false;
+    
+    rec_channels = channels;
+    rec_period = REC_TIMER_HZ / rate_hz;
+    return true;
+}
+
+/**
+ * @brief Samples a triggered capture may span at the configured channels
+ * Worst case: every delta takes its longest varint, each block closes as
+ * early as the sampler allows, and the oldest block is the one dropped
+ * next, so only the other blocks count.
+ */
+uint32_t Recorder_GetCapacity(void)
+{
+    uint32_t sample_bytes = 0;
+    
+    for (uint32_t ch = 0; ch < REC_CHANNEL_COUNT; ch++)
+    {
+        if (rec_channels & (1U << ch))
+            sample_bytes += ((1U << ch) == REC_CH_LOCK) ? REC_LOCK_DELTA_MAX_BYTES :
+                                                          REC_ADC_DELTA_MAX_BYTES;
+    }
+    
+    uint32_t block_samples = (REC_PAYLOAD_BYTES - REC_SAMPLE_MAX_BYTES) / sample_bytes + 1;
+    return (REC_BLOCK_COUNT - 1) * block_samples;
+}
+
+/**
+ * @brief Clear the ring and start recording
+ * @param trigger REC_TRIGGER_NONE records until Recorder_Stop()
+ * @param pre_samples Samples kept before the trigger; the trigger is
+ *        ignored until this many have been taken
+ * @param post_samples Samples taken after the trigger sample
+ * @return false for an unknown trigger, or if pre + post samples could
+ *         wrap the ring over the pre-trigger history (Recorder_GetCapacity)
+ */
+bool Recorder_Start(Recorder_Trigger_t trigger, uint32_t pre_samples, uint32_t post_samples)
+{
+    if (trigger > REC_TRIGGER_MANUAL)
+        return false;
+    
+    uint32_t capacity = Recorder_GetCapacity();
+    if (trigger != REC_TRIGGER_NONE &&
+        (pre_samples > capacity || post_samples > capacity - pre_samples))
+    {
+        return false;
+    }
+    
+    Recorder_Stop();
+    
+    rec_trigger = trigger;
+    rec_pre = pre_samples;
+    rec_post = post_samples;
+    
+    rec_oldest = 0;
+    rec_used = 1;
+    memset(&rec_blocks[0].header, 0, sizeof(rec_blocks[0].header));
+    memset(rec_last, 0, sizeof(rec_last));
+    
+    rec_samples = 0;
+    rec_trigger_sample = 0;
+    rec_triggered = false;
+    rec_trigger_pending = false;
+    rec_fault_trips = ADC_GetFaultStatus().trip_count;
+    rec_state = (trigger == REC_TRIGGER_NONE) ? REC_STATE_RUNNING : REC_STATE_ARMED;
+    
+    Recorder_StartTimer();
+    return true;
+}
+
+/**
+ * @brief Stop recording, keeping the captured data
+ */
+void Recorder_Stop(void)
+{
+    Recorder_StopTimer();
+    rec_state = REC_STATE_IDLE;
+}
+
+/**
+ * @brief Report a trigger event
+ * Accepted while armed if it matches the configured source; a manual
+ * trigger fires any armed capture.
+ */
+void Recorder_Trigger(Recorder_Trigger_t source)
+{
+    if (rec_state != REC_STATE_ARMED)
+        return;
+    
+    if (source == rec_trigger || source == REC_TRIGGER_MANUAL)
+        rec_trigger_pending = true;
+}
+
+/* ============================= */
+/* SAMPLING (TIM6 ISR)           */
+/* ============================= */
+
+/**
+ * @brief Get a block by position from the oldest
+ */
+static Recorder_Block_t* Recorder_BlockAt(uint32_t offset)
+{
+    return &rec_blocks[(rec_oldest + offset) % REC_BLOCK_COUNT];
+}
+
+/**
+ * @brief Close the newest block and open the next, dropping the oldest if full
+ */
+static Recorder_Block_t* Recorder_NextBlock(void)
+{
+    if (rec_used < REC_BLOCK_COUNT)
+        rec_used++;
+    else
+        rec_oldest = (rec_oldest + 1) % REC_BLOCK_COUNT;
+    
+    Recorder_Block_t* block = Recorder_BlockAt(rec_used - 1);
+    memset(&block->header, 0, sizeof(block->header));
+    memset(rec_last, 0, sizeof(rec_last));
+    return block;
+}
+
+/**
+ * @brief Arm-state trigger handling, before the sample is stored
+ */
+static void Recorder_CheckTrigger(void)
+{
+    if (rec_trigger == REC_TRIGGER_FAULT &&
+        ADC_GetFaultStatus().trip_count != rec_fault_trips)
+    {
+        rec_trigger_pending = true;
+    }
+    
+    if (!rec_trigger_pending)
+        return;
+    
+    /* Pre-trigger history not complete yet - drop the event */
+    if (rec_samples < rec_pre)
+    {
+        rec_trigger_pending = false;
+        rec_fault_trips = ADC_GetFaultStatus().trip_count;
+        return;
+    }
+    
+    rec_trigger_sample = rec_samples;
+    rec_triggered = true;
+    rec_state = REC_STATE_TRIGGERED;
+}
+
+/**
+ * @brief Take one sample and append it to the newest block
+ */
+static void Recorder_Sample(void)
+{
+    uint16_t values[REC_CHANNEL_COUNT];
+    
+    if (rec_state == REC_STATE_ARMED)
+        Recorder_CheckTrigger();
+    
+    values[0] = ADC_GetRaw(ADC_RAW_TEMPERATURE);
+    values[1] = ADC_GetRaw(ADC_RAW_VOLTAGE);
+    values[2] = ADC_GetRaw(ADC_RAW_CURRENT);
+    values[3] = MAX2871_IsPLLLocked() ? 1 : 0;
+    
+    Recorder_Block_t* block = Recorder_BlockAt(rec_used - 1);
+    if (block->header.length + REC_SAMPLE_MAX_BYTES > REC_PAYLOAD_BYTES)
+        block = Recorder_NextBlock();
+    
+    if (block->header.samples == 0)
+    {
+        block->header.first_sample = rec_samples;
+        block->header.timestamp_us = Timer_GetMicros();
+    }
+    
+    uint8_t* out = &block->payload[block->header.length];
+    for (uint32_t ch = 0; ch < REC_CHANNEL_COUNT; ch++)
+    {
+        if ((rec_channels & (1U << ch)) == 0)
+            continue;
+        
+        /* Zigzag keeps small negative deltas small */
+        int32_t delta = (int32_t)values[ch] - (int32_t)rec_last[ch];
+        uint32_t code = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+        rec_last[ch] = values[ch];
+        
+        while (code >= 0x80)
+        {
+            *out++ = (uint8_t)(code | 0x80);
+            code >>= 7;
+        }
+        *out++ = (uint8_t)code;
+    }
+    
+    block->header.length = (uint16_t)(out - block->payload);
+    block->header.samples++;
+    rec_samples++;
+    
+    if (rec_state == REC_STATE_TRIGGERED && rec_samples > rec_trigger_sample + rec_post)
+    {
+        Recorder_StopTimer();
+        rec_state = REC_STATE_DONE;
+    }
+}
+
+/* ============================= */
+/* DOWNLOAD                      */
+/* ============================= */
+
+/**
+ * @brief First block of the download window
+ * Triggered captures start at the block holding trigger - pre samples;
+ * everything older is history the host did not ask for.
+ */
+static uint32_t Recorder_WindowStart(void)
+{
+    uint32_t offset = 0;
+    
+    if (!rec_triggered)
+        return 0;
+    
+    uint32_t first = (rec_trigger_sample > rec_pre) ? rec_trigger_sample - rec_pre : 0;
+    
+    while (offset + 1 < rec_used && Recorder_BlockAt(offset + 1)->header.first_sample <= first)
+        offset++;
+    
+    return offset;
+}
+
+/**
+ * @brief Get a block of the download window
+ * @return Header, immediately followed by header->length payload bytes;
+ *         NULL past the end or while recording
+ */
+const Recorder_BlockHeader_t* Recorder_GetBlock(uint32_t index)
+{
+    if (Recorder_IsRecording())
+        return NULL;
+    
+    uint32_t offset = Recorder_WindowStart() + index;
+    if (offset >= rec_used)
+        return NULL;
+    
+    Recorder_Block_t* block = Recorder_BlockAt(offset);
+    if (block->header.samples == 0)
+        return NULL;
+    
+    return &block->header;
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get recorder configuration and capture state
+ */
+Recorder_Status_t Recorder_GetStatus(void)
+{
+    Recorder_Status_t status;
+    
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    status.state = rec_state;
+    status.trigger = rec_trigger;
+    status.channels = rec_channels;
+    status.rate_hz = REC_TIMER_HZ / rec_period;
+    status.pre_samples = rec_pre;
+    status.post_samples = rec_post;
+    status.samples = rec_samples;
+    status.trigger_sample = rec_trigger_sample;
+    status.blocks = 0;
+    status.bytes = 0;
+    
+    uint32_t start = Recorder_WindowStart();
+    status.first_sample = Recorder_BlockAt(start)->header.first_sample;
+    for (uint32_t offset = start; offset < rec_used; offset++)
+    {
+        Recorder_Block_t* block = Recorder_BlockAt(offset);
+        if (block->header.samples == 0)
+            continue;
+        
+        status.blocks++;
+        status.bytes += sizeof(block->header) + block->header.length;
+    }
+    
+    __set_PRIMASK(primask);
+    
+    return status;
+}
+
+/**
+ * @brief Get state name for status reports
+ */
+const char* Recorder_GetStateName(Recorder_State_t state)
+{
+    static const char* const names[] = { "IDLE", "RUNNING", "ARMED", "TRIGGERED", "DONE" };
+    
+    return (state <= REC_STATE_DONE) ? names[state] : "UNKNOWN";
+}
+
+/**
+ * @brief Get trigger source name for status reports
+ */
+const char* Recorder_GetTriggerName(Recorder_Trigger_t trigger)
+{
+    static const char* const names[] = { "NONE", "LOCK", "FAULT", "MANUAL" };
+    
+    return (trigger <= REC_TRIGGER_MANUAL) ? names[trigger] : "UNKNOWN";
+}
+
+/* ============================= */
+/* TIM6 IRQ HANDLER              */
+/* ============================= */
+
+/**
+ * @brief TIM6 Interrupt Handler (shared vector with the unused DAC)
+ */
+void TIM6_DAC_IRQHandler(void)
+{
+    if (TIM6->SR & TIM_SR_UIF)
+    {
+        TIM6->SR = ~TIM_SR_UIF;
+        Recorder_Sample();
+    }
+}
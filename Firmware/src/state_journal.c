@@ -0,0 +1,235 @@
+/**
+ * RF State Journal
+ * 12 slots x 20 bytes at FRAM_ADDR_JOURNAL
+ */
+
+#include "state_journal.h"
+#include "crc.h"
+#include "fram.h"
+#include "hal_timer.h"
+#include "main.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+#define JOURNAL_SLOTS 12
+#define JOURNAL_MAGIC 0x5B         /* 0x5A: 32-bit Hz records, not restored */
+#define JOURNAL_READ_TIMEOUT_MS 50
+
+/* Frequency split in two words so the record stays 4-byte aligned and
+ * has no padding for the CRC to cover */
+typedef struct {
+    uint32_t sequence;
+    uint32_t frequency_lo;
+    uint32_t frequency_hi;
+    int8_t power_dbm;
+    uint8_t rf_enabled;
+    uint16_t program_id;
+    uint8_t magic;
+    uint8_t reserved;
+    uint16_t crc;
+} JournalRecord_t;
+
+/* DMA targets */
+static JournalRecord_t journal_slots[JOURNAL_SLOTS] DMA_BUFFER;
+static JournalRecord_t journal_out DMA_BUFFER;
+
+/* Pending state from Update(), written by Flush() */
+static StateJournal_State_t journal_pending;
+static StateJournal_State_t journal_written;
+static volatile bool journal_dirty = false;
+
+static uint32_t journal_sequence = 0;
+static uint32_t journal_next_slot = 0;
+static StateJournal_Status_t journal_status;
+static uint32_t journal_restore_start = 0;
+
+/* ============================= */
+/* RECORD ENCODING               */
+/* ============================= */
+
+/**
+ * @brief CRC-16/CCITT over a record (excluding the CRC field)
+ */
+static uint16_t Journal_CRC(const JournalRecord_t* record)
+{
+    return CRC16_Compute(record, sizeof(JournalRecord_t) - sizeof(record->crc));
+}
+
+/**
+ * @brief Check record integrity
+ */
+static bool Journal_IsValid(const JournalRecord_t* record)
+{
+    return record->magic == JOURNAL_MAGIC && record->crc == Journal_CRC(record);
+}
+
+/* ============================= */
+/* INITIALIZATION / RESTORE      */
+/* ============================= */
+
+/**
+ * @brief Initialize journal state
+ */
+void StateJournal_Init(void)
+{
+    journal_sequence = 0;
+    journal_next_slot = 0;
+    journal_dirty = false;
+    journal_status.restored = false;
+    journal_status.sequence = 0;
+    journal_status.restore_us = 0;
+    journal_status.writes = 0;
+}
+
+/**
+ * @brief Start reading the journal by DMA (returns immediately)
+ */
+bool StateJournal_RestoreStart(void)
+{
+    journal_restore_start = Timer_GetMicros();
+    return FRAM_ReadAsync(FRAM_ADDR_JOURNAL, journal_slots, sizeof(journal_slots));
+}
+
+/**
+ * @brief Wait for the journal read and return the newest valid state
+ * @return false if the read failed or the journal holds no valid record
+ */
+bool StateJournal_RestoreFinish(StateJournal_State_t* state)
+{
+    int32_t newest = -1;
+    
+    if (!FRAM_Wait(JOURNAL_READ_TIMEOUT_MS))
+    {
+        journal_status.restore_us = Timer_GetMicros() - journal_restore_start;
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < JOURNAL_SLOTS; i++)
+    {
+        if (!Journal_IsValid(&journal_slots[i]))
+            continue;
+        
+        if (newest < 0 ||
+            (int32_t)(journal_slots[i].sequence - journal_slots[newest].sequence) > 0)
+            newest = (int32_t)i;
+    }
+    
+    journal_status.restore_us = Timer_GetMicros() - journal_restore_start;
+    
+    if (newest < 0)
+        return false;
+    
+    const JournalRecord_t* record = &journal_slots[newest];
+    
+    state->frequency = ((Frequency_t)record->frequency_hi << 32) | record->frequency_lo;
+    state->power_dbm = record->power_dbm;
+    state->rf_enabled = record->rf_enabled != 0;
+    state->program_id = record->program_id;
+    
+    journal_sequence = record->sequence;
+    journal_next_slot = ((uint32_t)newest + 1) % JOURNAL_SLOTS;
+    journal_written = *state;
+    
+    journal_status.restored = true;
+    journal_status.sequence = journal_sequence;
+    return true;
+}
+
+/**
+ * @brief Find the newest valid record and return its state (blocking)
+ * @return false if the journal holds no valid record
+ */
+bool StateJournal_Restore(StateJournal_State_t* state)
+{
+    return StateJournal_RestoreStart() && StateJournal_RestoreFinish(state);
+}
+
+/* ============================= */
+/* UPDATES                       */
+/* ============================= */
+
+/**
+ * @brief Record a state change (no FRAM access)
+ */
+void StateJournal_Update(const StateJournal_State_t* state)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    journal_pending = *state;
+    journal_dirty = true;
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Append the latest pending state, if it differs from FRAM
+ * A failed write leaves the state pending for the next flush.
+ * @return false on FRAM error
+ */
+bool StateJournal_Flush(void)
+{
+    StateJournal_State_t state;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (!journal_dirty)
+    {
+        __set_PRIMASK(primask);
+        return true;
+    }
+    
+    journal_dirty = false;
+    state = journal_pending;
+    
+    __set_PRIMASK(primask);
+    
+    if (journal_status.writes > 0 || journal_status.restored)
+    {
+        if (state.frequency == journal_written.frequency &&
+            state.power_dbm == journal_written.power_dbm &&
+            state.rf_enabled == journal_written.rf_enabled &&
+            state.program_id == journal_written.program_id)
+            return true;
+    }
+    
+    journal_out.sequence = journal_sequence + 1;
+    journal_out.frequency_lo = (uint32_t)state.frequency;
+    journal_out.frequency_hi = (uint32_t)(state.frequency >> 32);
+    journal_out.power_dbm = state.power_dbm;
+    journal_out.rf_enabled = state.rf_enabled ? 1 : 0;
+    journal_out.program_id = state.program_id;
+    journal_out.magic = JOURNAL_MAGIC;
+    journal_out.reserved = 0;
+    journal_out.crc = Journal_CRC(&journal_out);
+    
+    uint16_t addr = (uint16_t)(FRAM_ADDR_JOURNAL + journal_next_slot * sizeof(JournalRecord_t));
+    if (!FRAM_Write(addr, &journal_out, sizeof(journal_out)))
+    {
+        /* A newer Update() meanwhile has set it already and is kept */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        journal_dirty = true;
+        __set_PRIMASK(primask);
+        return false;
+    }
+    
+    journal_sequence++;
+    journal_next_slot = (journal_next_slot + 1) % JOURNAL_SLOTS;
+    journal_written = state;
+    journal_status.sequence = journal_sequence;
+    journal_status.writes++;
+    return true;
+}
+
+/* ============================= */
+/* STATUS                        */
+/* ============================= */
+
+/**
+ * @brief Get journal status
+ */
+StateJournal_Status_t StateJournal_GetStatus(void)
+{
+    return journal_status;
+}
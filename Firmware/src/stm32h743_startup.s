@@ -45,10 +45,157 @@ g_pfnVectors:
   .word PendSV_Handler          /* 0x0038  PendSV Handler */
   .word SysTick_Handler         /* 0x003C  SysTick Handler */
   
-  /* External interrupts (IRQ0-135) */
-  .rept 136
-  .word Default_Handler
-  .endr
+  /* External interrupts (IRQ0-149) */
+  .word WWDG_IRQHandler         /* 0x0040  IRQ0 */
+  .word PVD_AVD_IRQHandler      /* 0x0044  IRQ1 */
+  .word TAMP_STAMP_IRQHandler   /* 0x0048  IRQ2 */
+  .word RTC_WKUP_IRQHandler     /* 0x004C  IRQ3 */
+  .word FLASH_IRQHandler        /* 0x0050  IRQ4 */
+  .word RCC_IRQHandler          /* 0x0054  IRQ5 */
+  .word EXTI0_IRQHandler        /* 0x0058  IRQ6 */
+  .word EXTI1_IRQHandler        /* 0x005C  IRQ7 */
+  .word EXTI2_IRQHandler        /* 0x0060  IRQ8 */
+  .word EXTI3_IRQHandler        /* 0x0064  IRQ9 */
+  .word EXTI4_IRQHandler        /* 0x0068  IRQ10 */
+  .word DMA1_Stream0_IRQHandler /* 0x006C  IRQ11 */
+  .word DMA1_Stream1_IRQHandler /* 0x0070  IRQ12 */
+  .word DMA1_Stream2_IRQHandler /* 0x0074  IRQ13 */
+  .word DMA1_Stream3_IRQHandler /* 0x0078  IRQ14 */
+  .word DMA1_Stream4_IRQHandler /* 0x007C  IRQ15 */
+  .word DMA1_Stream5_IRQHandler /* 0x0080  IRQ16 */
+  .word DMA1_Stream6_IRQHandler /* 0x0084  IRQ17 */
+  .word ADC_IRQHandler          /* 0x0088  IRQ18 */
+  .word FDCAN1_IT0_IRQHandler   /* 0x008C  IRQ19 */
+  .word FDCAN2_IT0_IRQHandler   /* 0x0090  IRQ20 */
+  .word FDCAN1_IT1_IRQHandler   /* 0x0094  IRQ21 */
+  .word FDCAN2_IT1_IRQHandler   /* 0x0098  IRQ22 */
+  .word EXTI9_5_IRQHandler      /* 0x009C  IRQ23 */
+  .word TIM1_BRK_IRQHandler     /* 0x00A0  IRQ24 */
+  .word TIM1_UP_IRQHandler      /* 0x00A4  IRQ25 */
+  .word TIM1_TRG_COM_IRQHandler /* 0x00A8  IRQ26 */
+  .word TIM1_CC_IRQHandler      /* 0x00AC  IRQ27 */
+  .word TIM2_IRQHandler         /* 0x00B0  IRQ28 */
+  .word TIM3_IRQHandler         /* 0x00B4  IRQ29 */
+  .word TIM4_IRQHandler         /* 0x00B8  IRQ30 */
+  .word I2C1_EV_IRQHandler      /* 0x00BC  IRQ31 */
+  .word I2C1_ER_IRQHandler      /* 0x00C0  IRQ32 */
+  .word I2C2_EV_IRQHandler      /* 0x00C4  IRQ33 */
+  .word I2C2_ER_IRQHandler      /* 0x00C8  IRQ34 */
+  .word SPI1_IRQHandler         /* 0x00CC  IRQ35 */
+  .word SPI2_IRQHandler         /* 0x00D0  IRQ36 */
+  .word USART1_IRQHandler       /* 0x00D4  IRQ37 */
+  .word USART2_IRQHandler       /* 0x00D8  IRQ38 */
+  .word USART3_IRQHandler       /* 0x00DC  IRQ39 */
+  .word EXTI15_10_IRQHandler    /* 0x00E0  IRQ40 */
+  .word RTC_Alarm_IRQHandler    /* 0x00E4  IRQ41 */
+  .word 0                       /* 0x00E8  Reserved */
+  .word TIM8_BRK_TIM12_IRQHandler /* 0x00EC  IRQ43 */
+  .word TIM8_UP_TIM13_IRQHandler /* 0x00F0  IRQ44 */
+  .word TIM8_TRG_COM_TIM14_IRQHandler /* 0x00F4  IRQ45 */
+  .word TIM8_CC_IRQHandler      /* 0x00F8  IRQ46 */
+  .word DMA1_Stream7_IRQHandler /* 0x00FC  IRQ47 */
+  .word FMC_IRQHandler          /* 0x0100  IRQ48 */
+  .word SDMMC1_IRQHandler       /* 0x0104  IRQ49 */
+  .word TIM5_IRQHandler         /* 0x0108  IRQ50 */
+  .word SPI3_IRQHandler         /* 0x010C  IRQ51 */
+  .word UART4_IRQHandler        /* 0x0110  IRQ52 */
+  .word UART5_IRQHandler        /* 0x0114  IRQ53 */
+  .word TIM6_DAC_IRQHandler     /* 0x0118  IRQ54 */
+  .word TIM7_IRQHandler         /* 0x011C  IRQ55 */
+  .word DMA2_Stream0_IRQHandler /* 0x0120  IRQ56 */
+  .word DMA2_Stream1_IRQHandler /* 0x0124  IRQ57 */
+  .word DMA2_Stream2_IRQHandler /* 0x0128  IRQ58 */
+  .word DMA2_Stream3_IRQHandler /* 0x012C  IRQ59 */
+  .word DMA2_Stream4_IRQHandler /* 0x0130  IRQ60 */
+  .word ETH_IRQHandler          /* 0x0134  IRQ61 */
+  .word ETH_WKUP_IRQHandler     /* 0x0138  IRQ62 */
+  .word FDCAN_CAL_IRQHandler    /* 0x013C  IRQ63 */
+  .word 0                       /* 0x0140  Reserved */
+  .word 0                       /* 0x0144  Reserved */
+  .word 0                       /* 0x0148  Reserved */
+  .word 0                       /* 0x014C  Reserved */
+  .word DMA2_Stream5_IRQHandler /* 0x0150  IRQ68 */
+  .word DMA2_Stream6_IRQHandler /* 0x0154  IRQ69 */
+  .word DMA2_Stream7_IRQHandler /* 0x0158  IRQ70 */
+  .word USART6_IRQHandler       /* 0x015C  IRQ71 */
+  .word I2C3_EV_IRQHandler      /* 0x0160  IRQ72 */
+  .word I2C3_ER_IRQHandler      /* 0x0164  IRQ73 */
+  .word OTG_HS_EP1_OUT_IRQHandler /* 0x0168  IRQ74 */
+  .word OTG_HS_EP1_IN_IRQHandler /* 0x016C  IRQ75 */
+  .word OTG_HS_WKUP_IRQHandler  /* 0x0170  IRQ76 */
+  .word OTG_HS_IRQHandler       /* 0x0174  IRQ77 */
+  .word DCMI_IRQHandler         /* 0x0178  IRQ78 */
+  .word 0                       /* 0x017C  Reserved */
+  .word RNG_IRQHandler          /* 0x0180  IRQ80 */
+  .word FPU_IRQHandler          /* 0x0184  IRQ81 */
+  .word UART7_IRQHandler        /* 0x0188  IRQ82 */
+  .word UART8_IRQHandler        /* 0x018C  IRQ83 */
+  .word SPI4_IRQHandler         /* 0x0190  IRQ84 */
+  .word SPI5_IRQHandler         /* 0x0194  IRQ85 */
+  .word SPI6_IRQHandler         /* 0x0198  IRQ86 */
+  .word SAI1_IRQHandler         /* 0x019C  IRQ87 */
+  .word LTDC_IRQHandler         /* 0x01A0  IRQ88 */
+  .word LTDC_ER_IRQHandler      /* 0x01A4  IRQ89 */
+  .word DMA2D_IRQHandler        /* 0x01A8  IRQ90 */
+  .word SAI2_IRQHandler         /* 0x01AC  IRQ91 */
+  .word QUADSPI_IRQHandler      /* 0x01B0  IRQ92 */
+  .word LPTIM1_IRQHandler       /* 0x01B4  IRQ93 */
+  .word CEC_IRQHandler          /* 0x01B8  IRQ94 */
+  .word I2C4_EV_IRQHandler      /* 0x01BC  IRQ95 */
+  .word I2C4_ER_IRQHandler      /* 0x01C0  IRQ96 */
+  .word SPDIF_RX_IRQHandler     /* 0x01C4  IRQ97 */
+  .word OTG_FS_EP1_OUT_IRQHandler /* 0x01C8  IRQ98 */
+  .word OTG_FS_EP1_IN_IRQHandler /* 0x01CC  IRQ99 */
+  .word OTG_FS_WKUP_IRQHandler  /* 0x01D0  IRQ100 */
+  .word OTG_FS_IRQHandler       /* 0x01D4  IRQ101 */
+  .word DMAMUX1_OVR_IRQHandler  /* 0x01D8  IRQ102 */
+  .word HRTIM1_Master_IRQHandler /* 0x01DC  IRQ103 */
+  .word HRTIM1_TIMA_IRQHandler  /* 0x01E0  IRQ104 */
+  .word HRTIM1_TIMB_IRQHandler  /* 0x01E4  IRQ105 */
+  .word HRTIM1_TIMC_IRQHandler  /* 0x01E8  IRQ106 */
+  .word HRTIM1_TIMD_IRQHandler  /* 0x01EC  IRQ107 */
+  .word HRTIM1_TIME_IRQHandler  /* 0x01F0  IRQ108 */
+  .word HRTIM1_FLT_IRQHandler   /* 0x01F4  IRQ109 */
+  .word DFSDM1_FLT0_IRQHandler  /* 0x01F8  IRQ110 */
+  .word DFSDM1_FLT1_IRQHandler  /* 0x01FC  IRQ111 */
+  .word DFSDM1_FLT2_IRQHandler  /* 0x0200  IRQ112 */
+  .word DFSDM1_FLT3_IRQHandler  /* 0x0204  IRQ113 */
+  .word SAI3_IRQHandler         /* 0x0208  IRQ114 */
+  .word SWPMI1_IRQHandler       /* 0x020C  IRQ115 */
+  .word TIM15_IRQHandler        /* 0x0210  IRQ116 */
+  .word TIM16_IRQHandler        /* 0x0214  IRQ117 */
+  .word TIM17_IRQHandler        /* 0x0218  IRQ118 */
+  .word MDIOS_WKUP_IRQHandler   /* 0x021C  IRQ119 */
+  .word MDIOS_IRQHandler        /* 0x0220  IRQ120 */
+  .word JPEG_IRQHandler         /* 0x0224  IRQ121 */
+  .word MDMA_IRQHandler         /* 0x0228  IRQ122 */
+  .word 0                       /* 0x022C  Reserved */
+  .word SDMMC2_IRQHandler       /* 0x0230  IRQ124 */
+  .word HSEM1_IRQHandler        /* 0x0234  IRQ125 */
+  .word 0                       /* 0x0238  Reserved */
+  .word ADC3_IRQHandler         /* 0x023C  IRQ127 */
+  .word DMAMUX2_OVR_IRQHandler  /* 0x0240  IRQ128 */
+  .word BDMA_Channel0_IRQHandler /* 0x0244  IRQ129 */
+  .word BDMA_Channel1_IRQHandler /* 0x0248  IRQ130 */
+  .word BDMA_Channel2_IRQHandler /* 0x024C  IRQ131 */
+  .word BDMA_Channel3_IRQHandler /* 0x0250  IRQ132 */
+  .word BDMA_Channel4_IRQHandler /* 0x0254  IRQ133 */
+  .word BDMA_Channel5_IRQHandler /* 0x0258  IRQ134 */
+  .word BDMA_Channel6_IRQHandler /* 0x025C  IRQ135 */
+  .word BDMA_Channel7_IRQHandler /* 0x0260  IRQ136 */
+  .word COMP1_IRQHandler        /* 0x0264  IRQ137 */
+  .word LPTIM2_IRQHandler       /* 0x0268  IRQ138 */
+  .word LPTIM3_IRQHandler       /* 0x026C  IRQ139 */
+  .word LPTIM4_IRQHandler       /* 0x0270  IRQ140 */
+  .word LPTIM5_IRQHandler       /* 0x0274  IRQ141 */
+  .word LPUART1_IRQHandler      /* 0x0278  IRQ142 */
+  .word 0                       /* 0x027C  Reserved */
+  .word CRS_IRQHandler          /* 0x0280  IRQ144 */
+  .word ECC_IRQHandler          /* 0x0284  IRQ145 */
+  .word SAI4_IRQHandler         /* 0x0288  IRQ146 */
+  .word 0                       /* 0x028C  Reserved */
+  .word 0                       /* 0x0290  Reserved */
+  .word WAKEUP_PIN_IRQHandler   /* 0x0294  IRQ149 */
 
 /* Reset handler */
 .section .text.Reset_Handler, "ax"
@@ -90,6 +237,9 @@ bss_zero_loop:
   blt bss_zero_loop
 
 bss_zero_done:
+  /* MPU layout and I/D caches */
+  bl Cache_Init
+  
   /* Call main */
   bl main
   
@@ -128,4 +278,423 @@ PendSV_Handler:
 SysTick_Handler:
   b .
 
+/* Peripheral interrupt handlers - weakly aliased to Default_Handler so a
+ * driver only has to define the <PERIPH>_IRQHandler it actually uses */
+  .weak WWDG_IRQHandler
+  .thumb_set WWDG_IRQHandler, Default_Handler
+
+  .weak PVD_AVD_IRQHandler
+  .thumb_set PVD_AVD_IRQHandler, Default_Handler
+
+  .weak TAMP_STAMP_IRQHandler
+  .thumb_set TAMP_STAMP_IRQHandler, Default_Handler
+
+  .weak RTC_WKUP_IRQHandler
+  .thumb_set RTC_WKUP_IRQHandler, Default_Handler
+
+  .weak FLASH_IRQHandler
+  .thumb_set FLASH_IRQHandler, Default_Handler
+
+  .weak RCC_IRQHandler
+  .thumb_set RCC_IRQHandler, Default_Handler
+
+  .weak EXTI0_IRQHandler
+  .thumb_set EXTI0_IRQHandler, Default_Handler
+
+  .weak EXTI1_IRQHandler
+  .thumb_set EXTI1_IRQHandler, Default_Handler
+
+  .weak EXTI2_IRQHandler
+  .thumb_set EXTI2_IRQHandler, Default_Handler
+
+  .weak EXTI3_IRQHandler
+  .thumb_set EXTI3_IRQHandler, Default_Handler
+
+  .weak EXTI4_IRQHandler
+  .thumb_set EXTI4_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream0_IRQHandler
+  .thumb_set DMA1_Stream0_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream1_IRQHandler
+  .thumb_set DMA1_Stream1_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream2_IRQHandler
+  .thumb_set DMA1_Stream2_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream3_IRQHandler
+  .thumb_set DMA1_Stream3_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream4_IRQHandler
+  .thumb_set DMA1_Stream4_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream5_IRQHandler
+  .thumb_set DMA1_Stream5_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream6_IRQHandler
+  .thumb_set DMA1_Stream6_IRQHandler, Default_Handler
+
+  .weak ADC_IRQHandler
+  .thumb_set ADC_IRQHandler, Default_Handler
+
+  .weak FDCAN1_IT0_IRQHandler
+  .thumb_set FDCAN1_IT0_IRQHandler, Default_Handler
+
+  .weak FDCAN2_IT0_IRQHandler
+  .thumb_set FDCAN2_IT0_IRQHandler, Default_Handler
+
+  .weak FDCAN1_IT1_IRQHandler
+  .thumb_set FDCAN1_IT1_IRQHandler, Default_Handler
+
+  .weak FDCAN2_IT1_IRQHandler
+  .thumb_set FDCAN2_IT1_IRQHandler, Default_Handler
+
+  .weak EXTI9_5_IRQHandler
+  .thumb_set EXTI9_5_IRQHandler, Default_Handler
+
+  .weak TIM1_BRK_IRQHandler
+  .thumb_set TIM1_BRK_IRQHandler, Default_Handler
+
+  .weak TIM1_UP_IRQHandler
+  .thumb_set TIM1_UP_IRQHandler, Default_Handler
+
+  .weak TIM1_TRG_COM_IRQHandler
+  .thumb_set TIM1_TRG_COM_IRQHandler, Default_Handler
+
+  .weak TIM1_CC_IRQHandler
+  .thumb_set TIM1_CC_IRQHandler, Default_Handler
+
+  .weak TIM2_IRQHandler
+  .thumb_set TIM2_IRQHandler, Default_Handler
+
+  .weak TIM3_IRQHandler
+  .thumb_set TIM3_IRQHandler, Default_Handler
+
+  .weak TIM4_IRQHandler
+  .thumb_set TIM4_IRQHandler, Default_Handler
+
+  .weak I2C1_EV_IRQHandler
+  .thumb_set I2C1_EV_IRQHandler, Default_Handler
+
+  .weak I2C1_ER_IRQHandler
+  .thumb_set I2C1_ER_IRQHandler, Default_Handler
+
+  .weak I2C2_EV_IRQHandler
+  .thumb_set I2C2_EV_IRQHandler, Default_Handler
+
+  .weak I2C2_ER_IRQHandler
+  .thumb_set I2C2_ER_IRQHandler, Default_Handler
+
+  .weak SPI1_IRQHandler
+  .thumb_set SPI1_IRQHandler, Default_Handler
+
+  .weak SPI2_IRQHandler
+  .thumb_set SPI2_IRQHandler, Default_Handler
+
+  .weak USART1_IRQHandler
+  .thumb_set USART1_IRQHandler, Default_Handler
+
+  .weak USART2_IRQHandler
+  .thumb_set USART2_IRQHandler, Default_Handler
+
+  .weak USART3_IRQHandler
+  .thumb_set USART3_IRQHandler, Default_Handler
+
+  .weak EXTI15_10_IRQHandler
+  .thumb_set EXTI15_10_IRQHandler, Default_Handler
+
+  .weak RTC_Alarm_IRQHandler
+  .thumb_set RTC_Alarm_IRQHandler, Default_Handler
+
+  .weak TIM8_BRK_TIM12_IRQHandler
+  .thumb_set TIM8_BRK_TIM12_IRQHandler, Default_Handler
+
+  .weak TIM8_UP_TIM13_IRQHandler
+  .thumb_set TIM8_UP_TIM13_IRQHandler, Default_Handler
+
+  .weak TIM8_TRG_COM_TIM14_IRQHandler
+  .thumb_set TIM8_TRG_COM_TIM14_IRQHandler, Default_Handler
+
+  .weak TIM8_CC_IRQHandler
+  .thumb_set TIM8_CC_IRQHandler, Default_Handler
+
+  .weak DMA1_Stream7_IRQHandler
+  .thumb_set DMA1_Stream7_IRQHandler, Default_Handler
+
+  .weak FMC_IRQHandler
+  .thumb_set FMC_IRQHandler, Default_Handler
+
+  .weak SDMMC1_IRQHandler
+  .thumb_set SDMMC1_IRQHandler, Default_Handler
+
+  .weak TIM5_IRQHandler
+  .thumb_set TIM5_IRQHandler, Default_Handler
+
+  .weak SPI3_IRQHandler
+  .thumb_set SPI3_IRQHandler, Default_Handler
+
+  .weak UART4_IRQHandler
+  .thumb_set UART4_IRQHandler, Default_Handler
+
+  .weak UART5_IRQHandler
+  .thumb_set UART5_IRQHandler, Default_Handler
+
+  .weak TIM6_DAC_IRQHandler
+  .thumb_set TIM6_DAC_IRQHandler, Default_Handler
+
+  .weak TIM7_IRQHandler
+  .thumb_set TIM7_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream0_IRQHandler
+  .thumb_set DMA2_Stream0_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream1_IRQHandler
+  .thumb_set DMA2_Stream1_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream2_IRQHandler
+  .thumb_set DMA2_Stream2_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream3_IRQHandler
+  .thumb_set DMA2_Stream3_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream4_IRQHandler
+  .thumb_set DMA2_Stream4_IRQHandler, Default_Handler
+
+  .weak ETH_IRQHandler
+  .thumb_set ETH_IRQHandler, Default_Handler
+
+  .weak ETH_WKUP_IRQHandler
+  .thumb_set ETH_WKUP_IRQHandler, Default_Handler
+
+  .weak FDCAN_CAL_IRQHandler
+  .thumb_set FDCAN_CAL_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream5_IRQHandler
+  .thumb_set DMA2_Stream5_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream6_IRQHandler
+  .thumb_set DMA2_Stream6_IRQHandler, Default_Handler
+
+  .weak DMA2_Stream7_IRQHandler
+  .thumb_set DMA2_Stream7_IRQHandler, Default_Handler
+
+  .weak USART6_IRQHandler
+  .thumb_set USART6_IRQHandler, Default_Handler
+
+  .weak I2C3_EV_IRQHandler
+  .thumb_set I2C3_EV_IRQHandler, Default_Handler
+
+  .weak I2C3_ER_IRQHandler
+  .thumb_set I2C3_ER_IRQHandler, Default_Handler
+
+  .weak OTG_HS_EP1_OUT_IRQHandler
+  .thumb_set OTG_HS_EP1_OUT_IRQHandler, Default_Handler
+
+  .weak OTG_HS_EP1_IN_IRQHandler
+  .thumb_set OTG_HS_EP1_IN_IRQHandler, Default_Handler
+
+  .weak OTG_HS_WKUP_IRQHandler
+  .thumb_set OTG_HS_WKUP_IRQHandler, Default_Handler
+
+  .weak OTG_HS_IRQHandler
+  .thumb_set OTG_HS_IRQHandler, Default_Handler
+
+  .weak DCMI_IRQHandler
+  .thumb_set DCMI_IRQHandler, Default_Handler
+
+  .weak RNG_IRQHandler
+  .thumb_set RNG_IRQHandler, Default_Handler
+
+  .weak FPU_IRQHandler
+  .thumb_set FPU_IRQHandler, Default_Handler
+
+  .weak UART7_IRQHandler
+  .thumb_set UART7_IRQHandler, Default_Handler
+
+  .weak UART8_IRQHandler
+  .thumb_set UART8_IRQHandler, Default_Handler
+
+  .weak SPI4_IRQHandler
+  .thumb_set SPI4_IRQHandler, Default_Handler
+
+  .weak SPI5_IRQHandler
+  .thumb_set SPI5_IRQHandler, Default_Handler
+
+  .weak SPI6_IRQHandler
+  .thumb_set SPI6_IRQHandler, Default_Handler
+
+  .weak SAI1_IRQHandler
+  .thumb_set SAI1_IRQHandler, Default_Handler
+
+  .weak LTDC_IRQHandler
+  .thumb_set LTDC_IRQHandler, Default_Handler
+
+  .weak LTDC_ER_IRQHandler
+  .thumb_set LTDC_ER_IRQHandler, Default_Handler
+
+  .weak DMA2D_IRQHandler
+  .thumb_set DMA2D_IRQHandler, Default_Handler
+
+  .weak SAI2_IRQHandler
+  .thumb_set SAI2_IRQHandler, Default_Handler
+
+  .weak QUADSPI_IRQHandler
+  .thumb_set QUADSPI_IRQHandler, Default_Handler
+
+  .weak LPTIM1_IRQHandler
+  .thumb_set LPTIM1_IRQHandler, Default_Handler
+
+  .weak CEC_IRQHandler
+  .thumb_set CEC_IRQHandler, Default_Handler
+
+  .weak I2C4_EV_IRQHandler
+  .thumb_set I2C4_EV_IRQHandler, Default_Handler
+
+  .weak I2C4_ER_IRQHandler
+  .thumb_set I2C4_ER_IRQHandler, Default_Handler
+
+  .weak SPDIF_RX_IRQHandler
+  .thumb_set SPDIF_RX_IRQHandler, Default_Handler
+
+  .weak OTG_FS_EP1_OUT_IRQHandler
+  .thumb_set OTG_FS_EP1_OUT_IRQHandler, Default_Handler
+
+  .weak OTG_FS_EP1_IN_IRQHandler
+  .thumb_set OTG_FS_EP1_IN_IRQHandler, Default_Handler
+
+  .weak OTG_FS_WKUP_IRQHandler
+  .thumb_set OTG_FS_WKUP_IRQHandler, Default_Handler
+
+  .weak OTG_FS_IRQHandler
+  .thumb_set OTG_FS_IRQHandler, Default_Handler
+
+  .weak DMAMUX1_OVR_IRQHandler
+  .thumb_set DMAMUX1_OVR_IRQHandler, Default_Handler
+
+  .weak HRTIM1_Master_IRQHandler
+  .thumb_set HRTIM1_Master_IRQHandler, Default_Handler
+
+  .weak HRTIM1_TIMA_IRQHandler
+  .thumb_set HRTIM1_TIMA_IRQHandler, Default_Handler
+
+  .weak HRTIM1_TIMB_IRQHandler
+  .thumb_set HRTIM1_TIMB_IRQHandler, Default_Handler
+
+  .weak HRTIM1_TIMC_IRQHandler
+  .thumb_set HRTIM1_TIMC_IRQHandler, Default_Handler
+
+  .weak HRTIM1_TIMD_IRQHandler
+  .thumb_set HRTIM1_TIMD_IRQHandler, Default_Handler
+
+  .weak HRTIM1_TIME_IRQHandler
+  .thumb_set HRTIM1_TIME_IRQHandler, Default_Handler
+
+  .weak HRTIM1_FLT_IRQHandler
+  .thumb_set HRTIM1_FLT_IRQHandler, Default_Handler
+
+  .weak DFSDM1_FLT0_IRQHandler
+  .thumb_set DFSDM1_FLT0_IRQHandler, Default_Handler
+
+  .weak DFSDM1_FLT1_IRQHandler
+  .thumb_set DFSDM1_FLT1_IRQHandler, Default_Handler
+
+  .weak DFSDM1_FLT2_IRQHandler
+  .thumb_set DFSDM1_FLT2_IRQHandler, Default_Handler
+
+  .weak DFSDM1_FLT3_IRQHandler
+  .thumb_set DFSDM1_FLT3_IRQHandler, Default_Handler
+
+  .weak SAI3_IRQHandler
+  .thumb_set SAI3_IRQHandler, Default_Handler
+
+  .weak SWPMI1_IRQHandler
+  .thumb_set SWPMI1_IRQHandler, Default_Handler
+
+  .weak TIM15_IRQHandler
+  .thumb_set TIM15_IRQHandler, Default_Handler
+
+  .weak TIM16_IRQHandler
+  .thumb_set TIM16_IRQHandler, Default_Handler
+
+  .weak TIM17_IRQHandler
+  .thumb_set TIM17_IRQHandler, Default_Handler
+
+  .weak MDIOS_WKUP_IRQHandler
+  .thumb_set MDIOS_WKUP_IRQHandler, Default_Handler
+
+  .weak MDIOS_IRQHandler
+  .thumb_set MDIOS_IRQHandler, Default_Handler
+
+  .weak JPEG_IRQHandler
+  .thumb_set JPEG_IRQHandler, Default_Handler
+
+  .weak MDMA_IRQHandler
+  .thumb_set MDMA_IRQHandler, Default_Handler
+
+  .weak SDMMC2_IRQHandler
+  .thumb_set SDMMC2_IRQHandler, Default_Handler
+
+  .weak HSEM1_IRQHandler
+  .thumb_set HSEM1_IRQHandler, Default_Handler
+
+  .weak ADC3_IRQHandler
+  .thumb_set ADC3_IRQHandler, Default_Handler
+
+  .weak DMAMUX2_OVR_IRQHandler
+  .thumb_set DMAMUX2_OVR_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel0_IRQHandler
+  .thumb_set BDMA_Channel0_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel1_IRQHandler
+  .thumb_set BDMA_Channel1_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel2_IRQHandler
+  .thumb_set BDMA_Channel2_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel3_IRQHandler
+  .thumb_set BDMA_Channel3_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel4_IRQHandler
+  .thumb_set BDMA_Channel4_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel5_IRQHandler
+  .thumb_set BDMA_Channel5_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel6_IRQHandler
+  .thumb_set BDMA_Channel6_IRQHandler, Default_Handler
+
+  .weak BDMA_Channel7_IRQHandler
+  .thumb_set BDMA_Channel7_IRQHandler, Default_Handler
+
+  .weak COMP1_IRQHandler
+  .thumb_set COMP1_IRQHandler, Default_Handler
+
+  .weak LPTIM2_IRQHandler
+  .thumb_set LPTIM2_IRQHandler, Default_Handler
+
+  .weak LPTIM3_IRQHandler
+  .thumb_set LPTIM3_IRQHandler, Default_Handler
+
+  .weak LPTIM4_IRQHandler
+  .thumb_set LPTIM4_IRQHandler, Default_Handler
+
+  .weak LPTIM5_IRQHandler
+  .thumb_set LPTIM5_IRQHandler, Default_Handler
+
+  .weak LPUART1_IRQHandler
+  .thumb_set LPUART1_IRQHandler, Default_Handler
+
+  .weak CRS_IRQHandler
+  .thumb_set CRS_IRQHandler, Default_Handler
+
+  .weak ECC_IRQHandler
+  .thumb_set ECC_IRQHandler, Default_Handler
+
+  .weak SAI4_IRQHandler
+  .thumb_set SAI4_IRQHandler, Default_Handler
+
+  .weak WAKEUP_PIN_IRQHandler
+  .thumb_set WAKEUP_PIN_IRQHandler, Default_Handler
+
 .end
\ No newline at end of file
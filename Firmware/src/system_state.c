@@ -0,0 +1,88 @@
+/**
+ * Shared System State
+ * Sequence-counter seqlock over a single state block
+ */
+
+#include "system_state.h"
+#include "stm32h743xx.h"
+#include "stm32h7xx_hal.h"
+
+static SystemState_t system_state;
+static volatile uint32_t state_sequence = 0;
+static uint32_t write_primask = 0;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Set the initial state (before any reader runs)
+ */
+void SystemState_Init(const SystemState_t* initial)
+{
+    system_state = *initial;
+    state_sequence = 0;
+}
+
+/* ============================= */
+/* WRITERS                       */
+/* ============================= */
+
+/**
+ * @brief Start an update
+ * @return The live block - modify fields, then call SystemState_EndWrite()
+ */
+SystemState_t* SystemState_BeginWrite(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    write_primask = primask;
+    
+    state_sequence++;
+    __DMB();
+    
+    return &system_state;
+}
+
+/**
+ * @brief Publish an update
+ */
+void SystemState_EndWrite(void)
+{
+    __DMB();
+    state_sequence++;
+    
+    __set_PRIMASK(write_primask);
+}
+
+/* ============================= */
+/* READERS                       */
+/* ============================= */
+
+/**
+ * @brief Take a consistent copy of the state
+ */
+void SystemState_Read(SystemState_t* snapshot)
+{
+    uint32_t before;
+    uint32_t after;
+    
+    do
+    {
+        before = state_sequence;
+        __DMB();
+        *snapshot = system_state;
+        __DMB();
+        after = state_sequence;
+    } while ((before & 1U) || before != after);
+    
+    snapshot->sequence = before;
+}
+
+/**
+ * @brief Get the current version (changes on every published update)
+ */
+uint32_t SystemState_GetSequence(void)
+{
+    return state_sequence;
+}
@@ -0,0 +1,114 @@
+/**
+ * Learned MAX2871 VCO Band Table
+ * One CRC-protected record at FRAM_ADDR_VCO_TABLE
+ */
+
+#include "vco_cal.h"
+#include "crc.h"
+#include "fram.h"
+#include "hal_timer.h"
+#include "logger.h"
+#include "main.h"
+#include "max2871.h"
+
+#define VCO_TABLE_MAGIC 0x564F4331UL    /* "VCO1" */
+
+typedef struct {
+    uint32_t magic;
+    uint16_t points;
+    uint16_t crc;               /* Over band[] */
+    uint8_t band[MAX2871_VCO_TABLE_POINTS];
+} VcoTableRecord_t;
+
+/* DMA reads/writes the record in place; the driver reads band[] on every
+ * solve while the table is installed */
+static VcoTableRecord_t vco_record DMA_BUFFER;
+static VcoCal_Status_t vco_status;
+
+/* ============================= */
+/* INITIALIZATION                */
+/* ============================= */
+
+/**
+ * @brief Load the table from FRAM and install it if valid
+ */
+void VcoCal_Init(void)
+{
+    vco_status.valid = false;
+    vco_status.enabled = false;
+    
+    if (!FRAM_Read(FRAM_ADDR_VCO_TABLE, &vco_record, sizeof(vco_record)))
+        return;
+    
+    if (vco_record.magic != VCO_TABLE_MAGIC ||
+        vco_record.points != MAX2871_VCO_TABLE_POINTS ||
+        vco_record.crc != CRC16_Compute(vco_record.band, sizeof(vco_record.band)))
+    {
+        LOG_INFO("No VCO band table - using autoselect\n");
+        return;
+    }
+    
+    vco_status.valid = true;
+    vco_status.complete = true;
+    vco_status.points = vco_record.points;
+    VcoCal_SetEnabled(true);
+}
+
+/* ============================= */
+/* CHARACTERIZATION              */
+/* ============================= */
+
+/**
+ * @brief Measure the band table, save it to FRAM and install it
+ * A point that fails keeps its neighbour's band; the table is still used
+ * (a miss falls back to autoselect) but reported incomplete.
+ */
+bool VcoCal_Run(void)
+{
+    uint32_t start = Timer_GetMicros();
+    
+    /* Out of use while band[] is rewritten */
+    MAX2871_SetVcoTable(NULL);
+    vco_status.enabled = false;
+    vco_status.valid = false;
+    
+    bool complete = MAX2871_CalibrateVCO(vco_record.band);
+    
+    vco_record.magic = VCO_TABLE_MAGIC;
+    vco_record.points = MAX2871_VCO_TABLE_POINTS;
+    vco_record.crc = CRC16_Compute(vco_record.band, sizeof(vco_record.band));
+    
+    vco_status.cal_us = Timer_GetMicros() - start;
+    vco_status.complete = complete;
+    vco_status.points = MAX2871_VCO_TABLE_POINTS;
+    vco_status.valid = true;
+    VcoCal_SetEnabled(true);
+    
+    if (!FRAM_Write(FRAM_ADDR_VCO_TABLE, &vco_record, sizeof(vco_record)))
+        LOG_WARN("VCO band table not saved\n");
+    
+    LOG_INFO("VCO band table measured in %lu us%s\n", vco_status.cal_us,
+             LOG_S(complete ? "" : " (incomplete)"));
+    return complete;
+}
+
+/* ============================= */
+/* CONTROL / STATUS              */
+/* ============================= */
+
+/**
+ * @brief Use or bypass the table (no effect without a valid table)
+ */
+void VcoCal_SetEnabled(bool enable)
+{
+    vco_status.enabled = enable && vco_status.valid;
+    MAX2871_SetVcoTable(vco_status.enabled ? vco_record.band : NULL);
+}
+
+/**
+ * @brief Get table status
+ */
+VcoCal_Status_t VcoCal_GetStatus(void)
+{
+    return vco_status;
+}
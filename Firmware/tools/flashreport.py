@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Flash usage per object from the GNU ld map file, with the printf share.
+
+Usage:
+    flashreport.py build/firmware.map [baseline.map]
+
+Sums the .text, .rodata and .data (load image) input sections of every
+object file, library members included, and totals the newlib members
+behind printf. With a second map file (e.g. a build from before fmt.c
+and newlib-nano) the printf and overall totals are compared.
+"""
+
+import re
+import sys
+from collections import defaultdict
+
+FLASH_SECTIONS = (".text", ".rodata", ".data")
+
+# " .text.Fmt_U32\n                0x08001000       0x4c build/fmt.o"
+INPUT = re.compile(r"^\s(\.\S+)\s*(?:\n\s+)?0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)$",
+                   re.MULTILINE)
+OBJECT = re.compile(r"\.o\)?$")
+
+# newlib members that exist for printf's sake
+PRINTF = re.compile(r"(v?s?n?printf|vfi?printf|svfi?printf|_printf_|dtoa|mprec|"
+                    r"gdtoa|ldtoa|_vfprintf|nano-vfprintf|locale|wsetup|fvwrite)")
+
+
+def object_name(path):
+    member = re.search(r"\(([^)]+)\)$", path)
+    if member:
+        library = path[:member.start()].rsplit("/", 1)[-1]
+        return "%s(%s)" % (library, member.group(1))
+    return path.rsplit("/", 1)[-1]
+
+
+def section_kind(name):
+    for kind in FLASH_SECTIONS:
+        if name == kind or name.startswith(kind + "."):
+            return kind
+    return None
+
+
+def load(path):
+    with open(path) as f:
+        text = f.read()
+
+    start = text.find("Linker script and memory map")
+    if start >= 0:
+        text = text[start:]
+
+    usage = defaultdict(int)
+    for name, _addr, size, obj in INPUT.findall(text):
+        size = int(size, 16)
+        if section_kind(name) and size and OBJECT.search(obj):
+            usage[object_name(obj)] += size
+    return usage
+
+
+def printf_share(usage):
+    return sum(size for name, size in usage.items()
+               if "(" in name and PRINTF.search(name.split("(", 1)[1]))
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(__doc__.strip())
+        return 1
+
+    usage = load(sys.argv[1])
+
+    print("%-40s %10s" % ("object", "flash"))
+    for name, size in sorted(usage.items(), key=lambda kv: -kv[1])[:25]:
+        print("%-40s %10d" % (name, size))
+
+    total = sum(usage.values())
+    printf = printf_share(usage)
+    print("%-40s %10d" % ("printf (newlib)", printf))
+    print("%-40s %10d" % ("TOTAL", total))
+
+    if len(sys.argv) == 3:
+        baseline = load(sys.argv[2])
+        base_total = sum(baseline.values())
+        base_printf = printf_share(baseline)
+        print()
+        print("%-40s %10s %10s %10s" % ("", "baseline", "current", "saved"))
+        print("%-40s %10d %10d %10d" % ("printf (newlib)", base_printf, printf, base_printf - printf))
+        print("%-40s %10d %10d %10d" % ("TOTAL", base_total, total, base_total - total))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
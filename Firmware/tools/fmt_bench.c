@@ -0,0 +1,184 @@
+/**
+ * Host benchmark: fmt module against snprintf
+ *
+ * Build and run from Firmware/:
+ *     cc -O2 -Iinc tools/fmt_bench.c src/fmt.c -o fmt_bench && ./fmt_bench
+ *
+ * Formats the replies the command hot path sends most - SYS:STAT?,
+ * RF:FREQ? and a 64-bit frequency - both ways, checks the outputs match
+ * and reports ns per reply. Host numbers only show the ratio; on the
+ * target the gap is wider, since newlib's float conversion runs in
+ * software-emulated double division.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "fmt.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ROUNDS 2000000
+
+typedef struct {
+    double temperature;
+    double voltage;
+    double current;
+    uint32_t frequency_hz;
+    uint64_t frequency_mhz;
+} Bench_Sample_t;
+
+static volatile size_t bench_sink;
+
+static double Bench_Now(void)
+{
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/* Sample values change every round so nothing is hoisted out */
+static void Bench_Sample(uint32_t round, Bench_Sample_t* sample)
+{
+    sample->temperature = 20.0 + (round % 600) * 0.1;
+    sample->voltage = 4.8 + (round % 50) * 0.01;
+    sample->current = 0.25 + (round % 150) * 0.01;
+    sample->frequency_hz = 23437500U + round * 2999U;
+    sample->frequency_mhz = (uint64_t)sample->frequency_hz * 1000U + round % 1000;
+}
+
+/* ============================= */
+/* WORKLOADS                     */
+/* ============================= */
+
+static size_t Stat_Printf(const Bench_Sample_t* s, char* line, size_t size)
+{
+    return (size_t)snprintf(line, size, "TEMP:%.1f,VOLT:%.2f,CURR:%.2f\n",
+                            s->temperature, s->voltage, s->current);
+}
+
+static size_t Stat_Fmt(const Bench_Sample_t* s, char* line, size_t size)
+{
+    Fmt_Buffer_t out;
+    
+    Fmt_Init(&out, line, size);
+    Fmt_Str(&out, "TEMP:");
+    Fmt_Double(&out, s->temperature, 1);
+    Fmt_Str(&out, ",VOLT:");
+    Fmt_Double(&out, s->voltage, 2);
+    Fmt_Str(&out, ",CURR:");
+    Fmt_Double(&out, s->current, 2);
+    Fmt_Char(&out, '\n');
+    return out.length;
+}
+
+static size_t Freq_Printf(const Bench_Sample_t* s, char* line, size_t size)
+{
+    return (size_t)snprintf(line, size, "%" PRIu32 "\n", s->frequency_hz);
+}
+
+static size_t Freq_Fmt(const Bench_Sample_t* s, char* line, size_t size)
+{
+    Fmt_Buffer_t out;
+    
+    Fmt_Init(&out, line, size);
+    Fmt_U32(&out, s->frequency_hz);
+    Fmt_Char(&out, '\n');
+    return out.length;
+}
+
+static size_t Freq64_Printf(const Bench_Sample_t* s, char* line, size_t size)
+{
+    return (size_t)snprintf(line, size, "%" PRIu64 "\n", s->frequency_mhz);
+}
+
+static size_t Freq64_Fmt(const Bench_Sample_t* s, char* line, size_t size)
+{
+    Fmt_Buffer_t out;
+    
+    Fmt_Init(&out, line, size);
+    Fmt_U64(&out, s->frequency_mhz);
+    Fmt_Char(&out, '\n');
+    return out.length;
+}
+
+typedef size_t (*Bench_Format_t)(const Bench_Sample_t* s, char* line, size_t size);
+
+typedef struct {
+    const char* name;
+    Bench_Format_t reference;
+    Bench_Format_t fmt;
+} Bench_Case_t;
+
+static const Bench_Case_t bench_cases[] = {
+    { "SYS:STAT?", Stat_Printf, Stat_Fmt },
+    { "RF:FREQ?", Freq_Printf, Freq_Fmt },
+    { "FREQ mHz (64-bit)", Freq64_Printf, Freq64_Fmt },
+};
+
+/* ============================= */
+/* MAIN                          */
+/* ============================= */
+
+static double Bench_Run(Bench_Format_t format)
+{
+    Bench_Sample_t sample;
+    char line[64];
+    size_t total = 0;
+    double start = Bench_Now();
+    
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        Bench_Sample(round, &sample);
+        total += format(&sample, line, sizeof(line));
+    }
+    
+    bench_sink = total;
+    return (Bench_Now() - start) / BENCH_ROUNDS;
+}
+
+/**
+ * @brief Outputs must match; ties that printf rounds to even may differ
+ * in the last digit, so a small number of mismatches is reported, not fatal
+ */
+static uint32_t Bench_Check(const Bench_Case_t* c)
+{
+    Bench_Sample_t sample;
+    char expected[64];
+    char actual[64];
+    uint32_t mismatches = 0;
+    
+    for (uint32_t round = 0; round < 100000; round++)
+    {
+        Bench_Sample(round, &sample);
+        size_t length = c->fmt(&sample, actual, sizeof(actual));
+        
+        c->reference(&sample, expected, sizeof(expected));
+        if (length != strlen(expected) || memcmp(actual, expected, length) != 0)
+        {
+            if (mismatches == 0)
+                printf("  first mismatch: %.*s vs %s", (int)length, actual, expected);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int main(void)
+{
+    printf("%-20s %12s %12s %9s %11s\n", "reply", "snprintf ns", "fmt ns", "speedup", "mismatches");
+    
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+    {
+        const Bench_Case_t* c = &bench_cases[i];
+        uint32_t mismatches = Bench_Check(c);
+        double reference_ns = Bench_Run(c->reference);
+        double fmt_ns = Bench_Run(c->fmt);
+        
+        printf("%-20s %12.1f %12.1f %8.1fx %11u\n", c->name, reference_ns, fmt_ns,
+               reference_ns / fmt_ns, mismatches);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Host decoder for the firmware's binary log stream (LOG:MODE BIN).
+
+Usage:
+    logdecode.py build/firmware.logstr capture.bin
+    logdecode.py build/firmware.logstr /dev/ttyUSB0 [baud]
+
+firmware.logstr is the .logstr section extracted at build time; a record's
+ID is the offset of its format string in that section.
+"""
+
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+HEADER = struct.Struct("<IHBB")     # timestamp_us, id, level, nargs
+LEVELS = ("E", "W", "I", "D")
+SPEC = re.compile(r"%[-+ #0-9.]*[lhz]*([diouxXcsfFeEgG%])")
+
+
+def load_table(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def format_string(table, offset):
+    end = table.find(b"\0", offset)
+    return table[offset:end].decode("utf-8", "replace")
+
+
+def render(fmt, args):
+    out = []
+    pos = 0
+    index = 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group(1)
+        if conv == "%":
+            out.append("%")
+            continue
+        word = args[index] if index < len(args) else 0
+        index += 1
+        spec = re.sub(r"[lhz]", "", m.group(0))
+        if conv in "di":
+            value = struct.unpack("<i", struct.pack("<I", word))[0]
+        elif conv in "fFeEgG":
+            value = struct.unpack("<f", struct.pack("<I", word))[0]
+        elif conv == "s":
+            spec, value = "%s", "<0x%08X>" % word
+        elif conv == "c":
+            value = chr(word & 0xFF)
+        else:
+            value = word
+        out.append(spec % value)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(table, stream):
+    while True:
+        sync = stream.read(1)
+        if not sync:
+            return
+        if sync[0] != FRAME_SYNC:
+            continue
+        header = stream.read(HEADER.size)
+        if len(header) < HEADER.size:
+            return
+        timestamp, ident, level, nargs = HEADER.unpack(header)
+        if nargs > 4:
+            continue
+        args = struct.unpack("<%dI" % nargs, stream.read(4 * nargs))
+        text = render(format_string(table, ident), args)
+        level = LEVELS[level] if level < len(LEVELS) else "?"
+        sys.stdout.write("%12.6f %s %s" % (timestamp / 1e6, level, text))
+        if not text.endswith("\n"):
+            sys.stdout.write("\n")
+        sys.stdout.flush()
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    table = load_table(sys.argv[1])
+    source = sys.argv[2]
+    if source.startswith("/dev/") or source.upper().startswith("COM"):
+        import serial  # pyserial
+        baud = int(sys.argv[3]) if len(sys.argv) > 3 else 115200
+        with serial.Serial(source, baud) as port:
+            decode(table, port)
+    else:
+        with open(source, "rb") as f:
+            decode(table, f)
+
+
+if __name__ == "__main__":
+    main()
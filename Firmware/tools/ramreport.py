@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+RAM usage per subsystem from the GNU ld map file.
+
+Usage:
+    ramreport.py build/firmware.map
+
+Sums the .data, .bss, .dma_buffer and .list_buffer input sections of every object file
+(one object per subsystem). The firmware has no RTOS heap, so these
+totals plus the fixed .stack/.heap reservations are the whole RAM budget.
+"""
+
+import re
+import sys
+from collections import defaultdict
+
+RAM_SECTIONS = (".data", ".bss", ".dma_buffer", ".list_buffer", "COMMON")
+RESERVED = (".stack", ".heap")
+
+# " .bss.monitor_task_stack\n                0x20001000      0x800 build/main.o"
+INPUT = re.compile(r"^\s(\.\S+|COMMON)\s*(?:\n\s+)?0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)$",
+                   re.MULTILINE)
+OBJECT = re.compile(r"\.o\)?$")
+OUTPUT = re.compile(r"^(\.\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)", re.MULTILINE)
+
+
+def subsystem(path):
+    name = path.rsplit("/", 1)[-1]
+    name = re.sub(r"\.(c|s)?\.?o(bj)?\)?$", "", name)
+    return name.split("(")[-1] or path
+
+
+def section_kind(name):
+    for kind in RAM_SECTIONS:
+        if name == kind or name.startswith(kind + "."):
+            return kind
+    return None
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__.strip())
+        return 1
+
+    with open(sys.argv[1]) as f:
+        text = f.read()
+
+    # Only the memory map, not the discarded sections list
+    start = text.find("Linker script and memory map")
+    if start >= 0:
+        text = text[start:]
+
+    usage = defaultdict(lambda: defaultdict(int))
+    for name, _addr, size, obj in INPUT.findall(text):
+        kind = section_kind(name)
+        size = int(size, 16)
+        if kind and size and OBJECT.search(obj):
+            usage[subsystem(obj)][kind] += size
+
+    columns = (".data", ".bss", ".dma_buffer", ".list_buffer")
+    print("%-24s %10s %10s %12s %12s %10s" % (("subsystem",) + columns + ("total",)))
+    grand = 0
+    for name, kinds in sorted(usage.items(), key=lambda kv: -sum(kv[1].values())):
+        bss = kinds[".bss"] + kinds["COMMON"]
+        total = kinds[".data"] + bss + kinds[".dma_buffer"] + kinds[".list_buffer"]
+        grand += total
+        print("%-24s %10d %10d %12d %12d %10d" % (name, kinds[".data"], bss,
+                                                  kinds[".dma_buffer"],
+                                                  kinds[".list_buffer"], total))
+
+    for name, _addr, size in OUTPUT.findall(text):
+        if name in RESERVED:
+            grand += int(size, 16)
+            print("%-24s %10s %10s %12s %12s %10d" % (name, "", "", "", "", int(size, 16)))
+
+    print("%-24s %10s %10s %12s %12s %10d" % ("TOTAL", "", "", "", "", grand))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
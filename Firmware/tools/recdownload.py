@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+Download the telemetry recorder (REC:DATA?) and write it as CSV.
+
+Usage:
+    recdownload.py /dev/ttyUSB0 [baud] > capture.csv
+
+Columns: sample number, device time (us), then one column per recorded
+channel (raw ADC codes, lock as 0/1). The trigger sample is marked.
+"""
+
+import struct
+import sys
+
+import serial  # pyserial
+
+BLOCK_HEADER = struct.Struct("<IIHH")   # first_sample, timestamp_us, samples, length
+CHANNELS = ("temp", "volt", "curr", "lock")
+
+
+def command(port, text):
+    port.write((text + "\n").encode())
+    return port.readline().decode().strip()
+
+
+def fields(reply):
+    return dict(item.split(":", 1) for item in reply.split(","))
+
+
+def read_chunk(port, first):
+    """One IEEE 488.2 definite-length block: #<digits><length><data>\\n"""
+    port.write(("REC:DATA? %d\n" % first).encode())
+    lead = port.read(2)
+    if lead[:1] != b"#":
+        raise IOError((lead + port.readline()).decode(errors="replace").strip())
+    length = int(port.read(int(lead[1:2])))
+    data = port.read(length)
+    port.readline()
+    return data
+
+
+def varints(data):
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            yield (value >> 1) ^ -(value & 1)
+            value = shift = 0
+
+
+def decode(data, channels, rate_hz):
+    pos = 0
+    while pos < len(data):
+        first, timestamp, samples, length = BLOCK_HEADER.unpack_from(data, pos)
+        pos += BLOCK_HEADER.size
+        deltas = varints(data[pos:pos + length])
+        pos += length
+        last = [0] * len(channels)
+        for n in range(samples):
+            for i in range(len(channels)):
+                last[i] += next(deltas)
+            yield first + n, timestamp + n * 1000000 // rate_hz, list(last)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    baud = int(sys.argv[2]) if len(sys.argv) > 2 else 115200
+
+    with serial.Serial(sys.argv[1], baud, timeout=2) as port:
+        conf = fields(command(port, "REC:CONF?"))
+        status = fields(command(port, "REC:STAT?"))
+        mask = int(conf["CHAN"])
+        channels = [name for bit, name in enumerate(CHANNELS) if mask & (1 << bit)]
+
+        data = b""
+        block = 0
+        while block < int(status["BLOCKS"]):
+            chunk = read_chunk(port, block)
+            if not chunk:
+                break
+            data += chunk
+            block += count_blocks(chunk)
+
+    trigger = int(status["TRIG_SAMPLE"]) if status["STATE"] == "DONE" else -1
+    print(",".join(["sample", "time_us"] + channels + ["trigger"]))
+    for sample, timestamp, values in decode(data, channels, int(conf["RATE"])):
+        if sample < int(status["FIRST"]):
+            continue
+        print(",".join(str(v) for v in [sample, timestamp] + values +
+                       [1 if sample == trigger else 0]))
+
+
+def count_blocks(chunk):
+    count = pos = 0
+    while pos < len(chunk):
+        pos += BLOCK_HEADER.size + BLOCK_HEADER.unpack_from(chunk, pos)[3]
+        count += 1
+    return count
+
+
+if __name__ == "__main__":
+    main()